@@ -7,6 +7,8 @@
 
 #include "Engine/Input/InputSystem.hpp"
 
+#include "Engine/Profiling/Memory.hpp"
+
 #include <algorithm>
 
 AudioSystem::AudioSystem(std::size_t max_channels /*= 1024*/)
@@ -59,6 +61,7 @@ AudioSystem::~AudioSystem() {
 }
 
 void AudioSystem::Initialize() {
+    MEMORY_TAG_SCOPE(Audio);
 #ifdef AUDIO_DEBUG
     XAUDIO2_DEBUG_CONFIGURATION config{};
     config.LogFileline = true;
@@ -119,6 +122,7 @@ void AudioSystem::Render() const {
 }
 
 void AudioSystem::EndFrame() {
+    MEMORY_TAG_SCOPE(Audio);
     std::scoped_lock<std::mutex> _lock(_cs);
     _idle_channels.erase(std::remove_if(std::begin(_idle_channels), std::end(_idle_channels), [](const std::unique_ptr<Channel>& c) { return c == nullptr; }), std::end(_idle_channels));
 }
@@ -144,6 +148,7 @@ void AudioSystem::RegisterWavFilesFromFolder(const std::string& folderpath, bool
 }
 
 void AudioSystem::RegisterWavFilesFromFolder(const std::filesystem::path& folderpath, bool recursive /*= false*/) {
+    MEMORY_TAG_SCOPE(Audio);
     namespace FS = std::filesystem;
     bool is_folder = FS::is_directory(folderpath);
     if(!is_folder) {
@@ -157,6 +162,7 @@ void AudioSystem::RegisterWavFilesFromFolder(const std::filesystem::path& folder
 }
 
 void AudioSystem::DeactivateChannel(Channel& channel) {
+    MEMORY_TAG_SCOPE(Audio);
     std::scoped_lock<std::mutex> _lock(_cs);
     auto found_iter = std::find_if(std::begin(_active_channels), std::end(_active_channels),
                                    [&channel](const std::unique_ptr<Channel>& c) { return c.get() == &channel; });
@@ -165,6 +171,7 @@ void AudioSystem::DeactivateChannel(Channel& channel) {
 }
 
 void AudioSystem::Play(Sound& snd) {
+    MEMORY_TAG_SCOPE(Audio);
     std::scoped_lock<std::mutex> _lock(_cs);
     if(_max_channels <= _idle_channels.size()) {
         return;
@@ -203,6 +210,7 @@ void AudioSystem::RegisterWavFile(const std::string& filepath) {
 }
 
 void AudioSystem::RegisterWavFile(const std::filesystem::path& filepath) {
+    MEMORY_TAG_SCOPE(Audio);
     auto found_iter = _wave_files.find(filepath.string());
     if(found_iter != _wave_files.end()) {
         return;
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <bitset>
+#include <cmath>
 #include <sstream>
 
 namespace FileUtils::Base64 {
@@ -12,8 +13,7 @@ std::string Encode(const std::string& input) {
 }
 
 std::string Encode(const std::vector<unsigned char>& input) {
-    std::stringstream ss;
-    ss.setf(std::ios_base::binary | std::ios_base::in);
+    std::stringstream ss(std::ios_base::binary | std::ios_base::in | std::ios_base::out);
     ss.write(reinterpret_cast<const char*>(input.data()), input.size());
     return detail::Encode(ss, input.size());
 }
@@ -101,8 +101,7 @@ std::string Decode(std::istream& input) {
 }
 
 void Decode(const std::string& input, std::vector<unsigned char>& output) {
-    std::stringstream ss;
-    ss.setf(std::ios_base::binary | std::ios_base::in);
+    std::stringstream ss(std::ios_base::binary | std::ios_base::in | std::ios_base::out);
     ss.write(reinterpret_cast<const char*>(input.data()), input.size());
     std::string out = detail::Decode(ss, input.size());
     output.assign(std::begin(out), std::end(out));
@@ -5,6 +5,14 @@
 #define TRACK_MEMORY_BASIC (0)
 #define TRACK_MEMORY_VERBOSE (1)
 
+//Where the TRACK_MEMORY operator new overrides get their memory.
+//TLSF is one allocator behind one lock that every thread shares; prefer malloc when many threads allocate heavily.
+#define MEMORY_BACKEND_MALLOC (0)
+#define MEMORY_BACKEND_TLSF (1)
+#ifndef MEMORY_BACKEND
+    #define MEMORY_BACKEND MEMORY_BACKEND_MALLOC
+#endif
+
 #define UNUSED(x) (void)(x)
 
 #ifdef _DEBUG
@@ -47,6 +55,10 @@
         #define MAX_PROFILE_HISTORY 0xFFu
         #define MAX_PROFILE_TREES 50u
     #endif
+#elif defined(__linux__)
+    #ifndef PLATFORM_LINUX
+        #define PLATFORM_LINUX
+    #endif
 #endif
 
 #endif
\ No newline at end of file
@@ -7,8 +7,12 @@
 
 #include "Engine/Math/Vector2.hpp"
 
+#include "Engine/Memory/MemoryPool.hpp"
+
 #include <functional>
+#include <list>
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -118,7 +122,8 @@ private:
     Camera2D* _camera = nullptr;
     std::map<std::string, Console::Command> _commands{};
     std::vector<std::string> _entryline_buffer{};
-    std::vector<OutputEntry> _output_buffer{};
+    FixedBlockPool _output_pool{ FixedBlockPool::GetNodeSize<std::pmr::list<OutputEntry>>(), alignof(std::max_align_t), 512u, true };
+    std::pmr::list<OutputEntry> _output_buffer{ &_output_pool };
     std::string _entryline{};
     std::string::const_iterator _cursor_position{};
     std::string::const_iterator _selection_position{};
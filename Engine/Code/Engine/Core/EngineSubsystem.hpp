@@ -111,8 +111,8 @@ struct EngineMessage64 {
     WindowsSystemMessage wmMessageCode;
     unsigned int nativeMessage;
     void* hWnd;
-    unsigned __int64 wparam;
-    __int64 lparam;
+    std::uint64_t wparam;
+    std::int64_t lparam;
 };
 struct EngineMessage32 {
     WindowsSystemMessage wmMessageCode;
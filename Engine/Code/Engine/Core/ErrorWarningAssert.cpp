@@ -10,13 +10,34 @@
 #endif
 
 //-----------------------------------------------------------------------------------------------
+#include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
 #include <stdarg.h>
 
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <filesystem>
 
+namespace {
+
+void ShowSystemCursor() {
+#if defined( PLATFORM_WINDOWS )
+    ShowCursor(TRUE);
+#endif
+}
+
+void BreakIntoDebugger() {
+#if defined( PLATFORM_WINDOWS )
+    __debugbreak();
+#else
+    std::abort();
+#endif
+}
+
+} //End anonymous namespace
+
 
 
 
@@ -49,7 +70,7 @@ void DebuggerPrintf(const char* messageFormat, ...) {
     char messageLiteral[MESSAGE_MAX_LENGTH];
     va_list variableArgumentList;
     va_start(variableArgumentList, messageFormat);
-    vsnprintf_s(messageLiteral, MESSAGE_MAX_LENGTH, _TRUNCATE, messageFormat, variableArgumentList);
+    std::vsnprintf(messageLiteral, MESSAGE_MAX_LENGTH, messageFormat, variableArgumentList);
     va_end(variableArgumentList);
     messageLiteral[MESSAGE_MAX_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -86,6 +107,10 @@ void SystemDialogue_Okay(const std::string& messageTitle, const std::string& mes
         MessageBoxA(NULL, messageText.c_str(), messageTitle.c_str(), MB_OK | dialogueIconTypeFlag | MB_TOPMOST);
         ShowCursor(FALSE);
     }
+#else
+    UNUSED(messageTitle);
+    UNUSED(messageText);
+    UNUSED(severity);
 #endif
 }
 
@@ -104,6 +129,10 @@ bool SystemDialogue_OkayCancel(const std::string& messageTitle, const std::strin
         isAnswerOkay = (buttonClicked == IDOK);
         ShowCursor(FALSE);
     }
+#else
+    UNUSED(messageTitle);
+    UNUSED(messageText);
+    UNUSED(severity);
 #endif
 
     return isAnswerOkay;
@@ -124,6 +153,10 @@ bool SystemDialogue_YesNo(const std::string& messageTitle, const std::string& me
         isAnswerYes = (buttonClicked == IDYES);
         ShowCursor(FALSE);
     }
+#else
+    UNUSED(messageTitle);
+    UNUSED(messageText);
+    UNUSED(severity);
 #endif
 
     return isAnswerYes;
@@ -144,6 +177,10 @@ int SystemDialogue_YesNoCancel(const std::string& messageTitle, const std::strin
         answerCode = (buttonClicked == IDYES ? 1 : (buttonClicked == IDNO ? 0 : -1));
         ShowCursor(FALSE);
     }
+#else
+    UNUSED(messageTitle);
+    UNUSED(messageText);
+    UNUSED(severity);
 #endif
 
     return answerCode;
@@ -151,7 +188,7 @@ int SystemDialogue_YesNoCancel(const std::string& messageTitle, const std::strin
 
 
 //-----------------------------------------------------------------------------------------------
-__declspec(noreturn) void FatalError(const char* filePath, const char* functionName, int lineNum, const std::string& reasonForError, const char* conditionText) {
+[[noreturn]] void FatalError(const char* filePath, const char* functionName, int lineNum, const std::string& reasonForError, const char* conditionText) {
     std::string errorMessage = reasonForError;
     if(reasonForError.empty()) {
         if(conditionText)
@@ -165,7 +202,7 @@ __declspec(noreturn) void FatalError(const char* filePath, const char* functionN
     std::string fullMessageTitle = appName + " :: Error";
     std::string fullMessageText = errorMessage;
     fullMessageText += "\n\nThe application will now close.\n";
-    bool isDebuggerPresent = (IsDebuggerPresent() == TRUE);
+    bool isDebuggerPresent = IsDebuggerAvailable();
     if(isDebuggerPresent) {
         fullMessageText += "\nDEBUGGER DETECTED!\nWould you like to break and debug?\n  (Yes=debug, No=quit)\n";
     }
@@ -188,13 +225,13 @@ __declspec(noreturn) void FatalError(const char* filePath, const char* functionN
 
     if(isDebuggerPresent) {
         bool isAnswerYes = SystemDialogue_YesNo(fullMessageTitle, fullMessageText, SEVERITY_FATAL);
-        ShowCursor(TRUE);
+        ShowSystemCursor();
         if(isAnswerYes) {
-            __debugbreak();
+            BreakIntoDebugger();
         }
     } else {
         SystemDialogue_Okay(fullMessageTitle, fullMessageText, SEVERITY_FATAL);
-        ShowCursor(TRUE);
+        ShowSystemCursor();
     }
     exit(0);
 }
@@ -215,7 +252,7 @@ void RecoverableWarning(const char* filePath, const char* functionName, int line
     std::string fullMessageTitle = appName + " :: Warning";
     std::string fullMessageText = errorMessage;
 
-    bool isDebuggerPresent = (IsDebuggerPresent() == TRUE);
+    bool isDebuggerPresent = IsDebuggerAvailable();
     if(isDebuggerPresent) {
         fullMessageText += "\n\nDEBUGGER DETECTED!\nWould you like to continue running?\n  (Yes=continue, No=quit, Cancel=debug)\n";
     } else {
@@ -240,17 +277,17 @@ void RecoverableWarning(const char* filePath, const char* functionName, int line
 
     if(isDebuggerPresent) {
         int answerCode = SystemDialogue_YesNoCancel(fullMessageTitle, fullMessageText, SEVERITY_WARNING);
-        ShowCursor(TRUE);
+        ShowSystemCursor();
         if(answerCode == 0) // "NO"
         {
             exit(0);
         } else if(answerCode == -1) // "CANCEL"
         {
-            __debugbreak();
+            BreakIntoDebugger();
         }
     } else {
         bool isAnswerYes = SystemDialogue_YesNo(fullMessageTitle, fullMessageText, SEVERITY_WARNING);
-        ShowCursor(TRUE);
+        ShowSystemCursor();
         if(!isAnswerYes) {
             exit(0);
         }
@@ -8,13 +8,17 @@
 #include "Engine/Core/TimeUtils.hpp"
 #include "Engine/Core/Win.hpp"
 
+#include "Engine/Profiling/AllocationProfiler.hpp"
 #include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
 #include <cstdio>
 #include <cstdarg>
 #include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 
 FileLogger::FileLogger(JobSystem& jobSystem, const std::string& logName) {
     Initialize(jobSystem, logName);
@@ -26,18 +30,27 @@ FileLogger::~FileLogger() {
 }
 
 void FileLogger::Log_worker() {
+    MEMORY_TAG_SCOPE(Logging);
+    Profiler::SetThreadName("FileLogger");
     JobConsumer jc;
     jc.AddCategory(JobType::Logging);
     _job_system->SetCategorySignal(JobType::Logging, &_signal);
 
+    std::string str{};
     while(IsRunning()) {
         std::unique_lock<std::mutex> lock(_cs);
+        _worker_waiting = true;
+        //Pairs with the fence in Log so a push is either seen here or the writer sees us waiting.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
         //Condition to wake up: not running or queue has jobs.
         _signal.wait(lock, [this]()->bool { return !_is_running || !_queue.empty(); });
-        if(!_queue.empty()) {
-            auto str = _queue.front();
-            _queue.pop();
+        _worker_waiting = false;
+        bool wrote = false;
+        while(_queue.try_pop(str)) {
             _stream << str;
+            wrote = true;
+        }
+        if(wrote) {
             RequestFlush();
             jc.ConsumeAll();
         }
@@ -46,6 +59,7 @@ void FileLogger::Log_worker() {
 
 void FileLogger::RequestFlush() {
     if(_requesting_flush) {
+        PROFILE_LOG_SCOPE("FileLogger::Flush");
         _stream.flush();
         _requesting_flush = false;
     }
@@ -77,13 +91,13 @@ void FileLogger::DoCopyLog() {
         to_p.make_preferred();
         job_data->to = to_p;
         job_data->from = from_p;
-        _job_system->Run(JobType::Generic, [this](void* user_data) { this->CopyLog(user_data); }, job_data);
+        _job_system->Run(JobType::Generic, [this](void* user_data) { this->CopyLog(user_data); }, job_data, JobPriority::Low);
     }
 }
 
 void FileLogger::CopyLog(void* user_data) {
+    std::unique_ptr<copy_log_job_t> job_data(reinterpret_cast<copy_log_job_t*>(user_data));
     if(IsRunning()) {
-        auto job_data = reinterpret_cast<copy_log_job_t*>(user_data);
         auto from = job_data->from;
         auto to = job_data->to;
         std::scoped_lock<std::mutex> _lock(_cs);
@@ -142,6 +156,7 @@ void FileLogger::Initialize(JobSystem& jobSystem, const std::string& log_name) {
     _old_cout = std::cout.rdbuf(_stream.rdbuf());
     _worker = std::thread(&FileLogger::Log_worker, this);
     ::SetThreadDescription(_worker.native_handle(), L"FileLogger");
+    _job_system->PinThread(_worker, ReservedCore::Logging);
     std::ostringstream ss;
     ss << "Initializing Logger: " << _current_log_path << "...";
     LogLine(ss.str().c_str());
@@ -152,6 +167,10 @@ void FileLogger::Shutdown() {
         {
             std::ostringstream ss;
             ss << Memory::status();
+            ss << Memory::tag_report();
+            if(AllocationProfiler::IsEnabled()) {
+                ss << AllocationProfiler::GetReport(AllocationProfiler::SortKey::LeakedBytes, 10u);
+            }
             ss << "Shutting down Logger: " << _current_log_path << "...";
             LogLine(ss.str().c_str());
         }
@@ -166,14 +185,17 @@ void FileLogger::Shutdown() {
 }
 
 void FileLogger::Log(const std::string& msg) {
-    {
-        std::scoped_lock<std::mutex> _lock(_cs);
-        _queue.push(msg);
+    MEMORY_TAG_SCOPE(Logging);
+    _queue.push(msg);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_worker_waiting) {
+        { std::scoped_lock<std::mutex> _lock(_cs); }
+        _signal.notify_one();
     }
-    _signal.notify_all();
 }
 
 void FileLogger::LogLine(const std::string& msg) {
+    MEMORY_TAG_SCOPE(Logging);
     Log(msg + '\n');
 }
 
@@ -200,6 +222,7 @@ void FileLogger::LogError(const std::string& msg) {
 }
 
 void FileLogger::LogTag(const std::string& tag, const std::string& msg) {
+    MEMORY_TAG_SCOPE(Logging);
 
     std::stringstream ss;
     InsertTimeStamp(ss);
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/OverflowQueue.hpp"
 
 #include <atomic>
 #include <condition_variable>
@@ -51,14 +51,18 @@ private:
     void DoCopyLog();
     void CopyLog(void* user_data);
     void FinalizeLog();
+
+    static constexpr std::size_t LOG_QUEUE_CAPACITY = 4096u;
+
     mutable std::mutex _cs{};
     std::ofstream _stream{};
     std::string _current_log_path{};
     decltype(std::cout.rdbuf()) _old_cout{};
     std::thread _worker{};
     std::condition_variable _signal{};
-    ThreadSafeQueue<std::string> _queue;
+    OverflowQueue<std::string> _queue{ LOG_QUEUE_CAPACITY };
     JobSystem* _job_system = nullptr;
     std::atomic_bool _is_running = false;
     std::atomic_bool _requesting_flush = false;
+    std::atomic_bool _worker_waiting = false;
 };
\ No newline at end of file
@@ -1,13 +1,18 @@
 #include "Engine/Core/FileUtils.hpp"
 
+#include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobFuture.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <fstream>
+
+#ifdef PLATFORM_WINDOWS
 #include <ShlObj.h>
+#endif
 
 
 namespace FileUtils {
@@ -68,6 +73,17 @@ bool ReadBufferFromFile(std::vector<unsigned char>& out_buffer, const std::strin
     return true;
 }
 
+JobFuture<std::optional<std::vector<unsigned char>>> ReadFileAsync(JobSystem& jobSystem, const std::string& filePath) {
+    return jobSystem.Async(JobType::Io, [filePath]() {
+        std::optional<std::vector<unsigned char>> result{};
+        std::vector<unsigned char> buffer{};
+        if(ReadBufferFromFile(buffer, filePath)) {
+            result = std::move(buffer);
+        }
+        return result;
+    });
+}
+
 bool ReadBufferFromFile(std::string& out_buffer, const std::string& filePath) {
 
     namespace FS = std::filesystem;
@@ -100,6 +116,7 @@ bool CreateFolders(const std::string& filepath) {
 std::filesystem::path GetAppDataPath() {
     namespace FS = std::filesystem;
     FS::path p{};
+#ifdef PLATFORM_WINDOWS
     {
         PWSTR ppszPath = nullptr;
         bool success = SUCCEEDED(::SHGetKnownFolderPath(FOLDERID_RoamingAppData, KF_FLAG_DEFAULT, nullptr, &ppszPath));
@@ -109,18 +126,31 @@ std::filesystem::path GetAppDataPath() {
             p.make_preferred();
         }
     }
+#else
+    //The XDG user data folder, Linux's closest match for roaming AppData.
+    if(const char* data_home = std::getenv("XDG_DATA_HOME"); data_home && *data_home) {
+        p = FS::path(data_home);
+    } else if(const char* home = std::getenv("HOME"); home && *home) {
+        p = FS::path(home) / ".local" / "share";
+    }
+#endif
     return p;
 }
 
 std::filesystem::path GetExePath() {
     namespace FS = std::filesystem;
     FS::path result{};
+#ifdef PLATFORM_WINDOWS
     {
         TCHAR filename[MAX_PATH];
         ::GetModuleFileName(nullptr, filename, MAX_PATH);
         result = FS::path(filename);
         result.make_preferred();
     }
+#else
+    std::error_code ec{};
+    result = FS::read_symlink("/proc/self/exe", ec);
+#endif
     return result;
 }
 
@@ -158,7 +188,7 @@ std::vector<std::filesystem::path> GetAllPathsInFolders(const std::filesystem::p
     return paths;
 }
 
-void FileUtils::RemoveExceptMostRecentFiles(const std::filesystem::path& folderpath, int mostRecentCountToKeep, const std::string& validExtensionList /*= std::string{}*/) {
+void RemoveExceptMostRecentFiles(const std::filesystem::path& folderpath, int mostRecentCountToKeep, const std::string& validExtensionList /*= std::string{}*/) {
     auto working_dir = std::filesystem::current_path();
     auto working_dir_string = StringUtils::ToLowerCase(std::filesystem::absolute(working_dir).string());
     auto folderpath_string = StringUtils::ToLowerCase(std::filesystem::absolute(folderpath).string());
@@ -182,15 +212,27 @@ void FileUtils::RemoveExceptMostRecentFiles(const std::filesystem::path& folderp
 
 
 uint16_t EndianSwap(uint16_t value) {
+#ifdef PLATFORM_WINDOWS
     return _byteswap_ushort(value);
+#else
+    return __builtin_bswap16(value);
+#endif
 }
 
 uint32_t EndianSwap(uint32_t value) {
+#ifdef PLATFORM_WINDOWS
     return _byteswap_ulong(value);
+#else
+    return __builtin_bswap32(value);
+#endif
 }
 
 uint64_t EndianSwap(uint64_t value) {
+#ifdef PLATFORM_WINDOWS
     return _byteswap_uint64(value);
+#else
+    return __builtin_bswap64(value);
+#endif
 }
 
 } //End FileUtils
\ No newline at end of file
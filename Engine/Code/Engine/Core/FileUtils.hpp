@@ -1,18 +1,27 @@
 #pragma once
 
+#include "Engine/Core/StringUtils.hpp"
+
 #include <cstdlib>
 #include <filesystem>
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 #include <type_traits>
 
+class JobSystem;
+template<typename T>
+class JobFuture;
+
 namespace FileUtils {
 
 bool WriteBufferToFile(void* buffer, std::size_t size, const std::string& filePath);
 bool WriteBufferToFile(const std::string& buffer, const std::string& filePath);
 bool ReadBufferFromFile(std::vector<unsigned char>& out_buffer, const std::string& filePath);
 bool ReadBufferFromFile(std::string& out_buffer, const std::string& filePath);
+//Reads on the Io job thread; empty if the file could not be read. Include JobFuture.hpp to use the result.
+JobFuture<std::optional<std::vector<unsigned char>>> ReadFileAsync(JobSystem& jobSystem, const std::string& filePath);
 bool CreateFolders(const std::string& filepath);
 std::filesystem::path GetAppDataPath();
 std::filesystem::path GetExePath();
@@ -0,0 +1,202 @@
+#pragma once
+//Type-erased, move-only callable with small-buffer storage.
+//Callables that fit in Capacity bytes are stored inline and never touch the heap;
+//larger ones fall back to a single heap allocation.
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, std::size_t Capacity = 64>
+class InlineFunction;
+
+template<typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() noexcept = default;
+    InlineFunction(std::nullptr_t) noexcept;
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction>>>
+    InlineFunction(F&& f);
+    InlineFunction(InlineFunction&& other) noexcept;
+    InlineFunction& operator=(InlineFunction&& other) noexcept;
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InlineFunction>>>
+    InlineFunction& operator=(F&& f);
+    InlineFunction& operator=(std::nullptr_t) noexcept;
+    ~InlineFunction();
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    R operator()(Args... args) const;
+    explicit operator bool() const noexcept;
+
+    void reset() noexcept;
+    bool is_inline() const noexcept;
+
+protected:
+private:
+    struct Ops {
+        R(*invoke)(void* storage, Args&&... args);
+        void(*move)(void* dst, void* src) noexcept;
+        void(*destroy)(void* storage) noexcept;
+        bool is_inline;
+    };
+
+    template<typename F>
+    static constexpr bool fits_inline = sizeof(F) <= Capacity
+                                        && alignof(F) <= alignof(std::max_align_t)
+                                        && std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    static R InvokeInline(void* storage, Args&&... args);
+    template<typename F>
+    static void MoveInline(void* dst, void* src) noexcept;
+    template<typename F>
+    static void DestroyInline(void* storage) noexcept;
+
+    template<typename F>
+    static R InvokeHeap(void* storage, Args&&... args);
+    template<typename F>
+    static void MoveHeap(void* dst, void* src) noexcept;
+    template<typename F>
+    static void DestroyHeap(void* storage) noexcept;
+
+    template<typename F>
+    static constexpr Ops inline_ops{ &InvokeInline<F>, &MoveInline<F>, &DestroyInline<F>, true };
+    template<typename F>
+    static constexpr Ops heap_ops{ &InvokeHeap<F>, &MoveHeap<F>, &DestroyHeap<F>, false };
+
+    template<typename F>
+    void assign(F&& f);
+
+    alignas(std::max_align_t) mutable unsigned char _storage[Capacity];
+    const Ops* _ops = nullptr;
+};
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>::InlineFunction(std::nullptr_t) noexcept {
+    /* DO NOTHING */
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F, typename>
+InlineFunction<R(Args...), Capacity>::InlineFunction(F&& f) {
+    assign(std::forward<F>(f));
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>::InlineFunction(InlineFunction&& other) noexcept {
+    if(other._ops) {
+        other._ops->move(_storage, other._storage);
+        _ops = other._ops;
+        other._ops = nullptr;
+    }
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>& InlineFunction<R(Args...), Capacity>::operator=(InlineFunction&& other) noexcept {
+    if(this == &other) {
+        return *this;
+    }
+    reset();
+    if(other._ops) {
+        other._ops->move(_storage, other._storage);
+        _ops = other._ops;
+        other._ops = nullptr;
+    }
+    return *this;
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F, typename>
+InlineFunction<R(Args...), Capacity>& InlineFunction<R(Args...), Capacity>::operator=(F&& f) {
+    reset();
+    assign(std::forward<F>(f));
+    return *this;
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>& InlineFunction<R(Args...), Capacity>::operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>::~InlineFunction() {
+    reset();
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+R InlineFunction<R(Args...), Capacity>::operator()(Args... args) const {
+    return _ops->invoke(_storage, std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+InlineFunction<R(Args...), Capacity>::operator bool() const noexcept {
+    return _ops != nullptr;
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+void InlineFunction<R(Args...), Capacity>::reset() noexcept {
+    if(_ops) {
+        _ops->destroy(_storage);
+        _ops = nullptr;
+    }
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+bool InlineFunction<R(Args...), Capacity>::is_inline() const noexcept {
+    return _ops && _ops->is_inline;
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+void InlineFunction<R(Args...), Capacity>::assign(F&& f) {
+    using callable_t = std::decay_t<F>;
+    if constexpr(fits_inline<callable_t>) {
+        ::new(static_cast<void*>(_storage)) callable_t(std::forward<F>(f));
+        _ops = &inline_ops<callable_t>;
+    } else {
+        ::new(static_cast<void*>(_storage)) callable_t*(new callable_t(std::forward<F>(f)));
+        _ops = &heap_ops<callable_t>;
+    }
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+R InlineFunction<R(Args...), Capacity>::InvokeInline(void* storage, Args&&... args) {
+    return (*std::launder(reinterpret_cast<F*>(storage)))(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+void InlineFunction<R(Args...), Capacity>::MoveInline(void* dst, void* src) noexcept {
+    auto src_f = std::launder(reinterpret_cast<F*>(src));
+    ::new(dst) F(std::move(*src_f));
+    src_f->~F();
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+void InlineFunction<R(Args...), Capacity>::DestroyInline(void* storage) noexcept {
+    std::launder(reinterpret_cast<F*>(storage))->~F();
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+R InlineFunction<R(Args...), Capacity>::InvokeHeap(void* storage, Args&&... args) {
+    return (**std::launder(reinterpret_cast<F**>(storage)))(std::forward<Args>(args)...);
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+void InlineFunction<R(Args...), Capacity>::MoveHeap(void* dst, void* src) noexcept {
+    ::new(dst) F*(*std::launder(reinterpret_cast<F**>(src)));
+}
+
+template<typename R, typename... Args, std::size_t Capacity>
+template<typename F>
+void InlineFunction<R(Args...), Capacity>::DestroyHeap(void* storage) noexcept {
+    delete *std::launder(reinterpret_cast<F**>(storage));
+}
@@ -0,0 +1,152 @@
+#pragma once
+//Result of a job that can be waited on, chained with Then, or co_await-ed.
+//The await_* members are templated on the coroutine handle so this header stays C++17;
+//any compiler with coroutine support (/await or C++20) picks them up.
+
+#include "Engine/Core/JobSystem.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template<typename T>
+class JobFuture {
+public:
+    static_assert(!std::is_void_v<T>, "JobFuture requires a value type. Return a bool from jobs without a result.");
+    using value_type = T;
+
+    JobFuture() = default;
+    explicit JobFuture(JobSystem& jobSystem);
+
+    bool IsValid() const;
+    bool IsReady() const;
+    //Runs other generic jobs while waiting.
+    T& Get();
+    void SetValue(T value);
+
+    //Dispatches fn(T&) on category once the value is ready.
+    template<typename F>
+    auto Then(F&& fn, const JobType& category = JobType::Generic, const JobPriority& priority = JobPriority::Normal) -> JobFuture<std::invoke_result_t<F, T&>>;
+
+    bool await_ready() const;
+    //The coroutine resumes on a generic worker, never on the thread that produced the value.
+    template<typename CoroutineHandle>
+    void await_suspend(CoroutineHandle handle);
+    //Moves the value out of the shared state.
+    T await_resume();
+
+protected:
+private:
+    struct State {
+        JobSystem* job_system = nullptr;
+        std::optional<T> value{};
+        std::atomic_bool is_ready{ false };
+        std::mutex cs{};
+        std::vector<std::function<void()>> continuations{};
+    };
+
+    void OnReady(std::function<void()> continuation);
+
+    std::shared_ptr<State> _state{};
+    template<typename U>
+    friend class JobFuture;
+};
+
+template<typename T>
+JobFuture<T>::JobFuture(JobSystem& jobSystem)
+    : _state(std::make_shared<State>())
+{
+    _state->job_system = &jobSystem;
+}
+
+template<typename T>
+bool JobFuture<T>::IsValid() const {
+    return _state != nullptr;
+}
+
+template<typename T>
+bool JobFuture<T>::IsReady() const {
+    return _state && _state->is_ready;
+}
+
+template<typename T>
+T& JobFuture<T>::Get() {
+    while(!_state->is_ready) {
+        if(!_state->job_system->HelpExecute()) {
+            std::this_thread::yield();
+        }
+    }
+    return *_state->value;
+}
+
+template<typename T>
+void JobFuture<T>::SetValue(T value) {
+    decltype(_state->continuations) continuations{};
+    {
+        std::scoped_lock<std::mutex> lock(_state->cs);
+        _state->value.emplace(std::move(value));
+        _state->is_ready = true;
+        continuations.swap(_state->continuations);
+    }
+    for(auto& continuation : continuations) {
+        continuation();
+    }
+}
+
+template<typename T>
+void JobFuture<T>::OnReady(std::function<void()> continuation) {
+    {
+        std::scoped_lock<std::mutex> lock(_state->cs);
+        if(!_state->is_ready) {
+            _state->continuations.push_back(std::move(continuation));
+            return;
+        }
+    }
+    continuation();
+}
+
+template<typename T>
+template<typename F>
+auto JobFuture<T>::Then(F&& fn, const JobType& category /*= JobType::Generic*/, const JobPriority& priority /*= JobPriority::Normal*/) -> JobFuture<std::invoke_result_t<F, T&>> {
+    using result_t = std::invoke_result_t<F, T&>;
+    JobFuture<result_t> next(*_state->job_system);
+    OnReady([state = _state, next, fn = std::forward<F>(fn), category, priority]() mutable {
+        state->job_system->Run(category, [state, next, fn = std::move(fn)](void*) mutable {
+            next.SetValue(fn(*state->value));
+        }, nullptr, priority);
+    });
+    return next;
+}
+
+template<typename T>
+bool JobFuture<T>::await_ready() const {
+    return IsReady();
+}
+
+template<typename T>
+template<typename CoroutineHandle>
+void JobFuture<T>::await_suspend(CoroutineHandle handle) {
+    OnReady([job_system = _state->job_system, handle]() {
+        job_system->Run(JobType::Generic, [handle](void*) mutable { handle.resume(); }, nullptr);
+    });
+}
+
+template<typename T>
+T JobFuture<T>::await_resume() {
+    return std::move(*_state->value);
+}
+
+template<typename F>
+auto JobSystem::Async(const JobType& category, F&& fn, const JobPriority& priority /*= JobPriority::Normal*/) -> JobFuture<std::invoke_result_t<F>> {
+    JobFuture<std::invoke_result_t<F>> future(*this);
+    Run(category, [future, fn = std::forward<F>(fn)](void*) mutable {
+        future.SetValue(fn());
+    }, nullptr, priority);
+    return future;
+}
@@ -1,29 +1,271 @@
 #include "Engine/Core/JobSystem.hpp"
 
+#include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/TimeUtils.hpp"
+
+#ifdef PLATFORM_WINDOWS
 #include "Engine/Core/Win.hpp"
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "Engine/Memory/MemoryPool.hpp"
+
+#include "Engine/Profiling/JobInstrumentation.hpp"
+#include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 
+#include "Engine/System/Cpu.hpp"
+
+#include <algorithm>
 #include <chrono>
+#include <new>
 #include <sstream>
+#include <string>
 
-std::vector<ThreadSafeQueue<Job*>*> JobSystem::_queues = std::vector<ThreadSafeQueue<Job*>*>{};
+std::vector<PriorityJobQueue*> JobSystem::_queues = std::vector<PriorityJobQueue*>{};
+std::vector<PriorityWorkStealingQueue*> JobSystem::_local_queues = std::vector<PriorityWorkStealingQueue*>{};
+std::vector<JobSystem::WorkerSlot*> JobSystem::_worker_slots = std::vector<JobSystem::WorkerSlot*>{};
 std::vector<std::condition_variable*> JobSystem::_signals = std::vector<std::condition_variable*>{};
 std::vector<std::thread> JobSystem::_threads = std::vector<std::thread>{};
+thread_local std::size_t JobSystem::_worker_index = JobSystem::NOT_A_WORKER;
+
+namespace {
+
+//Jobs are recycled through per-thread caches of the job pool so the dispatch path never reaches malloc.
+//Threads that free more jobs than they create (workers) hand whole batches back to the
+//pool that allocating threads (usually main) refill from.
+constexpr std::size_t JOBS_PER_PAGE = 256u;
 
-void JobSystem::GenericJobWorker(std::condition_variable* signal) {
+FixedBlockPool& GetJobPool() {
+    //Never destroyed: a JobSystem owned by another static may free its jobs during static destruction.
+    static auto* pool = new FixedBlockPool{ sizeof(Job), alignof(Job), JOBS_PER_PAGE, true };
+    return *pool;
+}
+
+} //End anonymous namespace
+
+void JobSystem::GenericJobWorker(std::size_t worker_index) {
+    MEMORY_TAG_SCOPE(Jobs);
+    Profiler::SetThreadName(("Generic Job Thread " + std::to_string(worker_index)).c_str());
+    _worker_index = worker_index;
+    std::minstd_rand rng(static_cast<unsigned int>(worker_index + 1));
+    std::size_t picks = 0u;
+    std::size_t spin_count = MIN_SPIN_COUNT;
+    while(IsRunning()) {
+        Job* job = nullptr;
+        if(TryGetGenericJob(worker_index, rng, picks, job)) {
+            Execute(job);
+            continue;
+        }
+        //Spin longer while spinning keeps paying off, shorter when it ends in a park anyway.
+        if(SpinForGenericJob(spin_count)) {
+            spin_count = (std::min)(spin_count * 2u, MAX_SPIN_COUNT);
+            continue;
+        }
+        spin_count = (std::max)(spin_count / 2u, MIN_SPIN_COUNT);
+        ParkGenericWorker(worker_index);
+    }
+    _worker_index = NOT_A_WORKER;
+}
+
+void JobSystem::IoJobWorker() {
+    MEMORY_TAG_SCOPE(Jobs);
+    Profiler::SetThreadName("Io Job Thread");
     JobConsumer jc;
-    jc.AddCategory(JobType::Generic);
-    this->SetCategorySignal(JobType::Generic, signal);
+    jc.AddCategory(JobType::Io);
     while(IsRunning()) {
-        if(signal) {
-            std::unique_lock<std::mutex> lock(_cs);
-            //Condition to wake up: Not running or has jobs available
-            signal->wait(lock, [&jc, this]()->bool { return !_is_running || jc.HasJobs(); });
-            if(jc.HasJobs()) {
-                jc.ConsumeAll();
+        if(!jc.ConsumeAll()) {
+            //Dispatch unparks after every push, so a job queued after ConsumeAll leaves a token.
+            _io_parker.Park();
+        }
+    }
+}
+
+bool JobSystem::SpinForGenericJob(std::size_t spin_count) const {
+    for(std::size_t i = 0; i < spin_count; ++i) {
+        if(_generic_pending.load(std::memory_order_relaxed) != 0 || !_is_running.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        _mm_pause();
+    }
+    return false;
+}
+
+void JobSystem::ParkGenericWorker(std::size_t worker_index) {
+    auto& slot = *_worker_slots[worker_index];
+    if(!slot.is_listed.exchange(true)) {
+        _idle_workers.push(worker_index);
+    }
+    ++_sleeping_workers;
+    //Pairs with Dispatch incrementing _generic_pending before reading _sleeping_workers:
+    //either this sees the new job or Dispatch sees this worker and unparks it.
+    if(_is_running && _generic_pending == 0) {
+        slot.parker.Park();
+    } else {
+        //Found work instead of parking: the list entry is stale and WakeGenericWorker skips it.
+        slot.is_listed = false;
+    }
+    --_sleeping_workers;
+}
+
+bool JobSystem::TryGetGenericJob(std::size_t worker_index, std::minstd_rand& rng, std::size_t& picks, Job*& job) {
+    //Per priority level: own deque first (LIFO, cache-warm), then the shared injection queue, then steal (FIFO) from a random victim.
+    //Threads that are not generic workers (helping callers) skip straight to the shared queue.
+    auto generic_queue = _queues[static_cast<std::underlying_type_t<JobType>>(JobType::Generic)];
+    const auto worker_count = _local_queues.size();
+    const auto first_victim = static_cast<std::size_t>(rng()) % worker_count;
+    constexpr auto levels = static_cast<std::size_t>(JobPriority::Max);
+    for(std::size_t step = 0; step < levels; ++step) {
+        const auto priority = ScanPriority(picks, step);
+        bool found = (worker_index < worker_count && _local_queues[worker_index]->pop(job, priority))
+                     || generic_queue->try_pop(job, priority);
+        for(std::size_t i = 0; !found && i < worker_count; ++i) {
+            auto victim = (first_victim + i) % worker_count;
+            if(victim == worker_index) {
+                continue;
             }
+            found = _local_queues[victim]->steal(job, priority);
+        }
+        if(found) {
+            --_generic_pending;
+            ++picks;
+            return true;
         }
     }
+    return false;
+}
+
+JobPriority JobSystem::ScanPriority(std::size_t pick, std::size_t step) {
+    //Normally scan High to Low. Every STARVATION_INTERVAL-th pick the scan starts at a lower
+    //level instead (alternating Normal and Low), so background work keeps moving under a
+    //sustained flood of urgent jobs.
+    constexpr auto levels = static_cast<std::size_t>(JobPriority::Max);
+    std::size_t start = 0u;
+    if(pick % STARVATION_INTERVAL == STARVATION_INTERVAL - 1u) {
+        start = 1u + (pick / STARVATION_INTERVAL) % (levels - 1u);
+    }
+    return static_cast<JobPriority>((start + step) % levels);
+}
+
+bool JobSystem::HelpExecute() {
+    if(_local_queues.empty()) {
+        return false;
+    }
+    thread_local std::minstd_rand helper_rng{ std::random_device{}() };
+    thread_local std::size_t helper_picks = 0u;
+    Job* job = nullptr;
+    if(!TryGetGenericJob(_worker_index, helper_rng, helper_picks, job)) {
+        return false;
+    }
+    Execute(job);
+    return true;
+}
+
+void JobSystem::HelpUntilZero(const std::atomic<std::size_t>& counter) {
+    while(counter != 0) {
+        if(!HelpExecute()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WakeGenericWorker() {
+    if(!_sleeping_workers) {
+        return;
+    }
+    //Pop until one parked worker is woken. Entries left by workers that found work instead of
+    //parking are skipped. A listed worker that has not blocked yet still gets a token, so it
+    //rescans rather than blocking, but it may be about to run a job instead, so keep looking:
+    //at worst one extra worker wakes up, and a parked worker is never passed over.
+    std::size_t worker_index = 0u;
+    while(_idle_workers.try_pop(worker_index)) {
+        auto& slot = *_worker_slots[worker_index];
+        if(!slot.is_listed.exchange(false)) {
+            continue;
+        }
+        if(slot.parker.Unpark()) {
+            slot.wakeups.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void JobSystem::Execute(Job* job) {
+#ifdef PROFILE_BUILD
+    const auto submit_ticks = job->submit_ticks;
+    const auto start_ticks = submit_ticks ? JobInstrumentation::Now() : std::uint64_t{ 0u };
+#endif
+    job->work_cb(job->user_data);
+#ifdef PROFILE_BUILD
+    if(submit_ticks) {
+        JobInstrumentation::RecordJob(job->type, job->queue_depth, _worker_index, submit_ticks, start_ticks, JobInstrumentation::Now());
+    }
+#endif
+    job->OnFinish();
+    job->state = JobState::Finished;
+    //Drop the reference taken by Dispatch; the submitter may still hold its own.
+    if(--job->num_dependencies == 0) {
+        FreeJob(job);
+    }
+}
+
+Job* JobSystem::AllocateJob(const JobType& category, void* user_data, const JobPriority& priority) {
+    auto j = ::new(GetJobPool().Allocate()) Job(*this);
+    j->type = category;
+    j->priority = priority;
+    j->state = JobState::Created;
+    j->user_data = user_data;
+    j->num_dependencies = 1;
+    return j;
+}
+
+void JobSystem::FreeJob(Job* job) {
+    job->~Job();
+    GetJobPool().Deallocate(job);
+}
+
+PriorityJobQueue::PriorityJobQueue(std::size_t capacityPerPriority) {
+    for(auto& queue : _queues) {
+        queue = std::make_unique<OverflowQueue<Job*>>(capacityPerPriority);
+    }
+}
+
+void PriorityJobQueue::push(Job* job) {
+    _queues[static_cast<std::size_t>(job->priority)]->push(job);
+}
+
+bool PriorityJobQueue::try_pop(Job*& job, const JobPriority& priority) {
+    return _queues[static_cast<std::size_t>(priority)]->try_pop(job);
+}
+
+bool PriorityJobQueue::empty() const {
+    return std::all_of(std::begin(_queues), std::end(_queues), [](const auto& queue) { return queue->empty(); });
+}
+
+std::size_t PriorityJobQueue::size() const {
+    std::size_t total = 0u;
+    for(const auto& queue : _queues) {
+        total += queue->size();
+    }
+    return total;
+}
+
+void PriorityWorkStealingQueue::push(Job* job) {
+    _deques[static_cast<std::size_t>(job->priority)].push(job);
+}
+
+bool PriorityWorkStealingQueue::pop(Job*& job, const JobPriority& priority) {
+    return _deques[static_cast<std::size_t>(priority)].pop(job);
+}
+
+bool PriorityWorkStealingQueue::steal(Job*& job, const JobPriority& priority) {
+    return _deques[static_cast<std::size_t>(priority)].steal(job);
+}
+
+bool PriorityWorkStealingQueue::empty() const {
+    return std::all_of(std::begin(_deques), std::end(_deques), [](const auto& deque) { return deque.empty(); });
 }
 
 void JobConsumer::AddCategory(const JobType& category) {
@@ -41,22 +283,23 @@ bool JobConsumer::ConsumeJob() {
     if(_consumables.empty()) {
         return false;
     }
-    for(auto& consumable : _consumables) {
-        if(!consumable) {
-            continue;
-        }
-        auto& queue = *consumable;
-        if(queue.empty()) {
-            return false;
+    //Most urgent job across every category first; categories only break ties.
+    constexpr auto levels = static_cast<std::size_t>(JobPriority::Max);
+    for(std::size_t step = 0; step < levels; ++step) {
+        const auto priority = JobSystem::ScanPriority(_picks, step);
+        for(auto& consumable : _consumables) {
+            if(!consumable) {
+                continue;
+            }
+            Job* job = nullptr;
+            if(consumable->try_pop(job, priority)) {
+                ++_picks;
+                JobSystem::Execute(job);
+                return true;
+            }
         }
-        auto job = queue.front();
-        queue.pop();
-        job->work_cb(job->user_data);
-        job->OnFinish();
-        job->state = JobState::Finished;
-        delete job;
     }
-    return true;
+    return false;
 }
 
 unsigned int JobConsumer::ConsumeAll() {
@@ -89,59 +332,127 @@ bool JobConsumer::HasJobs() const {
 }
 
 JobSystem::JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal)
-: _main_job_signal(mainJobSignal)
+: JobSystem(JobSystemDesc{ 0 < genericCount ? genericCount : genericCount - 1, categoryCount, mainJobSignal, 0u, true, false })
+{
+    /* DO NOTHING */
+}
+
+JobSystem::JobSystem(const JobSystemDesc& desc)
+: _main_job_signal(desc.main_job_signal)
 {
-    Initialize(genericCount, categoryCount);
+    Initialize(desc);
 }
 
 JobSystem::~JobSystem() {
     Shutdown();
 }
 
-void JobSystem::Initialize(int genericCount, std::size_t categoryCount) {
-    auto core_count = static_cast<int>(std::thread::hardware_concurrency());
-    if(genericCount <= 0) {
-        core_count += genericCount;
-    }
-    --core_count;
+void JobSystem::Initialize(const JobSystemDesc& desc) {
+    AssignCores(desc);
+    _pin_threads = desc.pin_threads;
+    const auto slot_count = static_cast<int>(_worker_processors.size());
+    auto core_count = 0 < desc.generic_count ? desc.generic_count : (std::max)(slot_count + desc.generic_count, 0);
+    const auto categoryCount = desc.category_count;
     _queues.resize(categoryCount);
+    _local_queues.resize(core_count);
+    _worker_slots.resize(core_count);
     _signals.resize(categoryCount);
     _threads.resize(core_count);
     _is_running = true;
 
     for(std::size_t i = 0; i < categoryCount; ++i) {
-        _queues[i] = new ThreadSafeQueue<Job*>{};
+        _queues[i] = new PriorityJobQueue{ JOB_QUEUE_CAPACITY };
+    }
+
+    for(std::size_t i = 0; i < static_cast<std::size_t>(core_count); ++i) {
+        _local_queues[i] = new PriorityWorkStealingQueue{};
+        _worker_slots[i] = new WorkerSlot{};
     }
 
     for(std::size_t i = 0; i < categoryCount; ++i) {
         _signals[i] = nullptr;
     }
-    _signals[static_cast<std::underlying_type_t<JobType>>(JobType::Generic)] = new std::condition_variable;
-    
+
     for(std::size_t i = 0; i < static_cast<std::size_t>(core_count); ++i) {
-        auto t = std::thread(&JobSystem::GenericJobWorker, this, _signals[static_cast<std::underlying_type_t<JobType>>(JobType::Generic)]);
+        auto t = std::thread(&JobSystem::GenericJobWorker, this, i);
+#ifdef PLATFORM_WINDOWS
         std::wostringstream wss;
         wss << "Generic Job Thread " << i;
         ::SetThreadDescription(t.native_handle(), wss.str().c_str());
+#endif
+        //More workers than slots share the slots round-robin.
+        if(_pin_threads && !_worker_processors.empty()) {
+            System::Cpu::SetThreadAffinity(t.native_handle(), _worker_processors[i % _worker_processors.size()]);
+        }
         _threads[i] = std::move(t);
     }
 
+    if(static_cast<std::underlying_type_t<JobType>>(JobType::Io) < categoryCount) {
+        auto t = std::thread(&JobSystem::IoJobWorker, this);
+#ifdef PLATFORM_WINDOWS
+        ::SetThreadDescription(t.native_handle(), L"Io Job Thread");
+#endif
+        _threads.push_back(std::move(t));
+    }
+
+}
+
+void JobSystem::AssignCores(const JobSystemDesc& desc) {
+    auto cores = System::Cpu::GetCpuDesc().cores;
+    if(cores.empty()) {
+        //Topology unavailable: treat every logical processor as a core of its own.
+        const auto logical_count = (std::max)(std::thread::hardware_concurrency(), 1u);
+        for(unsigned int i = 0; i < logical_count; ++i) {
+            System::Cpu::CoreDesc core{};
+            core.logicalProcessors.push_back(static_cast<int>(i));
+            cores.push_back(core);
+        }
+    }
+    //Reserve from the front, but always leave at least one core for the workers.
+    const auto reserved_count = (std::min)((std::min)(desc.reserved_core_count, static_cast<std::size_t>(ReservedCore::Max)), cores.size() - 1u);
+    _reserved_processors.assign(static_cast<std::size_t>(ReservedCore::Max), std::vector<int>{});
+    for(std::size_t i = 0; i < reserved_count; ++i) {
+        _reserved_processors[i] = cores[i].logicalProcessors;
+    }
+    _worker_processors.clear();
+    for(auto core = std::begin(cores) + reserved_count; core != std::end(cores); ++core) {
+        if(desc.use_smt) {
+            for(auto processor : core->logicalProcessors) {
+                _worker_processors.push_back(std::vector<int>{ processor });
+            }
+        } else {
+            _worker_processors.push_back(core->logicalProcessors);
+        }
+    }
 }
 
 void JobSystem::BeginFrame() {
     MainStep();
+#ifdef PROFILE_BUILD
+    //Drain the timing rings once a frame so they rarely fill up.
+    if(JobInstrumentation::IsEnabled()) {
+        JobInstrumentation::Collect();
+    }
+#endif
 }
 
 void JobSystem::Shutdown() {
     if(!IsRunning()) {
         return;
     }
-    _is_running = false;
+    {
+        std::scoped_lock<std::mutex> lock(_cs);
+        _is_running = false;
+    }
     for(auto& signal : _signals) {
         if(signal) {
             signal->notify_all();
         }
     }
+    for(auto& slot : _worker_slots) {
+        slot->parker.Unpark();
+    }
+    _io_parker.Unpark();
 
     for(auto& thread : _threads) {
         if(thread.joinable()) {
@@ -153,6 +464,14 @@ void JobSystem::Shutdown() {
         delete queue;
         queue = nullptr;
     }
+    for(auto& queue : _local_queues) {
+        delete queue;
+        queue = nullptr;
+    }
+    for(auto& slot : _worker_slots) {
+        delete slot;
+        slot = nullptr;
+    }
     for(auto& signal : _signals) {
         delete signal;
         signal = nullptr;
@@ -162,6 +481,12 @@ void JobSystem::Shutdown() {
     _queues.clear();
     _queues.shrink_to_fit();
 
+    _local_queues.clear();
+    _local_queues.shrink_to_fit();
+
+    _worker_slots.clear();
+    _worker_slots.shrink_to_fit();
+
     _signals.clear();
     _signals.shrink_to_fit();
 
@@ -181,27 +506,36 @@ void JobSystem::SetCategorySignal(const JobType& category_id, std::condition_var
     _signals[static_cast<std::underlying_type_t<JobType>>(category_id)] = signal;
 }
 
-Job* JobSystem::Create(const JobType& category, const std::function<void(void*)>& cb, void* user_data) {
-    auto j = new Job(*this);
-    j->type = category;
-    j->state = JobState::Created;
-    j->work_cb = cb;
-    j->user_data = user_data;
-    j->num_dependencies = 1;
-    return std::move(j);
-}
-
-void JobSystem::Run(const JobType& category, const std::function<void(void*)>& cb, void* user_data) {
-    Job* job = Create(category, cb, user_data);
-    job->state = JobState::Running;
-    DispatchAndRelease(job);
-}
-
 void JobSystem::Dispatch(Job* job) {
+    //A category beyond category_count has no queue and no thread to drain it (e.g. Io when
+    //category_count <= Io); run it as a generic job rather than never.
+    if(_queues.size() <= static_cast<std::size_t>(job->type)) {
+        job->type = JobType::Generic;
+    }
     job->state = JobState::Dispatched;
     ++job->num_dependencies;
     auto jobtype = static_cast<std::underlying_type_t<JobType>>(job->type);
+#ifdef PROFILE_BUILD
+    if(JobInstrumentation::ShouldRecord()) {
+        job->queue_depth = job->type == JobType::Generic ? _generic_pending.load(std::memory_order_relaxed) : _queues[jobtype]->size();
+        job->submit_ticks = JobInstrumentation::Now();
+    }
+#endif
+    if(job->type == JobType::Generic && !_local_queues.empty()) {
+        ++_generic_pending;
+        //Jobs spawned from inside a generic job stay on that worker's deque.
+        if(_worker_index < _local_queues.size()) {
+            _local_queues[_worker_index]->push(job);
+        } else {
+            _queues[jobtype]->push(job);
+        }
+        WakeGenericWorker();
+        return;
+    }
     _queues[jobtype]->push(job);
+    if(job->type == JobType::Io) {
+        _io_parker.Unpark();
+    }
     auto signal = _signals[jobtype];
     if(signal) {
         signal->notify_all();
@@ -213,13 +547,15 @@ bool JobSystem::Release(Job* job) {
     if(dcount != 0) {
         return false;
     }
-    delete job;
+    FreeJob(job);
     return true;
 }
 
 void JobSystem::Wait(Job* job) {
     while(job->state != JobState::Finished) {
-        std::this_thread::yield();
+        if(!HelpExecute()) {
+            std::this_thread::yield();
+        }
     }
 }
 
@@ -246,6 +582,35 @@ std::condition_variable* JobSystem::GetMainJobSignal() const {
     return _main_job_signal;
 }
 
+JobSystem::ParkingStats JobSystem::GetParkingStats() const {
+    ParkingStats stats{};
+    for(const auto& slot : _worker_slots) {
+        stats.parks += slot->parker.GetBlockCount();
+        stats.wakeups += slot->wakeups.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+std::size_t JobSystem::GetGenericWorkerCount() const {
+    return _local_queues.size();
+}
+
+bool JobSystem::PinThread(std::thread& thread, const ReservedCore& core) const {
+    const auto index = static_cast<std::underlying_type_t<ReservedCore>>(core);
+    if(!_pin_threads || _reserved_processors.size() <= index || _reserved_processors[index].empty()) {
+        return false;
+    }
+    return System::Cpu::SetThreadAffinity(thread.native_handle(), _reserved_processors[index]);
+}
+
+bool JobSystem::PinCurrentThread(const ReservedCore& core) const {
+    const auto index = static_cast<std::underlying_type_t<ReservedCore>>(core);
+    if(!_pin_threads || _reserved_processors.size() <= index || _reserved_processors[index].empty()) {
+        return false;
+    }
+    return System::Cpu::SetCurrentThreadAffinity(_reserved_processors[index]);
+}
+
 Job::Job(JobSystem& jobSystem)
     : _job_system(&jobSystem)
 {
@@ -253,7 +618,13 @@ Job::Job(JobSystem& jobSystem)
 }
 
 Job::~Job() {
-    delete user_data;
+    auto chunk = _dependents_overflow;
+    while(chunk) {
+        auto next = chunk->next;
+        delete chunk;
+        chunk = next;
+    }
+    _dependents_overflow = nullptr;
 }
 
 void Job::DependencyOf(Job* dependency) {
@@ -270,12 +641,37 @@ void Job::OnDependancyFinished() {
 }
 
 void Job::OnFinish() {
-    for(auto& dependent : dependents) {
-        dependent->OnDependancyFinished();
+    const auto inline_count = (std::min)(_dependent_count, MAX_INLINE_DEPENDENTS);
+    for(std::size_t i = 0; i < inline_count; ++i) {
+        _dependents[i]->OnDependancyFinished();
+    }
+    auto remaining = _dependent_count - inline_count;
+    for(auto chunk = _dependents_overflow; chunk && remaining; chunk = chunk->next) {
+        const auto chunk_count = (std::min)(remaining, MAX_INLINE_DEPENDENTS);
+        for(std::size_t i = 0; i < chunk_count; ++i) {
+            chunk->jobs[i]->OnDependancyFinished();
+        }
+        remaining -= chunk_count;
     }
 }
 
 void Job::AddDependent(Job* dependent) {
     dependent->state = JobState::Enqueued;
-    dependents.push_back(dependent);
+    if(_dependent_count < MAX_INLINE_DEPENDENTS) {
+        _dependents[_dependent_count++] = dependent;
+        return;
+    }
+    //Overflow chunks are chained in insertion order; only fan-outs wider than the inline array pay for them.
+    auto overflow_index = _dependent_count - MAX_INLINE_DEPENDENTS;
+    auto slot = overflow_index % MAX_INLINE_DEPENDENTS;
+    auto chunk_index = overflow_index / MAX_INLINE_DEPENDENTS;
+    auto* link = &_dependents_overflow;
+    for(std::size_t i = 0; i < chunk_index; ++i) {
+        link = &(*link)->next;
+    }
+    if(!*link) {
+        *link = new DependentChunk{};
+    }
+    (*link)->jobs[slot] = dependent;
+    ++_dependent_count;
 }
@@ -1,17 +1,30 @@
 #pragma once
 
 #include "Engine/Core/EngineSubsystem.hpp"
-#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/InlineFunction.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
+#include "Engine/Core/OverflowQueue.hpp"
+#include "Engine/Core/ThreadParker.hpp"
+#include "Engine/Core/WorkStealingQueue.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <random>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 class Job;
 class JobSystem;
+template<typename T>
+class JobFuture;
 
 enum class JobType : std::size_t {
     Generic,
@@ -22,6 +35,21 @@ enum class JobType : std::size_t {
     Max,
 };
 
+//Scanned High to Low; see JobSystem::ScanPriority for starvation protection.
+enum class JobPriority : std::size_t {
+    High,
+    Normal,
+    Low,
+    Max,
+};
+
+//Threads that get a physical core of their own, kept free of generic workers.
+enum class ReservedCore : std::size_t {
+    Main,
+    Logging,
+    Max,
+};
+
 enum class JobState : unsigned int {
     None,
     Created,
@@ -32,27 +60,86 @@ enum class JobState : unsigned int {
     Max,
 };
 
+using JobCallback = InlineFunction<void(void*), 64>;
+
+//Half-open index range [first, last).
+struct IndexRange {
+    std::size_t first = 0u;
+    std::size_t last = 0u;
+};
+
 class Job {
 public:
     Job(JobSystem& jobSystem);
     ~Job();
     JobType type{};
-    JobState state{};
-    std::function<void(void*)> work_cb;
-    void* user_data;
+    JobPriority priority = JobPriority::Normal;
+    std::atomic<JobState> state{};
+    JobCallback work_cb{};
+    void* user_data = nullptr;
+    //Set by Dispatch while JobInstrumentation is enabled; zero means untimed.
+    std::uint64_t submit_ticks = 0u;
+    std::size_t queue_depth = 0u;
 
     void DependencyOf(Job* dependency);
     void DependentOn(Job* parent);
     void OnDependancyFinished();
     void OnFinish();
 
-    std::vector<Job*> dependents{};
+    //Intrusive reference count. The job returns to its pool when it reaches zero.
     std::atomic<unsigned int> num_dependencies{ 0u };
 private:
+    static constexpr std::size_t MAX_INLINE_DEPENDENTS = 4u;
+    struct DependentChunk {
+        std::array<Job*, MAX_INLINE_DEPENDENTS> jobs{};
+        DependentChunk* next = nullptr;
+    };
     void AddDependent(Job* dependent);
+    std::array<Job*, MAX_INLINE_DEPENDENTS> _dependents{};
+    DependentChunk* _dependents_overflow = nullptr;
+    std::size_t _dependent_count = 0u;
     JobSystem* _job_system = nullptr;
 };
 
+//One lock-free ring per priority level. A full ring spills instead of blocking, so a
+//category's only draining thread (main, Io, Logging) can always dispatch into it.
+class PriorityJobQueue {
+public:
+    explicit PriorityJobQueue(std::size_t capacityPerPriority);
+    ~PriorityJobQueue() = default;
+    void push(Job* job);
+    bool try_pop(Job*& job, const JobPriority& priority);
+    bool empty() const;
+    std::size_t size() const;
+private:
+    std::array<std::unique_ptr<OverflowQueue<Job*>>, static_cast<std::size_t>(JobPriority::Max)> _queues{};
+};
+
+//One work-stealing deque per priority level, owned by a single generic worker.
+class PriorityWorkStealingQueue {
+public:
+    void push(Job* job);
+    bool pop(Job*& job, const JobPriority& priority);
+    bool steal(Job*& job, const JobPriority& priority);
+    bool empty() const;
+private:
+    std::array<WorkStealingQueue<Job*>, static_cast<std::size_t>(JobPriority::Max)> _deques;
+};
+
+struct JobSystemDesc {
+    //Positive: exactly this many generic workers.
+    //Zero or negative: one worker per unreserved core (or logical processor with use_smt), reduced by this amount.
+    int generic_count = 0;
+    std::size_t category_count = static_cast<std::size_t>(JobType::Max);
+    std::condition_variable* main_job_signal = nullptr;
+    //Cores set aside for the first reserved_core_count ReservedCore threads, in enum order.
+    std::size_t reserved_core_count = static_cast<std::size_t>(ReservedCore::Max);
+    //One worker per logical processor instead of per physical core.
+    bool use_smt = false;
+    //Pin each worker to its core's logical processors, and allow PinThread/PinCurrentThread.
+    bool pin_threads = false;
+};
+
 class JobConsumer {
 public:
     void AddCategory(const JobType& category);
@@ -61,41 +148,194 @@ public:
     void ConsumeFor(TimeUtils::FPMilliseconds consume_duration);
     bool HasJobs() const;
 private:
-    std::vector<ThreadSafeQueue<Job*>*> _consumables{};
+    std::vector<PriorityJobQueue*> _consumables{};
+    std::size_t _picks = 0u;
     friend class JobSystem;
 };
 
 class JobSystem {
 public:
+    struct ParkingStats {
+        //Times a generic worker blocked in the OS after spinning.
+        std::size_t parks = 0u;
+        //Dispatches that had to wake a blocked worker.
+        std::size_t wakeups = 0u;
+    };
+
+    //Lock-free slots per priority level of each category queue; jobs beyond it spill to an overflow list.
+    static constexpr std::size_t JOB_QUEUE_CAPACITY = 1u << 16;
+
+    //Ignores the core topology: logical processor count plus genericCount minus one workers when genericCount <= 0.
     JobSystem(int genericCount, std::size_t categoryCount, std::condition_variable* mainJobSignal);
+    explicit JobSystem(const JobSystemDesc& desc);
     ~JobSystem();
 
     void BeginFrame();
     void Shutdown();
 
     void SetCategorySignal(const JobType& category_id, std::condition_variable* signal);
-    Job* Create(const JobType& category, const std::function<void(void*)>& cb, void* user_data);
-    void Run(const JobType& category, const std::function<void(void*)>& cb, void* user_data);
+    template<typename F>
+    Job* Create(const JobType& category, F&& cb, void* user_data, const JobPriority& priority = JobPriority::Normal);
+    template<typename F>
+    void Run(const JobType& category, F&& cb, void* user_data, const JobPriority& priority = JobPriority::Normal);
+    //Runs fn() as a job and hands back its result. Defined in JobFuture.hpp.
+    //Like every dispatch, a category this JobSystem was created without runs as Generic.
+    template<typename F>
+    auto Async(const JobType& category, F&& fn, const JobPriority& priority = JobPriority::Normal) -> JobFuture<std::invoke_result_t<F>>;
     void Dispatch(Job* job);
     bool Release(Job* job);
     void Wait(Job* job);
     void DispatchAndRelease(Job* job);
     void WaitAndRelease(Job* job);
+
+    //Calls fn(index) for every index in range, splitting it across the generic workers.
+    //Ranges no larger than grain run on a single thread. The caller helps until every index is done.
+    template<typename F>
+    void ParallelFor(const IndexRange& range, std::size_t grain, F&& fn);
+    //Folds fn(accumulator, index) over grain-sized chunks in parallel, then merges the
+    //chunk results in index order with combine(lhs, rhs) so the result is deterministic.
+    template<typename T, typename F, typename Combine>
+    T ParallelReduce(const IndexRange& range, std::size_t grain, const T& identity, F&& fn, Combine&& combine);
     bool IsRunning();
     void SetIsRunning(bool value = true);
 
     std::condition_variable* GetMainJobSignal() const;
+    ParkingStats GetParkingStats() const;
+    std::size_t GetGenericWorkerCount() const;
+
+    //Pins a thread to its reserved core. Returns false unless pin_threads was set and the core was reserved.
+    bool PinThread(std::thread& thread, const ReservedCore& core) const;
+    bool PinCurrentThread(const ReservedCore& core) const;
 protected:
 private:
-    void Initialize(int genericCount, std::size_t categoryCount);
+    void Initialize(const JobSystemDesc& desc);
+    //Splits the cores into reserved cores and per-worker logical processor sets.
+    void AssignCores(const JobSystemDesc& desc);
     void MainStep();
-    void GenericJobWorker(std::condition_variable* signal);
+    struct WorkerSlot {
+        ThreadParker parker{};
+        std::atomic_bool is_listed{ false };
+        std::atomic<std::size_t> wakeups{ 0u };
+    };
 
-    static std::vector<ThreadSafeQueue<Job*>*> _queues;
+    void GenericJobWorker(std::size_t worker_index);
+    void IoJobWorker();
+    bool TryGetGenericJob(std::size_t worker_index, std::minstd_rand& rng, std::size_t& picks, Job*& job);
+    static JobPriority ScanPriority(std::size_t pick, std::size_t step);
+    bool SpinForGenericJob(std::size_t spin_count) const;
+    void ParkGenericWorker(std::size_t worker_index);
+    void WakeGenericWorker();
+    bool HelpExecute();
+    void HelpUntilZero(const std::atomic<std::size_t>& counter);
+    template<typename F>
+    void ParallelForSplit(IndexRange range, std::size_t grain, F& fn, std::atomic<std::size_t>& pending);
+    static void Execute(Job* job);
+    Job* AllocateJob(const JobType& category, void* user_data, const JobPriority& priority);
+    static void FreeJob(Job* job);
+
+    static constexpr std::size_t STARVATION_INTERVAL = 8u;
+    static constexpr std::size_t MIN_SPIN_COUNT = 64u;
+    static constexpr std::size_t MAX_SPIN_COUNT = 4096u;
+    static constexpr std::size_t NOT_A_WORKER = (std::numeric_limits<std::size_t>::max)();
+
+    static std::vector<PriorityJobQueue*> _queues;
+    static std::vector<PriorityWorkStealingQueue*> _local_queues;
+    static std::vector<WorkerSlot*> _worker_slots;
     static std::vector<std::condition_variable*> _signals;
     static std::vector<std::thread> _threads;
+    static thread_local std::size_t _worker_index;
     std::condition_variable* _main_job_signal = nullptr;
+    //Logical processors per ReservedCore, and per generic worker slot.
+    std::vector<std::vector<int>> _reserved_processors{};
+    std::vector<std::vector<int>> _worker_processors{};
+    bool _pin_threads = false;
     std::mutex _cs{};
     std::atomic_bool _is_running = false;
+    std::atomic<std::size_t> _generic_pending{ 0u };
+    std::atomic<std::size_t> _sleeping_workers{ 0u };
+    //Indices of workers that are parked or about to park. An entry whose is_listed is already
+    //cleared is stale (the worker found work instead) and WakeGenericWorker skips it.
+    LockFreeQueue<std::size_t> _idle_workers{};
+    ThreadParker _io_parker{};
     friend class JobConsumer;
-};
\ No newline at end of file
+    friend class TaskGraph;
+    template<typename T>
+    friend class JobFuture;
+};
+
+template<typename F>
+Job* JobSystem::Create(const JobType& category, F&& cb, void* user_data, const JobPriority& priority /*= JobPriority::Normal*/) {
+    auto j = AllocateJob(category, user_data, priority);
+    j->work_cb = std::forward<F>(cb);
+    return j;
+}
+
+template<typename F>
+void JobSystem::Run(const JobType& category, F&& cb, void* user_data, const JobPriority& priority /*= JobPriority::Normal*/) {
+    Job* job = Create(category, std::forward<F>(cb), user_data, priority);
+    job->state = JobState::Running;
+    DispatchAndRelease(job);
+}
+
+template<typename F>
+void JobSystem::ParallelFor(const IndexRange& range, std::size_t grain, F&& fn) {
+    if(range.last <= range.first) {
+        return;
+    }
+    grain = (std::max)(grain, std::size_t{ 1u });
+    if(range.last - range.first <= grain || _local_queues.empty()) {
+        for(auto i = range.first; i != range.last; ++i) {
+            fn(i);
+        }
+        return;
+    }
+    std::atomic<std::size_t> pending{ 0u };
+    ParallelForSplit(range, grain, fn, pending);
+    HelpUntilZero(pending);
+}
+
+template<typename F>
+void JobSystem::ParallelForSplit(IndexRange range, std::size_t grain, F& fn, std::atomic<std::size_t>& pending) {
+    //Keep halving; each right half becomes a job idle workers can steal.
+    while(grain < range.last - range.first) {
+        const auto mid = range.first + (range.last - range.first) / 2u;
+        const IndexRange right{ mid, range.last };
+        ++pending;
+        Run(JobType::Generic, [this, right, grain, &fn, &pending](void*) {
+            ParallelForSplit(right, grain, fn, pending);
+            --pending;
+        }, nullptr);
+        range.last = mid;
+    }
+    for(auto i = range.first; i != range.last; ++i) {
+        fn(i);
+    }
+}
+
+template<typename T, typename F, typename Combine>
+T JobSystem::ParallelReduce(const IndexRange& range, std::size_t grain, const T& identity, F&& fn, Combine&& combine) {
+    if(range.last <= range.first) {
+        return identity;
+    }
+    grain = (std::max)(grain, std::size_t{ 1u });
+    const auto chunk_count = (range.last - range.first + grain - 1u) / grain;
+    //Wrapped so T = bool does not pick the packed vector<bool>.
+    struct partial_t {
+        T value;
+    };
+    std::vector<partial_t> partials(chunk_count, partial_t{ identity });
+    ParallelFor(IndexRange{ 0u, chunk_count }, 1u, [&](std::size_t chunk) {
+        const auto first = range.first + chunk * grain;
+        const auto last = (std::min)(first + grain, range.last);
+        T accumulator = identity;
+        for(auto i = first; i != last; ++i) {
+            accumulator = fn(accumulator, i);
+        }
+        partials[chunk].value = std::move(accumulator);
+    });
+    T result = identity;
+    for(auto& partial : partials) {
+        result = combine(result, partial.value);
+    }
+    return result;
+}
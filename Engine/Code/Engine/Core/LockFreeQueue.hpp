@@ -0,0 +1,162 @@
+#pragma once
+//Bounded multi-producer/multi-consumer ring queue.
+//http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+//Dmitry Vyukov - Bounded MPMC queue
+//Each cell carries a sequence number so producers and consumers only contend on
+//a single CAS of their respective cursor.
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+template<typename T>
+class LockFreeQueue {
+public:
+    explicit LockFreeQueue(std::size_t capacity = 1024);
+    ~LockFreeQueue();
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue(LockFreeQueue&&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+
+    //Blocks (yielding) while the queue is full.
+    void push(const T& t);
+    void push(T&& t);
+    bool try_push(const T& t);
+    bool try_push(T&& t);
+    bool try_pop(T& t);
+
+    //Approximate under contention.
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t capacity() const;
+
+protected:
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{ 0u };
+        T data{};
+    };
+
+    template<typename U>
+    bool try_emplace(U&& u);
+
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) Cell* _buffer = nullptr;
+    std::size_t _mask = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _enqueue_pos{ 0u };
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _dequeue_pos{ 0u };
+    char _pad[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)]{};
+};
+
+template<typename T>
+LockFreeQueue<T>::LockFreeQueue(std::size_t capacity /*= 1024*/) {
+    std::size_t size = 2;
+    while(size < capacity) {
+        size <<= 1;
+    }
+    _buffer = new Cell[size];
+    _mask = size - 1;
+    for(std::size_t i = 0; i < size; ++i) {
+        _buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+LockFreeQueue<T>::~LockFreeQueue() {
+    delete[] _buffer;
+    _buffer = nullptr;
+}
+
+template<typename T>
+void LockFreeQueue<T>::push(const T& t) {
+    while(!try_push(t)) {
+        std::this_thread::yield();
+    }
+}
+
+template<typename T>
+void LockFreeQueue<T>::push(T&& t) {
+    while(!try_emplace(std::move(t))) {
+        std::this_thread::yield();
+    }
+}
+
+template<typename T>
+bool LockFreeQueue<T>::try_push(const T& t) {
+    return try_emplace(t);
+}
+
+template<typename T>
+bool LockFreeQueue<T>::try_push(T&& t) {
+    return try_emplace(std::move(t));
+}
+
+template<typename T>
+template<typename U>
+bool LockFreeQueue<T>::try_emplace(U&& u) {
+    Cell* cell = nullptr;
+    auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+    for(;;) {
+        cell = &_buffer[pos & _mask];
+        auto seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if(diff == 0) {
+            if(_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(diff < 0) {
+            //Full
+            return false;
+        } else {
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->data = std::forward<U>(u);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+bool LockFreeQueue<T>::try_pop(T& t) {
+    Cell* cell = nullptr;
+    auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+    for(;;) {
+        cell = &_buffer[pos & _mask];
+        auto seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+        if(diff == 0) {
+            if(_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(diff < 0) {
+            //Empty
+            return false;
+        } else {
+            pos = _dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    t = std::move(cell->data);
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+std::size_t LockFreeQueue<T>::size() const {
+    auto enqueue_pos = _enqueue_pos.load(std::memory_order_relaxed);
+    auto dequeue_pos = _dequeue_pos.load(std::memory_order_relaxed);
+    return enqueue_pos <= dequeue_pos ? std::size_t{ 0u } : enqueue_pos - dequeue_pos;
+}
+
+template<typename T>
+bool LockFreeQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template<typename T>
+std::size_t LockFreeQueue<T>::capacity() const {
+    return _mask + 1;
+}
@@ -2,6 +2,7 @@
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/JobFuture.hpp"
 #include "Engine/Core/StringUtils.hpp"
 
 #include "Engine/Profiling/ProfileLogScope.hpp"
@@ -40,6 +41,34 @@ bool Obj::Load(const std::string& filepath) {
 
 bool Obj::Load(const std::filesystem::path& filepath) {
     PROFILE_LOG_SCOPE_FUNCTION();
+    if(!IsValidObjPath(filepath)) {
+        return false;
+    }
+    return Parse(filepath);
+}
+
+//The Obj must outlive the returned future.
+JobFuture<bool> Obj::LoadAsync(JobSystem& jobSystem, const std::string& filepath) {
+    namespace FS = std::filesystem;
+    FS::path p(filepath);
+    p.make_preferred();
+    if(!IsValidObjPath(p)) {
+        JobFuture<bool> failed(jobSystem);
+        failed.SetValue(false);
+        return failed;
+    }
+    BeginParse();
+    //The read runs on the Io thread; parsing continues on a generic worker.
+    return FileUtils::ReadFileAsync(jobSystem, p.string()).Then([this, p](std::optional<std::vector<unsigned char>>& buffer) {
+        if(!buffer) {
+            _is_loading = false;
+            return false;
+        }
+        return ParseBuffer(p, *buffer);
+    });
+}
+
+bool Obj::IsValidObjPath(const std::filesystem::path& filepath) const {
     namespace FS = std::filesystem;
     bool not_exist = !FS::exists(filepath);
     std::string valid_extension = ".obj";
@@ -51,7 +80,7 @@ bool Obj::Load(const std::filesystem::path& filepath) {
         DebuggerPrintf(ss.str().c_str());
         return false;
     }
-    return Parse(filepath);
+    return true;
 }
 
 //Run only as an asynchronous operation highly recommended.
@@ -187,6 +216,16 @@ void Obj::Unload() {
 
 bool Obj::Parse(const std::filesystem::path& filepath) {
     PROFILE_LOG_SCOPE_FUNCTION();
+    BeginParse();
+    std::vector<unsigned char> buffer{};
+    if(FileUtils::ReadBufferFromFile(buffer, filepath.string())) {
+        return ParseBuffer(filepath, buffer);
+    }
+    _is_loading = false;
+    return false;
+}
+
+void Obj::BeginParse() {
     _verts.clear();
     _tex_coords.clear();
     _normals.clear();
@@ -198,140 +237,141 @@ bool Obj::Parse(const std::filesystem::path& filepath) {
     _is_saving = false;
     _is_saved = false;
     _is_loading = true;
-    std::vector<unsigned char> buffer{};
-    if(FileUtils::ReadBufferFromFile(buffer, filepath.string())) {
-        std::stringstream ss{};
-        if(ss.write(reinterpret_cast<const char*>(buffer.data()), buffer.size())) {
-            buffer.clear();
-            buffer.shrink_to_fit();
-            ss.clear();
-            ss.seekg(ss.beg);
-            ss.seekp(ss.beg);
-            std::string cur_line{};
-            std::size_t vert_count{};
-            unsigned long long line_index = 0;
-            while(std::getline(ss, cur_line, '\n')) {
-                if(StringUtils::StartsWith(cur_line, "v ")) {
-                    ++vert_count;
-                }
+}
+
+bool Obj::ParseBuffer(const std::filesystem::path& filepath, std::vector<unsigned char>& buffer) {
+    PROFILE_LOG_SCOPE_FUNCTION();
+    std::stringstream ss{};
+    if(ss.write(reinterpret_cast<const char*>(buffer.data()), buffer.size())) {
+        buffer.clear();
+        buffer.shrink_to_fit();
+        ss.clear();
+        ss.seekg(ss.beg);
+        ss.seekp(ss.beg);
+        std::string cur_line{};
+        std::size_t vert_count{};
+        unsigned long long line_index = 0;
+        while(std::getline(ss, cur_line, '\n')) {
+            if(StringUtils::StartsWith(cur_line, "v ")) {
+                ++vert_count;
             }
-            ss.clear();
-            ss.seekg(ss.beg);
-            ss.seekp(ss.beg);
-            _verts.reserve(vert_count);
-            _vbo.resize(vert_count);
-            while(std::getline(ss, cur_line, '\n')) {
-                ++line_index;
-                cur_line = cur_line.substr(0, cur_line.find_first_of('#'));
-                if(cur_line.empty()) {
-                    continue;
+        }
+        ss.clear();
+        ss.seekg(ss.beg);
+        ss.seekp(ss.beg);
+        _verts.reserve(vert_count);
+        _vbo.resize(vert_count);
+        while(std::getline(ss, cur_line, '\n')) {
+            ++line_index;
+            cur_line = cur_line.substr(0, cur_line.find_first_of('#'));
+            if(cur_line.empty()) {
+                continue;
+            }
+            cur_line = StringUtils::TrimWhitespace(cur_line);
+            if(StringUtils::StartsWith(cur_line, "mtllib ")) {
+                continue;
+            } else if(StringUtils::StartsWith(cur_line, "usemtl ")) {
+                continue;
+            } else if(StringUtils::StartsWith(cur_line, "v ")) {
+                auto elems = StringUtils::Split(std::string{std::begin(cur_line) + 2, std::end(cur_line)}, ' ');
+                std::string v_str = {"["};
+                v_str += StringUtils::Join(elems, ',');
+                switch(elems.size()) {
+                case 4: /* DO NOTHING */                        break;
+                case 3: v_str += ",1.0";                         break;
+                case 2: v_str += ",0.0,1.0";                     break;
+                case 1: v_str += ",0.0,0.0,1.0";                 break;
+                default: PrintErrorToDebugger(filepath.string(), "vertex", line_index); return false;
                 }
-                cur_line = StringUtils::TrimWhitespace(cur_line);
-                if(StringUtils::StartsWith(cur_line, "mtllib ")) {
-                    continue;
-                } else if(StringUtils::StartsWith(cur_line, "usemtl ")) {
-                    continue;
-                } else if(StringUtils::StartsWith(cur_line, "v ")) {
-                    auto elems = StringUtils::Split(std::string{std::begin(cur_line) + 2, std::end(cur_line)}, ' ');
-                    std::string v_str = {"["};
-                    v_str += StringUtils::Join(elems, ',');
-                    switch(elems.size()) {
-                    case 4: /* DO NOTHING */                        break;
-                    case 3: v_str += ",1.0";                         break;
-                    case 2: v_str += ",0.0,1.0";                     break;
-                    case 1: v_str += ",0.0,0.0,1.0";                 break;
-                    default: PrintErrorToDebugger(filepath.string(), "vertex", line_index); return false;
-                    }
-                    v_str += "]";
-                    Vector4 v(v_str);
-                    v.CalcHomogeneous();
-                    _verts.emplace_back(v);
-                } else if(StringUtils::StartsWith(cur_line, "vt ")) {
-                    auto elems = StringUtils::Split(std::string{ std::begin(cur_line) + 3, std::end(cur_line) }, ' ');
-                    std::string v_str = { "[" };
-                    v_str += StringUtils::Join(elems, ',');
-                    switch(elems.size()) {
-                    case 3: /* DO NOTHING */    break;
-                    case 2: v_str += ",0.0";     break;
-                    case 1: v_str += ",0.0,0.0"; break;
-                    default: PrintErrorToDebugger(filepath.string(), "texture coordinate", line_index); return false;
-                    }
-                    v_str += "]";
-                    _tex_coords.emplace_back(v_str);
-                } else if(StringUtils::StartsWith(cur_line, "vn ")) {
-                    auto elems = StringUtils::Split(std::string{ std::begin(cur_line) + 3, std::end(cur_line) }, ' ');
-                    std::string v_str = { "[" };
-                    v_str += StringUtils::Join(elems, ',');
-                    if(elems.size() != 3) {
-                        PrintErrorToDebugger(filepath.string(), "vertex normal", line_index);
-                        return false;
-                    }
-                    v_str += "]";
-                    _normals.emplace_back(v_str);
-                } else if(StringUtils::StartsWith(cur_line, "f ")) {
-                    if(cur_line.find('-') != std::string::npos) {
-                        DebuggerPrintf("OBJ implementation does not support relative reference numbers!\n");
-                        PrintErrorToDebugger(filepath.string(), "face index", line_index);
-                        return false;
-                    }
-                    auto tris = StringUtils::Split(std::string{ std::begin(cur_line) + 2, std::end(cur_line) }, ' ');
-                    if(tris.size() != 3) {
-                        DebuggerPrintf("OBJ implementation does not support non-triangle faces!\n");
-                        PrintErrorToDebugger(filepath.string(), "face triplet", line_index);
-                        return false;
-                    }
-                    for(auto& t : tris) {
-                        auto elems = StringUtils::Split(t, '/', false);
-                        Vertex3D vertex{};
-                        decltype(_face_idxs)::value_type face{};
-                        auto elem_count = elems.size();
-                        std::size_t cur_vbo_index = 0;
-                        for(auto i = 0u; i < elem_count; ++i) {
-                            switch(i) {
-                                case 0:
-                                    if(!elems[0].empty()) {
-                                        std::size_t cur_v = std::stoul(elems[0]);
-                                        cur_vbo_index = cur_v - 1;
-                                        std::get<0>(face) = cur_vbo_index;
-                                        vertex.position = _verts[cur_vbo_index];
-                                        _ibo.push_back(static_cast<unsigned int>(cur_vbo_index));
-                                    } else {
-                                        std::get<0>(face) = static_cast<std::size_t>(-1);
-                                    }
-                                    break;
-                                case 1:
-                                    if(!elems[1].empty()) {
-                                        std::size_t cur_vt = std::stoul(elems[1]);
-                                        std::get<1>(face) = cur_vt;
-                                        vertex.texcoords = Vector2{ _tex_coords[cur_vt - 1] };
-                                    } else {
-                                        std::get<1>(face) = static_cast<std::size_t>(-1);
-                                    }
-                                    break;
-                                case 2:
-                                    if(!elems[2].empty()) {
-                                        std::size_t cur_vn = std::stoul(elems[2]);
-                                        std::get<2>(face) = cur_vn - 1;
-                                        vertex.normal = _normals[cur_vn - 1];
-                                    } else {
-                                        std::get<2>(face) = static_cast<std::size_t>(-1);
-                                    }
-                                    break;
-                                default: break;
-                            }
+                v_str += "]";
+                Vector4 v(v_str);
+                v.CalcHomogeneous();
+                _verts.emplace_back(v);
+            } else if(StringUtils::StartsWith(cur_line, "vt ")) {
+                auto elems = StringUtils::Split(std::string{ std::begin(cur_line) + 3, std::end(cur_line) }, ' ');
+                std::string v_str = { "[" };
+                v_str += StringUtils::Join(elems, ',');
+                switch(elems.size()) {
+                case 3: /* DO NOTHING */    break;
+                case 2: v_str += ",0.0";     break;
+                case 1: v_str += ",0.0,0.0"; break;
+                default: PrintErrorToDebugger(filepath.string(), "texture coordinate", line_index); return false;
+                }
+                v_str += "]";
+                _tex_coords.emplace_back(v_str);
+            } else if(StringUtils::StartsWith(cur_line, "vn ")) {
+                auto elems = StringUtils::Split(std::string{ std::begin(cur_line) + 3, std::end(cur_line) }, ' ');
+                std::string v_str = { "[" };
+                v_str += StringUtils::Join(elems, ',');
+                if(elems.size() != 3) {
+                    PrintErrorToDebugger(filepath.string(), "vertex normal", line_index);
+                    return false;
+                }
+                v_str += "]";
+                _normals.emplace_back(v_str);
+            } else if(StringUtils::StartsWith(cur_line, "f ")) {
+                if(cur_line.find('-') != std::string::npos) {
+                    DebuggerPrintf("OBJ implementation does not support relative reference numbers!\n");
+                    PrintErrorToDebugger(filepath.string(), "face index", line_index);
+                    return false;
+                }
+                auto tris = StringUtils::Split(std::string{ std::begin(cur_line) + 2, std::end(cur_line) }, ' ');
+                if(tris.size() != 3) {
+                    DebuggerPrintf("OBJ implementation does not support non-triangle faces!\n");
+                    PrintErrorToDebugger(filepath.string(), "face triplet", line_index);
+                    return false;
+                }
+                for(auto& t : tris) {
+                    auto elems = StringUtils::Split(t, '/', false);
+                    Vertex3D vertex{};
+                    decltype(_face_idxs)::value_type face{};
+                    auto elem_count = elems.size();
+                    std::size_t cur_vbo_index = 0;
+                    for(auto i = 0u; i < elem_count; ++i) {
+                        switch(i) {
+                            case 0:
+                                if(!elems[0].empty()) {
+                                    std::size_t cur_v = std::stoul(elems[0]);
+                                    cur_vbo_index = cur_v - 1;
+                                    std::get<0>(face) = cur_vbo_index;
+                                    vertex.position = _verts[cur_vbo_index];
+                                    _ibo.push_back(static_cast<unsigned int>(cur_vbo_index));
+                                } else {
+                                    std::get<0>(face) = static_cast<std::size_t>(-1);
+                                }
+                                break;
+                            case 1:
+                                if(!elems[1].empty()) {
+                                    std::size_t cur_vt = std::stoul(elems[1]);
+                                    std::get<1>(face) = cur_vt;
+                                    vertex.texcoords = Vector2{ _tex_coords[cur_vt - 1] };
+                                } else {
+                                    std::get<1>(face) = static_cast<std::size_t>(-1);
+                                }
+                                break;
+                            case 2:
+                                if(!elems[2].empty()) {
+                                    std::size_t cur_vn = std::stoul(elems[2]);
+                                    std::get<2>(face) = cur_vn - 1;
+                                    vertex.normal = _normals[cur_vn - 1];
+                                } else {
+                                    std::get<2>(face) = static_cast<std::size_t>(-1);
+                                }
+                                break;
+                            default: break;
                         }
-                        _vbo[cur_vbo_index] = vertex;
-                        _face_idxs.emplace_back(face);
                     }
-                } else {
-                    /* DO NOTHING */
+                    _vbo[cur_vbo_index] = vertex;
+                    _face_idxs.emplace_back(face);
                 }
+            } else {
+                /* DO NOTHING */
             }
-            _ibo.shrink_to_fit();
-            _is_loaded = true;
-            _is_loading = false;
-            return true;
         }
+        _ibo.shrink_to_fit();
+        _is_loaded = true;
+        _is_loading = false;
+        return true;
     }
     _is_loading = false;
     return false;
@@ -11,6 +11,10 @@
 #include <string>
 #include <vector>
 
+class JobSystem;
+template<typename T>
+class JobFuture;
+
 namespace FileUtils {
 
     class Obj {
@@ -28,6 +32,7 @@ namespace FileUtils {
 
         void Unload();
         bool Load(const std::string& filepath);
+        JobFuture<bool> LoadAsync(JobSystem& jobSystem, const std::string& filepath);
         bool Save(const std::string& filepath);
         bool IsLoaded() const;
         bool IsLoading() const;
@@ -39,7 +44,10 @@ namespace FileUtils {
 
         bool Load(const std::filesystem::path& filepath);
         bool Save(const std::filesystem::path& filepath);
+        bool IsValidObjPath(const std::filesystem::path& filepath) const;
         bool Parse(const std::filesystem::path& filepath);
+        void BeginParse();
+        bool ParseBuffer(const std::filesystem::path& filepath, std::vector<unsigned char>& buffer);
 
         void PrintErrorToDebugger(const std::string& filePath, const std::string& elementType, unsigned long long line_index) const;
 
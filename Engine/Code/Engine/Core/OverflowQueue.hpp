@@ -0,0 +1,115 @@
+#pragma once
+//Bounded lock-free ring backed by an unbounded, mutex-guarded overflow list.
+//push never blocks: once the ring is full items spill to the overflow list, so the only
+//thread draining a queue can keep pushing into it without waiting on itself.
+//While anything is spilled new items spill too and pops drain the ring first, so a single
+//producer's items stay in FIFO order.
+
+#include "Engine/Core/LockFreeQueue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+template<typename T>
+class OverflowQueue {
+public:
+    explicit OverflowQueue(std::size_t capacity = 1024);
+    ~OverflowQueue() = default;
+
+    OverflowQueue(const OverflowQueue&) = delete;
+    OverflowQueue(OverflowQueue&&) = delete;
+    OverflowQueue& operator=(const OverflowQueue&) = delete;
+    OverflowQueue& operator=(OverflowQueue&&) = delete;
+
+    void push(const T& t);
+    void push(T&& t);
+    bool try_pop(T& t);
+
+    //Approximate under contention.
+    std::size_t size() const;
+    bool empty() const;
+    //Capacity of the lock-free ring; the overflow list is unbounded.
+    std::size_t capacity() const;
+    //Items currently waiting in the overflow list.
+    std::size_t overflow_size() const;
+
+protected:
+private:
+    template<typename U>
+    void emplace(U&& u);
+
+    LockFreeQueue<T> _ring;
+    mutable std::mutex _cs{};
+    std::deque<T> _overflow{};
+    std::atomic<std::size_t> _overflow_size{ 0u };
+};
+
+template<typename T>
+OverflowQueue<T>::OverflowQueue(std::size_t capacity /*= 1024*/)
+    : _ring(capacity)
+{
+    /* DO NOTHING */
+}
+
+template<typename T>
+void OverflowQueue<T>::push(const T& t) {
+    emplace(t);
+}
+
+template<typename T>
+void OverflowQueue<T>::push(T&& t) {
+    emplace(std::move(t));
+}
+
+template<typename T>
+template<typename U>
+void OverflowQueue<T>::emplace(U&& u) {
+    //A failed try_push leaves u untouched, so it can still be forwarded to the overflow list.
+    if(_overflow_size.load(std::memory_order_acquire) == 0 && _ring.try_push(std::forward<U>(u))) {
+        return;
+    }
+    std::scoped_lock<std::mutex> lock(_cs);
+    _overflow.push_back(std::forward<U>(u));
+    _overflow_size.store(_overflow.size(), std::memory_order_release);
+}
+
+template<typename T>
+bool OverflowQueue<T>::try_pop(T& t) {
+    if(_ring.try_pop(t)) {
+        return true;
+    }
+    if(_overflow_size.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+    std::scoped_lock<std::mutex> lock(_cs);
+    if(_overflow.empty()) {
+        return false;
+    }
+    t = std::move(_overflow.front());
+    _overflow.pop_front();
+    _overflow_size.store(_overflow.size(), std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+std::size_t OverflowQueue<T>::size() const {
+    return _ring.size() + _overflow_size.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+bool OverflowQueue<T>::empty() const {
+    return size() == 0;
+}
+
+template<typename T>
+std::size_t OverflowQueue<T>::capacity() const {
+    return _ring.capacity();
+}
+
+template<typename T>
+std::size_t OverflowQueue<T>::overflow_size() const {
+    return _overflow_size.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,48 @@
+#include "Engine/Core/ParallelTransforms.hpp"
+
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/Vertex3D.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix4.hpp"
+#include "Engine/Math/Vector3.hpp"
+
+#include <algorithm>
+
+namespace {
+
+//Points per job: enough work to outweigh scheduling, few enough per job to spread a large mesh over the workers.
+constexpr std::size_t TRANSFORM_CHUNK_SIZE = 16384u;
+
+template<typename T, typename F>
+void ParallelTransform(JobSystem& jobSystem, const T* in, T* result, std::size_t count, F&& transformChunk) {
+    const auto chunk_count = (count + TRANSFORM_CHUNK_SIZE - 1u) / TRANSFORM_CHUNK_SIZE;
+    jobSystem.ParallelFor(IndexRange{ 0u, chunk_count }, 1u, [&](std::size_t chunk) {
+        const auto first = chunk * TRANSFORM_CHUNK_SIZE;
+        transformChunk(in + first, result + first, (std::min)(TRANSFORM_CHUNK_SIZE, count - first));
+    });
+}
+
+} //End anonymous namespace
+
+namespace MathUtils {
+
+void TransformPositions(JobSystem& jobSystem, const Matrix4& transform, const Vector3* positions, Vector3* result, std::size_t count) {
+    ParallelTransform(jobSystem, positions, result, count, [&transform](const Vector3* in, Vector3* out, std::size_t n) {
+        TransformPositions(transform, in, out, n);
+    });
+}
+
+void TransformDirections(JobSystem& jobSystem, const Matrix4& transform, const Vector3* directions, Vector3* result, std::size_t count) {
+    ParallelTransform(jobSystem, directions, result, count, [&transform](const Vector3* in, Vector3* out, std::size_t n) {
+        TransformDirections(transform, in, out, n);
+    });
+}
+
+void TransformVertices(JobSystem& jobSystem, const Matrix4& transform, const Vertex3D* vertices, Vertex3D* result, std::size_t count) {
+    ParallelTransform(jobSystem, vertices, result, count, [&transform](const Vertex3D* in, Vertex3D* out, std::size_t n) {
+        TransformVertices(transform, in, out, n);
+    });
+}
+
+} //End MathUtils
@@ -0,0 +1,20 @@
+#pragma once
+//MathUtils' batch transforms split into chunks across the generic workers, for large meshes.
+//They live in Core so Engine/Math does not depend on the job system.
+
+#include <cstddef>
+
+class JobSystem;
+class Matrix4;
+class Vector3;
+class Vertex3D;
+
+namespace MathUtils {
+
+//Same results as the serial forms in MathUtils.hpp. Small counts run on the calling thread,
+//which otherwise helps until every chunk is done.
+void TransformPositions(JobSystem& jobSystem, const Matrix4& transform, const Vector3* positions, Vector3* result, std::size_t count);
+void TransformDirections(JobSystem& jobSystem, const Matrix4& transform, const Vector3* directions, Vector3* result, std::size_t count);
+void TransformVertices(JobSystem& jobSystem, const Matrix4& transform, const Vertex3D* vertices, Vertex3D* result, std::size_t count);
+
+} //End MathUtils
@@ -1,7 +1,7 @@
 #include "Engine/Core/StringUtils.hpp"
 
+#include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/Rgba.hpp"
-#include "Engine/Core/Win.hpp"
 
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
@@ -10,7 +10,14 @@
 
 #include "Engine/System/Cpu.hpp"
 
+#ifdef PLATFORM_WINDOWS
+#include "Engine/Core/Win.hpp"
+#else
+#include <codecvt>
+#endif
+
 #include <cstdarg>
+#include <cstdio>
 #include <cwctype>
 
 #include <algorithm>
@@ -105,7 +112,7 @@ const std::string Stringf(const char* format, ...) {
     char textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH];
     va_list variableArgumentList;
     va_start(variableArgumentList, format);
-    vsnprintf_s(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList);
+    std::vsnprintf(textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, format, variableArgumentList);
     va_end(variableArgumentList);
     textLiteral[STRINGF_STACK_LOCAL_TEMP_LENGTH - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -120,7 +127,7 @@ const std::string Stringf(const int maxLength, const char* format, ...) {
 
     va_list variableArgumentList;
     va_start(variableArgumentList, format);
-    vsnprintf_s(textLiteral, maxLength, _TRUNCATE, format, variableArgumentList);
+    std::vsnprintf(textLiteral, maxLength, format, variableArgumentList);
     va_end(variableArgumentList);
     textLiteral[maxLength - 1] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -254,8 +261,18 @@ std::wstring Join(const std::vector<std::wstring>& strings, bool skip_empty /*=
     return result;
 }
 
+namespace {
+
+//The user's locale is fixed for the life of the process, so it is looked up once rather than per character.
+const std::ctype<char>& GetUserCtype() {
+    static const std::locale user_locale("");
+    return std::use_facet<std::ctype<char>>(user_locale);
+}
+
+} //End anonymous namespace
+
 std::string ToUpperCase(std::string string) {
-    std::transform(string.begin(), string.end(), string.begin(), [](unsigned char c) -> unsigned char { return std::toupper(c, std::locale("")); });
+    GetUserCtype().toupper(string.data(), string.data() + string.size());
     return string;
 }
 
@@ -265,7 +282,7 @@ std::wstring ToUpperCase(std::wstring string) {
 }
 
 std::string ToLowerCase(std::string string) {
-    std::transform(string.begin(), string.end(), string.begin(), [](unsigned char c) -> unsigned char { return std::tolower(c, std::locale("")); });
+    GetUserCtype().tolower(string.data(), string.data() + string.size());
     return string;
 }
 
@@ -276,6 +293,10 @@ std::wstring ToLowerCase(std::wstring string) {
 }
 
 std::string ConvertUnicodeToMultiByte(const std::wstring& unicode_string) {
+#ifndef PLATFORM_WINDOWS
+    //Invalid input converts to an empty string rather than throwing.
+    return std::wstring_convert<std::codecvt_utf8<wchar_t>>{ std::string{}, std::wstring{} }.to_bytes(unicode_string);
+#else
     char* buf = nullptr;
     auto buf_size = ::WideCharToMultiByte(CP_UTF8, WC_ERR_INVALID_CHARS, unicode_string.data(), -1, buf, 0, nullptr, nullptr);
     std::string mb_string;
@@ -285,9 +306,13 @@ std::string ConvertUnicodeToMultiByte(const std::wstring& unicode_string) {
     delete[] buf;
     buf = nullptr;
     return mb_string;
+#endif
 }
 
 std::wstring ConvertMultiByteToUnicode(const std::string& multi_byte_string) {
+#ifndef PLATFORM_WINDOWS
+    return std::wstring_convert<std::codecvt_utf8<wchar_t>>{ std::string{}, std::wstring{} }.from_bytes(multi_byte_string);
+#else
     wchar_t* buf = nullptr;
     auto buf_size = ::MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, multi_byte_string.data(), -1, buf, 0);
     std::wstring unicode_string;
@@ -297,6 +322,7 @@ std::wstring ConvertMultiByteToUnicode(const std::string& multi_byte_string) {
     delete[] buf;
     buf = nullptr;
     return unicode_string;
+#endif
 }
 
 bool StartsWith(const std::string& string, const std::string& start) {
@@ -0,0 +1,190 @@
+#include "Engine/Core/TaskGraph.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+TaskGraph::TaskGraph(JobSystem& jobSystem)
+    : _job_system(&jobSystem)
+{
+    /* DO NOTHING */
+}
+
+TaskGraph::TaskId TaskGraph::AddTask(const std::string& name, const std::function<void()>& work) {
+    _compiled = false;
+    Task t{};
+    t.name = name;
+    t.work = work;
+    _tasks.push_back(t);
+    return _tasks.size() - 1;
+}
+
+void TaskGraph::AddEdge(TaskId before, TaskId after) {
+    GUARANTEE_OR_DIE(before < _tasks.size() && after < _tasks.size(), "TaskGraph::AddEdge: invalid task id.");
+    GUARANTEE_OR_DIE(before != after, "TaskGraph::AddEdge: a task cannot depend on itself.");
+    _compiled = false;
+    _tasks[before].successors.push_back(after);
+    _tasks[after].predecessors.push_back(before);
+}
+
+void TaskGraph::Compile() {
+    const auto count = _tasks.size();
+    _roots.clear();
+    _topological_order.clear();
+    _topological_order.reserve(count);
+    _initial_counts.resize(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        _initial_counts[i] = static_cast<unsigned int>(_tasks[i].predecessors.size());
+        if(!_initial_counts[i]) {
+            _roots.push_back(i);
+        }
+    }
+    //Kahn's algorithm; anything left unvisited is part of a cycle.
+    auto counts = _initial_counts;
+    _topological_order = _roots;
+    for(std::size_t i = 0; i < _topological_order.size(); ++i) {
+        for(auto successor : _tasks[_topological_order[i]].successors) {
+            if(!--counts[successor]) {
+                _topological_order.push_back(successor);
+            }
+        }
+    }
+    GUARANTEE_OR_DIE(_topological_order.size() == count, "TaskGraph::Compile: graph contains a cycle.");
+
+    _pending_counts = std::make_unique<std::atomic<unsigned int>[]>(count);
+    _start_times.resize(count);
+    _end_times.resize(count);
+    _path_times.resize(count);
+    _path_parents.resize(count);
+    _last_report.tasks.reserve(count);
+    _last_report.critical_path.reserve(count);
+    _compiled = true;
+}
+
+bool TaskGraph::IsCompiled() const {
+    return _compiled;
+}
+
+void TaskGraph::Run() {
+    GUARANTEE_OR_DIE(_compiled, "TaskGraph::Run called before Compile.");
+    const auto count = _tasks.size();
+    for(std::size_t i = 0; i < count; ++i) {
+        _pending_counts[i].store(_initial_counts[i], std::memory_order_relaxed);
+    }
+    _remaining = count;
+    auto run_start = TimeUtils::Now();
+    if(_job_system->_local_queues.empty()) {
+        RunSerial();
+    } else {
+        for(auto root : _roots) {
+            Dispatch(root);
+        }
+        _job_system->HelpUntilZero(_remaining);
+    }
+    auto run_end = TimeUtils::Now();
+    ++_run_count;
+    BuildReport(run_start, run_end);
+}
+
+const TaskGraph::Report& TaskGraph::GetLastReport() const {
+    return _last_report;
+}
+
+void TaskGraph::RunSerial() {
+    for(auto id : _topological_order) {
+        _start_times[id] = TimeUtils::Now();
+        _tasks[id].work();
+        _end_times[id] = TimeUtils::Now();
+    }
+    _remaining = 0u;
+}
+
+void TaskGraph::Execute(TaskId id) {
+    _start_times[id] = TimeUtils::Now();
+    _tasks[id].work();
+    _end_times[id] = TimeUtils::Now();
+    Finish(id);
+}
+
+void TaskGraph::Finish(TaskId id) {
+    for(auto successor : _tasks[id].successors) {
+        if(_pending_counts[successor].fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+            Dispatch(successor);
+        }
+    }
+    //Last, so Run cannot return while a successor is still being dispatched.
+    --_remaining;
+}
+
+void TaskGraph::Dispatch(TaskId id) {
+    _job_system->Run(JobType::Generic, [this, id](void*) { Execute(id); }, nullptr);
+}
+
+void TaskGraph::BuildReport(time_point_t run_start, time_point_t run_end) {
+    auto& report = _last_report;
+    report.run_id = _run_count;
+    report.thread_count = _job_system->_local_queues.size() + 1u;
+    report.wall_time = run_end - run_start;
+    report.work_time = TimeUtils::FPMilliseconds{};
+    //Timings are overwritten in place so repeated runs reuse each name's buffer.
+    report.tasks.resize(_tasks.size());
+    for(std::size_t id = 0; id < _tasks.size(); ++id) {
+        auto& timing = report.tasks[id];
+        timing.id = id;
+        timing.name = _tasks[id].name;
+        timing.start = _start_times[id] - run_start;
+        timing.duration = _end_times[id] - _start_times[id];
+        report.work_time += timing.duration;
+    }
+    auto available = report.wall_time * static_cast<float>(report.thread_count);
+    report.idle_time = (std::max)(TimeUtils::FPMilliseconds{}, available - report.work_time);
+
+    //Longest chain of measured durations through the DAG: the frame cannot finish faster than this.
+    constexpr auto no_parent = (std::numeric_limits<TaskId>::max)();
+    TaskId tail = no_parent;
+    for(auto id : _topological_order) {
+        _path_times[id] = TimeUtils::FPMilliseconds{};
+        _path_parents[id] = no_parent;
+        for(auto predecessor : _tasks[id].predecessors) {
+            if(_path_times[id] < _path_times[predecessor]) {
+                _path_times[id] = _path_times[predecessor];
+                _path_parents[id] = predecessor;
+            }
+        }
+        _path_times[id] += report.tasks[id].duration;
+        if(tail == no_parent || _path_times[tail] < _path_times[id]) {
+            tail = id;
+        }
+    }
+    report.critical_path_time = tail == no_parent ? TimeUtils::FPMilliseconds{} : _path_times[tail];
+    std::size_t path_length = 0u;
+    for(auto id = tail; id != no_parent; id = _path_parents[id]) {
+        ++path_length;
+    }
+    report.critical_path.resize(path_length);
+    for(auto id = tail; id != no_parent; id = _path_parents[id]) {
+        report.critical_path[--path_length] = report.tasks[id];
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const TaskGraph::Report& report) {
+    auto old_fmt = out.flags();
+    auto old_precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "TaskGraph run " << report.run_id << ": " << report.tasks.size() << " tasks on " << report.thread_count << " threads\n";
+    out << std::left << std::setw(25) << "Wall time (ms):"          << std::right << std::setw(12) << report.wall_time.count() << '\n';
+    out << std::left << std::setw(25) << "Work time (ms):"          << std::right << std::setw(12) << report.work_time.count() << '\n';
+    out << std::left << std::setw(25) << "Idle time (ms):"          << std::right << std::setw(12) << report.idle_time.count() << '\n';
+    out << std::left << std::setw(25) << "Critical path (ms):"      << std::right << std::setw(12) << report.critical_path_time.count() << '\n';
+    for(const auto& timing : report.critical_path) {
+        out << "    " << std::left << std::setw(21) << timing.name
+            << std::right << std::setw(12) << timing.start.count()
+            << std::right << std::setw(12) << timing.duration.count() << '\n';
+    }
+    out.flags(old_fmt);
+    out.precision(old_precision);
+    return out;
+}
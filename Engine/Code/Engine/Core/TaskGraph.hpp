@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+//A frame's worth of work described up front as a DAG.
+//Build it once with AddTask/AddEdge, Compile() it, then Run() it every frame.
+//Run() only resets per-task counters and dispatches pooled jobs, and records
+//a per-run timing report with the critical path and worker idle time.
+class TaskGraph {
+public:
+    using TaskId = std::size_t;
+    using time_point_t = std::chrono::time_point<std::chrono::steady_clock>;
+
+    struct TaskTiming {
+        TaskId id = 0u;
+        //A copy, so the report stays valid when tasks are added or the graph is destroyed.
+        std::string name{};
+        TimeUtils::FPMilliseconds start{};
+        TimeUtils::FPMilliseconds duration{};
+    };
+
+    struct Report {
+        std::size_t run_id = 0u;
+        std::size_t thread_count = 0u;
+        TimeUtils::FPMilliseconds wall_time{};
+        TimeUtils::FPMilliseconds work_time{};
+        TimeUtils::FPMilliseconds idle_time{};
+        TimeUtils::FPMilliseconds critical_path_time{};
+        std::vector<TaskTiming> critical_path{};
+        std::vector<TaskTiming> tasks{};
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    explicit TaskGraph(JobSystem& jobSystem);
+    ~TaskGraph() = default;
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph(TaskGraph&&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    TaskGraph& operator=(TaskGraph&&) = delete;
+
+    TaskId AddTask(const std::string& name, const std::function<void()>& work);
+    //after will not start until before has finished.
+    void AddEdge(TaskId before, TaskId after);
+    void Compile();
+    bool IsCompiled() const;
+
+    //Blocks (helping the job system) until every task has run. Not reentrant.
+    void Run();
+    const Report& GetLastReport() const;
+
+protected:
+private:
+    struct Task {
+        std::string name{};
+        std::function<void()> work{};
+        std::vector<TaskId> successors{};
+        std::vector<TaskId> predecessors{};
+    };
+
+    void RunSerial();
+    void Execute(TaskId id);
+    void Finish(TaskId id);
+    void Dispatch(TaskId id);
+    void BuildReport(time_point_t run_start, time_point_t run_end);
+
+    JobSystem* _job_system = nullptr;
+    std::vector<Task> _tasks{};
+    std::vector<TaskId> _roots{};
+    std::vector<TaskId> _topological_order{};
+    std::vector<unsigned int> _initial_counts{};
+    std::unique_ptr<std::atomic<unsigned int>[]> _pending_counts{};
+    std::vector<time_point_t> _start_times{};
+    std::vector<time_point_t> _end_times{};
+    std::vector<TimeUtils::FPMilliseconds> _path_times{};
+    std::vector<TaskId> _path_parents{};
+    std::atomic<std::size_t> _remaining{ 0u };
+    std::size_t _run_count = 0u;
+    Report _last_report{};
+    bool _compiled = false;
+};
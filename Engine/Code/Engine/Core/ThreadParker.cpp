@@ -0,0 +1,83 @@
+#include "Engine/Core/ThreadParker.hpp"
+
+#if defined(PLATFORM_WINDOWS)
+#include "Engine/Core/Win.hpp"
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(PLATFORM_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int) && std::atomic<int>::is_always_lock_free, "ThreadParker waits on the state word's address directly.");
+
+void ThreadParker::Park() {
+    //Fast path: consume a pending token without blocking.
+    if(_state.exchange(State::Empty, std::memory_order_acquire) == State::Notified) {
+        return;
+    }
+    auto expected = State::Empty;
+    if(!_state.compare_exchange_strong(expected, State::Parked, std::memory_order_acq_rel)) {
+        //Unparked between the exchange and announcing the park.
+        _state.exchange(State::Empty, std::memory_order_acquire);
+        return;
+    }
+    _block_count.fetch_add(1u, std::memory_order_relaxed);
+    for(;;) {
+        WaitWhileParked();
+        expected = State::Notified;
+        if(_state.compare_exchange_strong(expected, State::Empty, std::memory_order_acquire)) {
+            return;
+        }
+        //Spurious wakeup, still parked.
+    }
+}
+
+bool ThreadParker::Unpark() {
+    if(_state.exchange(State::Notified, std::memory_order_release) != State::Parked) {
+        return false;
+    }
+    WakeOwner();
+    return true;
+}
+
+std::size_t ThreadParker::GetBlockCount() const {
+    return _block_count.load(std::memory_order_relaxed);
+}
+
+#if defined(PLATFORM_WINDOWS)
+
+void ThreadParker::WaitWhileParked() {
+    auto parked = State::Parked;
+    ::WaitOnAddress(&_state, &parked, sizeof(parked), INFINITE);
+}
+
+void ThreadParker::WakeOwner() {
+    ::WakeByAddressSingle(&_state);
+}
+
+#elif defined(PLATFORM_LINUX)
+
+void ThreadParker::WaitWhileParked() {
+    //Returns at once if Unpark already changed the state; EINTR is a spurious wakeup.
+    ::syscall(SYS_futex, reinterpret_cast<int*>(&_state), FUTEX_WAIT_PRIVATE, static_cast<int>(State::Parked), nullptr, nullptr, 0);
+}
+
+void ThreadParker::WakeOwner() {
+    ::syscall(SYS_futex, reinterpret_cast<int*>(&_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+#else
+
+void ThreadParker::WaitWhileParked() {
+    std::unique_lock<std::mutex> lock(_cs);
+    _signal.wait(lock, [this]() { return _state.load(std::memory_order_acquire) != State::Parked; });
+}
+
+void ThreadParker::WakeOwner() {
+    //Acquiring the lock orders this wakeup after the owner has checked the state and started waiting.
+    { std::scoped_lock<std::mutex> lock(_cs); }
+    _signal.notify_one();
+}
+
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+//Single-owner parking slot with futex-style semantics.
+//Unpark leaves a token; Park consumes it and only blocks when none is available.
+//Unparking a thread that is not parked is one atomic exchange and never enters the kernel.
+//On Windows and Linux the owner blocks on the state word itself (WaitOnAddress, futex), so
+//waking it is one exchange plus one wake call, with no mutex for either side to contend on.
+
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_LINUX)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+class ThreadParker {
+public:
+    ThreadParker() = default;
+    ~ThreadParker() = default;
+
+    ThreadParker(const ThreadParker&) = delete;
+    ThreadParker(ThreadParker&&) = delete;
+    ThreadParker& operator=(const ThreadParker&) = delete;
+    ThreadParker& operator=(ThreadParker&&) = delete;
+
+    //Owner thread only. Returns immediately if a token is already available.
+    void Park();
+    //Any thread. Returns true if the owner was blocked and had to be woken.
+    bool Unpark();
+
+    //Number of times Park actually blocked.
+    std::size_t GetBlockCount() const;
+
+protected:
+private:
+    enum class State : int {
+        Empty,
+        Parked,
+        Notified,
+    };
+
+    //Blocks while _state is Parked; may return spuriously.
+    void WaitWhileParked();
+    void WakeOwner();
+
+    std::atomic<State> _state{ State::Empty };
+    std::atomic<std::size_t> _block_count{ 0u };
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_LINUX)
+    std::mutex _cs{};
+    std::condition_variable _signal{};
+#endif
+};
@@ -11,6 +11,7 @@ public:
 
     void push(const T& t);
     void pop();
+    bool try_pop(T& t);
     decltype(auto) size() const;
     bool empty() const;
 
@@ -44,6 +45,17 @@ void ThreadSafeQueue<T>::pop() {
     _queue.pop();
 }
 
+template<typename T>
+bool ThreadSafeQueue<T>::try_pop(T& t) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    if(_queue.empty()) {
+        return false;
+    }
+    t = _queue.front();
+    _queue.pop();
+    return true;
+}
+
 template<typename T>
 decltype(auto) ThreadSafeQueue<T>::size() const {
     std::scoped_lock<std::mutex> lock(_cs);
@@ -1,19 +1,32 @@
 #include "Engine/Core/TimeUtils.hpp"
 
-#include "Engine/Core/Win.hpp"
+#include "Engine/Core/BuildConfig.hpp"
 
 #include <ctime>
 #include <sstream>
 #include <iomanip>
 
+namespace {
+
+std::tm ToLocalTime(std::time_t t) {
+    std::tm tm{};
+#ifdef PLATFORM_WINDOWS
+    ::localtime_s(&tm, &t);
+#else
+    ::localtime_r(&t, &tm);
+#endif
+    return tm;
+}
+
+} //End anonymous namespace
+
 namespace TimeUtils {
 
 std::string GetDateTimeStampFromNow(const DateTimeStampOptions& options /*= DateTimeStampOptions{}*/) {
     using namespace std::chrono;
     auto now = Now<system_clock>();
     std::time_t t = system_clock::to_time_t(now);
-    std::tm tm;
-    ::localtime_s(&tm, &t);
+    const auto tm = ToLocalTime(t);
     std::stringstream msg;
     std::string fmt = options.use_24_hour_clock ? (options.use_separator ? (options.is_filename ? "%Y-%m-%d_%H%M%S" : "%Y-%m-%d %H:%M:%S") : "%Y%m%d%H%M%S")
                                                 : (options.use_separator ? (options.is_filename ? "%Y-%m-%d_%I%M%S" : "%Y-%m-%d %I:%M:%S") : "%Y%m%d%I%M%S");
@@ -34,8 +47,7 @@ std::string GetTimeStampFromNow(const DateTimeStampOptions& options /*= DateTime
     using namespace std::chrono;
     auto now = Now<system_clock>();
     auto t = system_clock::to_time_t(now);
-    std::tm tm;
-    ::localtime_s(&tm, &t);
+    const auto tm = ToLocalTime(t);
     std::ostringstream msg;
     std::string fmt = options.use_24_hour_clock ? (options.use_separator ? (options.is_filename ? "%H-%M-%S" : "%H:%M:%S") : "%H%M%S")
                                                 : (options.use_separator ? (options.is_filename ? "%I-%M-%S" : "%I:%M:%S") : "%I%M%S");
@@ -56,8 +68,7 @@ std::string GetDateStampFromNow(const DateTimeStampOptions& options /*= DateTime
     using namespace std::chrono;
     auto now = Now<system_clock>();
     auto t = system_clock::to_time_t(now);
-    std::tm tm;
-    ::localtime_s(&tm, &t);
+    const auto tm = ToLocalTime(t);
     std::stringstream msg;
     std::string fmt = options.use_separator ? "%Y-%m-%d" : "%Y%m%d";
     msg << std::put_time(&tm, fmt.c_str());
@@ -0,0 +1,181 @@
+#pragma once
+//Chase-Lev work-stealing deque.
+//"Correct and Efficient Work-Stealing for Weak Memory Models" - Le, Pop, Cohen, Zappa Nardelli [PPoPP 2013]
+//The owning thread pushes and pops at the bottom, any other thread steals from the top.
+//T must be trivially copyable (job pointers).
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+template<typename T>
+class WorkStealingQueue {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingQueue requires a trivially copyable type.");
+
+    explicit WorkStealingQueue(std::size_t initialCapacity = 1024);
+    ~WorkStealingQueue();
+
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue(WorkStealingQueue&&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(WorkStealingQueue&&) = delete;
+
+    //Owner thread only.
+    void push(const T& t);
+    //Owner thread only.
+    bool pop(T& t);
+    //Any thread.
+    bool steal(T& t);
+
+    bool empty() const;
+    std::size_t size() const;
+
+protected:
+private:
+    class CircularArray {
+    public:
+        explicit CircularArray(std::int64_t capacity);
+        ~CircularArray();
+        std::int64_t capacity() const;
+        T get(std::int64_t index) const;
+        void put(std::int64_t index, const T& t);
+        CircularArray* grow(std::int64_t bottom, std::int64_t top) const;
+    private:
+        std::int64_t _capacity = 0;
+        std::int64_t _mask = 0;
+        std::atomic<T>* _data = nullptr;
+    };
+
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> _top{ 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> _bottom{ 0 };
+    alignas(CACHE_LINE_SIZE) std::atomic<CircularArray*> _array{ nullptr };
+    //Thieves may still be reading a retired array; they are freed with the queue.
+    std::vector<CircularArray*> _retired{};
+};
+
+template<typename T>
+WorkStealingQueue<T>::CircularArray::CircularArray(std::int64_t capacity)
+    : _capacity(capacity)
+    , _mask(capacity - 1)
+    , _data(new std::atomic<T>[static_cast<std::size_t>(capacity)])
+{
+    /* DO NOTHING */
+}
+
+template<typename T>
+WorkStealingQueue<T>::CircularArray::~CircularArray() {
+    delete[] _data;
+    _data = nullptr;
+}
+
+template<typename T>
+std::int64_t WorkStealingQueue<T>::CircularArray::capacity() const {
+    return _capacity;
+}
+
+template<typename T>
+T WorkStealingQueue<T>::CircularArray::get(std::int64_t index) const {
+    return _data[index & _mask].load(std::memory_order_relaxed);
+}
+
+template<typename T>
+void WorkStealingQueue<T>::CircularArray::put(std::int64_t index, const T& t) {
+    _data[index & _mask].store(t, std::memory_order_relaxed);
+}
+
+template<typename T>
+typename WorkStealingQueue<T>::CircularArray* WorkStealingQueue<T>::CircularArray::grow(std::int64_t bottom, std::int64_t top) const {
+    auto result = new CircularArray(_capacity * 2);
+    for(auto i = top; i != bottom; ++i) {
+        result->put(i, get(i));
+    }
+    return result;
+}
+
+template<typename T>
+WorkStealingQueue<T>::WorkStealingQueue(std::size_t initialCapacity /*= 1024*/) {
+    std::size_t capacity = 1;
+    while(capacity < initialCapacity) {
+        capacity <<= 1;
+    }
+    _array.store(new CircularArray(static_cast<std::int64_t>(capacity)), std::memory_order_relaxed);
+}
+
+template<typename T>
+WorkStealingQueue<T>::~WorkStealingQueue() {
+    for(auto a : _retired) {
+        delete a;
+    }
+    _retired.clear();
+    delete _array.load();
+}
+
+template<typename T>
+void WorkStealingQueue<T>::push(const T& t) {
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto top = _top.load(std::memory_order_acquire);
+    auto a = _array.load(std::memory_order_relaxed);
+    if(a->capacity() - 1 < b - top) {
+        auto bigger = a->grow(b, top);
+        _retired.push_back(a);
+        a = bigger;
+        _array.store(a, std::memory_order_release);
+    }
+    a->put(b, t);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool WorkStealingQueue<T>::pop(T& t) {
+    auto b = _bottom.load(std::memory_order_relaxed) - 1;
+    auto a = _array.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = _top.load(std::memory_order_relaxed);
+    if(b < top) {
+        //Empty
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    t = a->get(b);
+    if(top == b) {
+        //Last element, race any thieves for it.
+        bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T>
+bool WorkStealingQueue<T>::steal(T& t) {
+    auto top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = _bottom.load(std::memory_order_acquire);
+    if(b <= top) {
+        return false;
+    }
+    auto a = _array.load(std::memory_order_acquire);
+    t = a->get(top);
+    return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool WorkStealingQueue<T>::empty() const {
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto top = _top.load(std::memory_order_relaxed);
+    return b <= top;
+}
+
+template<typename T>
+std::size_t WorkStealingQueue<T>::size() const {
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto top = _top.load(std::memory_order_relaxed);
+    return b <= top ? std::size_t{ 0 } : static_cast<std::size_t>(b - top);
+}
@@ -3,6 +3,7 @@
 #include <cmath>
 
 #include "Engine/Core/Rgba.hpp"
+#include "Engine/Core/Vertex3D.hpp"
 
 #include "Engine/Math/AABB2.hpp"
 #include "Engine/Math/AABB3.hpp"
@@ -14,6 +15,7 @@
 #include "Engine/Math/LineSegment2.hpp"
 #include "Engine/Math/LineSegment3.hpp"
 #include "Engine/Math/Matrix4.hpp"
+#include "Engine/Math/Matrix4Simd.hpp"
 #include "Engine/Math/Plane2.hpp"
 #include "Engine/Math/Plane3.hpp"
 #include "Engine/Math/Quaternion.hpp"
@@ -22,6 +24,11 @@ namespace MathUtils {
 
 namespace {
 static thread_local unsigned int MT_RANDOM_SEED = 0u;
+
+//Vertices per pass, so the copy and the two transform passes over a block stay in L1.
+constexpr std::size_t VERTEX_BLOCK_SIZE = 256u;
+
+static_assert(sizeof(Vector3) == 3u * sizeof(float), "Batch transforms treat Vector3 arrays as packed floats.");
 }
 
 void SetRandomEngineSeed(unsigned int seed) {
@@ -915,6 +922,47 @@ Quaternion SLERP(const Quaternion& a, const Quaternion& b, float t) {
     return (scale0 * start) + (scale1 * end);
 }
 
+void TransformPositions(const Matrix4& transform, const Vector3* positions, Vector3* result, std::size_t count) {
+    if(Matrix4Simd::GetLevel() == Matrix4Simd::Level::Scalar) {
+        for(std::size_t i = 0u; i < count; ++i) {
+            result[i] = transform.TransformPosition(positions[i]);
+        }
+        return;
+    }
+    Matrix4Simd::TransformVector3s(*transform, reinterpret_cast<const float*>(positions), reinterpret_cast<float*>(result), count, sizeof(Vector3), 1.0f);
+}
+
+void TransformDirections(const Matrix4& transform, const Vector3* directions, Vector3* result, std::size_t count) {
+    if(Matrix4Simd::GetLevel() == Matrix4Simd::Level::Scalar) {
+        for(std::size_t i = 0u; i < count; ++i) {
+            result[i] = transform.TransformDirection(directions[i]);
+        }
+        return;
+    }
+    Matrix4Simd::TransformVector3s(*transform, reinterpret_cast<const float*>(directions), reinterpret_cast<float*>(result), count, sizeof(Vector3), 0.0f);
+}
+
+void TransformVertices(const Matrix4& transform, const Vertex3D* vertices, Vertex3D* result, std::size_t count) {
+    if(Matrix4Simd::GetLevel() == Matrix4Simd::Level::Scalar) {
+        for(std::size_t i = 0u; i < count; ++i) {
+            Vertex3D vertex = vertices[i];
+            vertex.position = transform.TransformPosition(vertex.position);
+            vertex.normal = transform.TransformDirection(vertex.normal);
+            result[i] = vertex;
+        }
+        return;
+    }
+    for(std::size_t first = 0u; first < count; first += VERTEX_BLOCK_SIZE) {
+        const auto block_count = (std::min)(VERTEX_BLOCK_SIZE, count - first);
+        auto* block = result + first;
+        if(vertices != result) {
+            std::copy(vertices + first, vertices + first + block_count, block);
+        }
+        Matrix4Simd::TransformVector3s(*transform, &block->position.x, &block->position.x, block_count, sizeof(Vertex3D), 1.0f);
+        Matrix4Simd::TransformVector3s(*transform, &block->normal.x, &block->normal.x, block_count, sizeof(Vertex3D), 0.0f);
+    }
+}
+
 template<>
 Vector2 Clamp<Vector2>(const Vector2& valueToClamp, const Vector2& minRange, const Vector2& maxRange) {
     Vector2 result = valueToClamp;
@@ -1,9 +1,25 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <random>
 #include <utility>
 
+//<cmath> defines these as macros outside MSVC (and on MSVC with _USE_MATH_DEFINES); the constants below replace them.
+#undef M_E
+#undef M_LOG2E
+#undef M_LOG10E
+#undef M_LN2
+#undef M_LN10
+#undef M_PI
+#undef M_PI_2
+#undef M_PI_4
+#undef M_1_PI
+#undef M_2_PI
+#undef M_2_SQRTPI
+#undef M_SQRT2
+
 #include "Engine/Math/IntVector2.hpp"
 #include "Engine/Math/IntVector3.hpp"
 #include "Engine/Math/IntVector4.hpp"
@@ -21,10 +37,12 @@ class LineSegment3;
 class OBB2;
 class Sphere3;
 class Capsule3;
+class Matrix4;
 class Plane2;
 class Plane3;
 class Quaternion;
 class Rgba;
+class Vertex3D;
 
 namespace MathUtils {
 
@@ -259,6 +277,15 @@ float CalculateMatrix2Determinant(float m00, float m01,
 
 Quaternion SLERP(const Quaternion& a, const Quaternion& b, float t);
 
+//Batch forms of Matrix4::TransformPosition and TransformDirection, SIMD where Matrix4Simd is available.
+//result may be the same array as the input, but must not otherwise overlap it.
+void TransformPositions(const Matrix4& transform, const Vector3* positions, Vector3* result, std::size_t count);
+void TransformDirections(const Matrix4& transform, const Vector3* directions, Vector3* result, std::size_t count);
+//Positions as points, normals as directions, the rest copied. Normals are not renormalized,
+//so they are only correct for transforms without non-uniform scale.
+void TransformVertices(const Matrix4& transform, const Vertex3D* vertices, Vertex3D* result, std::size_t count);
+//Parallel forms taking a JobSystem are in Engine/Core/ParallelTransforms.hpp.
+
 template<typename T>
 T Clamp(const T& valueToClamp, const T& minRange, const T& maxRange) {
     if(valueToClamp < minRange) {
@@ -393,6 +420,20 @@ IntVector2 Wrap(const IntVector2& valuesToWrap, const IntVector2& minValues, con
 
 namespace EasingFunctions {
 
+namespace detail {
+
+template<typename T, std::size_t... Is>
+T SmoothStart_helper(const T& t, std::index_sequence<Is...>) {
+    return (((void)Is, t) * ...);
+}
+
+template<typename T, std::size_t... Is>
+T SmoothStop_helper(const T& t, std::index_sequence<Is...>) {
+    return (((void)Is, (1.0f - t)) * ...);
+}
+
+}//detail
+
 template<std::size_t N, typename T>
 T SmoothStart(const T& t) {
     static_assert(std::is_floating_point_v<T>, "SmoothStart requires T to be non-integral.");
@@ -415,20 +456,6 @@ T SmoothStep(const T& t) {
     return Interpolate(SmoothStart<N>(t), SmoothStop<N>(t), 0.5f);
 }
 
-namespace detail {
-
-template<typename T, std::size_t... Is>
-T SmoothStart_helper(const T& t, std::index_sequence<Is...>) {
-    return (((void)Is, t) * ...);
-}
-
-template<typename T, std::size_t... Is>
-T SmoothStop_helper(const T& t, std::index_sequence<Is...>) {
-    return (((void)Is, (1.0f - t)) * ...);
-}
-
-}//detail
-
 } //End EasingFunctions
 
 } //End MathUtils
\ No newline at end of file
@@ -1,9 +1,15 @@
 #include "Engine/Math/Matrix4.hpp"
 
+#include <atomic>
 #include <sstream>
 
 #include "Engine/Math/AABB3.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix4Simd.hpp"
+
+namespace {
+std::atomic_bool g_affine_inverse_detection{ false };
+} //End anonymous namespace
 
 const Matrix4 Matrix4::I{};
 
@@ -438,6 +444,16 @@ void Matrix4::CalculateInverse() {
 
 Matrix4 Matrix4::CalculateInverse(const Matrix4& mat) {
 
+    if(g_affine_inverse_detection.load(std::memory_order_relaxed) && mat.IsAffine()) {
+        return CalculateInverseAffine(mat);
+    }
+
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        Matrix4 result;
+        Matrix4Simd::Inverse(mat.m_indicies.data(), result.m_indicies.data());
+        return result;
+    }
+
     //Minors, Cofactors, Adjugates method.
     //See http://www.mathsisfun.com/algebra/matrix-inverse-minors-cofactors-adjugate.html
 
@@ -480,6 +496,68 @@ Matrix4 Matrix4::CalculateInverse(const Matrix4& mat) {
     return inv_det * adjugate;
 }
 
+void Matrix4::CalculateInverseAffine() {
+    *this = Matrix4::CalculateInverseAffine(*this);
+}
+
+Matrix4 Matrix4::CalculateInverseAffine(const Matrix4& mat) {
+
+    //[A t]^-1   [A^-1 -A^-1*t]
+    //[0 1]    = [0     1     ]
+    //A^-1 is the 3x3 adjugate over the 3x3 determinant.
+
+    const auto& m = mat.m_indicies;
+    const float c00 = m[5] * m[10] - m[6] * m[9];
+    const float c10 = m[6] * m[8] - m[4] * m[10];
+    const float c20 = m[4] * m[9] - m[5] * m[8];
+    const float inv_det = 1.0f / (m[0] * c00 + m[1] * c10 + m[2] * c20);
+
+    const float i00 = c00 * inv_det;
+    const float i01 = (m[2] * m[9] - m[1] * m[10]) * inv_det;
+    const float i02 = (m[1] * m[6] - m[2] * m[5]) * inv_det;
+    const float i10 = c10 * inv_det;
+    const float i11 = (m[0] * m[10] - m[2] * m[8]) * inv_det;
+    const float i12 = (m[2] * m[4] - m[0] * m[6]) * inv_det;
+    const float i20 = c20 * inv_det;
+    const float i21 = (m[1] * m[8] - m[0] * m[9]) * inv_det;
+    const float i22 = (m[0] * m[5] - m[1] * m[4]) * inv_det;
+
+    const float tx = m[3];
+    const float ty = m[7];
+    const float tz = m[11];
+    return Matrix4(i00, i01, i02, -(i00 * tx + i01 * ty + i02 * tz),
+                   i10, i11, i12, -(i10 * tx + i11 * ty + i12 * tz),
+                   i20, i21, i22, -(i20 * tx + i21 * ty + i22 * tz),
+                   0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void Matrix4::CalculateInverseRigid() {
+    *this = Matrix4::CalculateInverseRigid(*this);
+}
+
+Matrix4 Matrix4::CalculateInverseRigid(const Matrix4& mat) {
+
+    //[R t]^-1   [R^T -R^T*t]
+    //[0 1]    = [0     1   ]
+
+    const auto& m = mat.m_indicies;
+    const float tx = m[3];
+    const float ty = m[7];
+    const float tz = m[11];
+    return Matrix4(m[0], m[4], m[8], -(m[0] * tx + m[4] * ty + m[8] * tz),
+                   m[1], m[5], m[9], -(m[1] * tx + m[5] * ty + m[9] * tz),
+                   m[2], m[6], m[10], -(m[2] * tx + m[6] * ty + m[10] * tz),
+                   0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void Matrix4::SetAffineInverseDetection(bool enabled) {
+    g_affine_inverse_detection.store(enabled, std::memory_order_relaxed);
+}
+
+bool Matrix4::IsAffineInverseDetectionEnabled() {
+    return g_affine_inverse_detection.load(std::memory_order_relaxed);
+}
+
 void Matrix4::OrthoNormalizeIKJ() {
     Vector4 i = GetIBasis();
     Vector4 k = GetKBasis();
@@ -550,6 +628,9 @@ bool Matrix4::IsInvertable() const {
 bool Matrix4::IsSingular() const {
     return MathUtils::IsEquivalent(CalculateDeterminant(), 0.0f);
 }
+bool Matrix4::IsAffine() const {
+    return m_indicies[12] == 0.0f && m_indicies[13] == 0.0f && m_indicies[14] == 0.0f && m_indicies[15] == 1.0f;
+}
 void Matrix4::Translate(const Vector2& translation2D) {
     m_indicies[3] += translation2D.x;
     m_indicies[7] += translation2D.y;
@@ -657,6 +738,12 @@ Vector2 Matrix4::TransformPosition(const Vector2& position) const {
 Vector3 Matrix4::TransformPosition(const Vector3& position) const {
     Vector4 v(position.x, position.y, position.z, 1.0f);
 
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        float result[4];
+        Matrix4Simd::Transform(m_indicies.data(), &v.x, result);
+        return Vector3(result[0], result[1], result[2]);
+    }
+
     float x = MathUtils::DotProduct(this->GetXComponents(), v);
     float y = MathUtils::DotProduct(this->GetYComponents(), v);
     float z = MathUtils::DotProduct(this->GetZComponents(), v);
@@ -674,6 +761,12 @@ Vector2 Matrix4::TransformDirection(const Vector2& direction) const {
 Vector3 Matrix4::TransformDirection(const Vector3& direction) const {
     Vector4 v(direction.x, direction.y, direction.z, 0.0f);
 
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        float result[4];
+        Matrix4Simd::Transform(m_indicies.data(), &v.x, result);
+        return Vector3(result[0], result[1], result[2]);
+    }
+
     float x = MathUtils::DotProduct(this->GetXComponents(), v);
     float y = MathUtils::DotProduct(this->GetYComponents(), v);
     float z = MathUtils::DotProduct(this->GetZComponents(), v);
@@ -799,6 +892,12 @@ Vector3 Matrix4::CalcEulerAngles() const {
 
 Matrix4 Matrix4::operator*(const Matrix4& rhs) const {
 
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        Matrix4 result;
+        Matrix4Simd::Multiply(m_indicies.data(), rhs.m_indicies.data(), result.m_indicies.data());
+        return result;
+    }
+
     using namespace MathUtils;
 
     Vector4 myI = this->GetIBasis();
@@ -840,6 +939,11 @@ Matrix4 Matrix4::operator*(float scalar) const {
 }
 
 Vector4 Matrix4::operator*(const Vector4& rhs) const {
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        Vector4 result;
+        Matrix4Simd::Transform(m_indicies.data(), &rhs.x, &result.x);
+        return result;
+    }
     return Vector4(MathUtils::DotProduct(this->GetXComponents(), rhs),
                    MathUtils::DotProduct(this->GetYComponents(), rhs),
                    MathUtils::DotProduct(this->GetZComponents(), rhs),
@@ -864,6 +968,11 @@ Vector2 Matrix4::operator*(const Vector2& rhs) const {
 
 Matrix4& Matrix4::operator*=(const Matrix4& rhs) {
 
+    if(Matrix4Simd::GetLevel() != Matrix4Simd::Level::Scalar) {
+        Matrix4Simd::Multiply(m_indicies.data(), rhs.m_indicies.data(), m_indicies.data());
+        return *this;
+    }
+
     using namespace MathUtils;
 
     Vector4 myI = this->GetIBasis();
@@ -65,6 +65,8 @@ public:
 
     bool IsInvertable() const;
     bool IsSingular() const;
+    //Bottom row is exactly (0, 0, 0, 1): any mix of rotation, scale, shear and translation.
+    bool IsAffine() const;
 
     void CalculateInverse();
     static float CalculateDeterminant(const Matrix4& mat);
@@ -72,6 +74,16 @@ public:
     float CalculateDeterminant();
     static Matrix4 CalculateInverse(const Matrix4& mat);
 
+    //Inverts only the upper 3x3 and the translation; the bottom row is assumed to be (0, 0, 0, 1).
+    void CalculateInverseAffine();
+    static Matrix4 CalculateInverseAffine(const Matrix4& mat);
+    //Transposes the rotation; the upper 3x3 is assumed to be orthonormal, i.e. no scale or shear.
+    void CalculateInverseRigid();
+    static Matrix4 CalculateInverseRigid(const Matrix4& mat);
+    //When enabled, CalculateInverse checks IsAffine and takes the affine path for matrices that pass. Off by default.
+    static void SetAffineInverseDetection(bool enabled);
+    static bool IsAffineInverseDetectionEnabled();
+
     void OrthoNormalizeIKJ();
 
     void Translate(const Vector2& translation2D);
@@ -205,10 +217,11 @@ private:
     //[20 21 22 23] [8   9 10 11]
     //[30 31 32 33] [12 13 14 15]
 
-    std::array<float, 16> m_indicies{ 1.0f, 0.0f, 0.0f, 0.0f,
-                                      0.0f, 1.0f, 0.0f, 0.0f,
-                                      0.0f, 0.0f, 1.0f, 0.0f,
-                                      0.0f, 0.0f, 0.0f, 1.0f };
+    //Aligned for the SSE/AVX kernels in Matrix4Simd.
+    alignas(16) std::array<float, 16> m_indicies{ 1.0f, 0.0f, 0.0f, 0.0f,
+                                                  0.0f, 1.0f, 0.0f, 0.0f,
+                                                  0.0f, 0.0f, 1.0f, 0.0f,
+                                                  0.0f, 0.0f, 0.0f, 1.0f };
 
     friend class Quaternion;
 
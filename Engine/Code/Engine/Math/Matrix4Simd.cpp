@@ -0,0 +1,408 @@
+#include "Engine/Math/Matrix4Simd.hpp"
+
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MATRIX4_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//MSVC accepts any intrinsic anywhere; GCC and Clang need each function marked with the instruction set it uses.
+#if defined(MATRIX4_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MATRIX4_TARGET_SSE4 __attribute__((target("sse4.1")))
+#define MATRIX4_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define MATRIX4_TARGET_SSE4
+#define MATRIX4_TARGET_AVX2
+#endif
+
+namespace {
+
+#ifdef MATRIX4_SIMD_X86
+
+Matrix4Simd::Level DetectLevel() {
+#ifdef _MSC_VER
+    int info[4]{};
+    __cpuid(info, 0);
+    const auto max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if(max_leaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    //The OS must also save the upper halves of the YMM registers.
+    const bool ymm_saved = osxsave && (_xgetbv(0) & 0x6) == 0x6;
+    if(avx && avx2 && fma && ymm_saved) {
+        return Matrix4Simd::Level::Avx2;
+    }
+    return sse41 ? Matrix4Simd::Level::Sse4 : Matrix4Simd::Level::Scalar;
+#else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Matrix4Simd::Level::Avx2;
+    }
+    return __builtin_cpu_supports("sse4.1") ? Matrix4Simd::Level::Sse4 : Matrix4Simd::Level::Scalar;
+#endif
+}
+
+//Lanes X, Y, Z, W of the result come from those lanes of v.
+template<int X, int Y, int Z, int W>
+MATRIX4_TARGET_SSE4 inline __m128 Swizzle(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+//Lanes X and Y of the result come from a, Z and W from b.
+template<int X, int Y, int Z, int W>
+MATRIX4_TARGET_SSE4 inline __m128 Shuffle(__m128 a, __m128 b) {
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+//2x2 matrices packed row-major in one register: a * b.
+MATRIX4_TARGET_SSE4 inline __m128 Mat2Mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+}
+
+//adjugate(a) * b
+MATRIX4_TARGET_SSE4 inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+}
+
+//a * adjugate(b)
+MATRIX4_TARGET_SSE4 inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+}
+
+MATRIX4_TARGET_SSE4 void MultiplySse4(const float* lhs, const float* rhs, float* result) {
+    const auto b0 = _mm_load_ps(rhs);
+    const auto b1 = _mm_load_ps(rhs + 4);
+    const auto b2 = _mm_load_ps(rhs + 8);
+    const auto b3 = _mm_load_ps(rhs + 12);
+    //Each result row is the rhs rows weighted by one lhs row.
+    for(int row = 0; row < 4; ++row) {
+        const auto a = _mm_load_ps(lhs + 4 * row);
+        auto r = _mm_mul_ps(Swizzle<0, 0, 0, 0>(a), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(Swizzle<1, 1, 1, 1>(a), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(Swizzle<2, 2, 2, 2>(a), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(Swizzle<3, 3, 3, 3>(a), b3));
+        _mm_store_ps(result + 4 * row, r);
+    }
+}
+
+MATRIX4_TARGET_SSE4 void TransformSse4(const float* m, const float* v, float* result) {
+    const auto vec = _mm_loadu_ps(v);
+    const auto p0 = _mm_mul_ps(_mm_load_ps(m), vec);
+    const auto p1 = _mm_mul_ps(_mm_load_ps(m + 4), vec);
+    const auto p2 = _mm_mul_ps(_mm_load_ps(m + 8), vec);
+    const auto p3 = _mm_mul_ps(_mm_load_ps(m + 12), vec);
+    //Pairwise sums of pairwise sums leave one row's dot product per lane.
+    _mm_storeu_ps(result, _mm_hadd_ps(_mm_hadd_ps(p0, p1), _mm_hadd_ps(p2, p3)));
+}
+
+//Splits the matrix into 2x2 blocks [A B; C D] and inverts with block adjugates:
+//http://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+MATRIX4_TARGET_SSE4 void InverseSse4(const float* m, float* result) {
+    const auto r0 = _mm_load_ps(m);
+    const auto r1 = _mm_load_ps(m + 4);
+    const auto r2 = _mm_load_ps(m + 8);
+    const auto r3 = _mm_load_ps(m + 12);
+    const auto A = _mm_movelh_ps(r0, r1);
+    const auto B = _mm_movehl_ps(r1, r0);
+    const auto C = _mm_movelh_ps(r2, r3);
+    const auto D = _mm_movehl_ps(r3, r2);
+
+    //(|A| |B| |C| |D|)
+    const auto det_sub = _mm_sub_ps(_mm_mul_ps(Shuffle<0, 2, 0, 2>(r0, r2), Shuffle<1, 3, 1, 3>(r1, r3)),
+                                    _mm_mul_ps(Shuffle<1, 3, 1, 3>(r0, r2), Shuffle<0, 2, 0, 2>(r1, r3)));
+    const auto det_a = Swizzle<0, 0, 0, 0>(det_sub);
+    const auto det_b = Swizzle<1, 1, 1, 1>(det_sub);
+    const auto det_c = Swizzle<2, 2, 2, 2>(det_sub);
+    const auto det_d = Swizzle<3, 3, 3, 3>(det_sub);
+
+    const auto D_C = Mat2AdjMul(D, C);
+    const auto A_B = Mat2AdjMul(A, B);
+    //The inverse is [X Y; Z W] / |M|; these are the adjugates of X, Y, Z and W.
+    auto X_ = _mm_sub_ps(_mm_mul_ps(det_d, A), Mat2Mul(B, D_C));
+    auto W_ = _mm_sub_ps(_mm_mul_ps(det_a, D), Mat2Mul(C, A_B));
+    auto Y_ = _mm_sub_ps(_mm_mul_ps(det_b, C), Mat2MulAdj(D, A_B));
+    auto Z_ = _mm_sub_ps(_mm_mul_ps(det_c, B), Mat2MulAdj(A, D_C));
+
+    //|M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    auto tr = _mm_mul_ps(A_B, Swizzle<0, 2, 1, 3>(D_C));
+    tr = _mm_hadd_ps(tr, tr);
+    tr = _mm_hadd_ps(tr, tr);
+    const auto det_m = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+    const auto r_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+    X_ = _mm_mul_ps(X_, r_det);
+    Y_ = _mm_mul_ps(Y_, r_det);
+    Z_ = _mm_mul_ps(Z_, r_det);
+    W_ = _mm_mul_ps(W_, r_det);
+
+    //Undoes the adjugates and the block packing in one shuffle per row.
+    _mm_store_ps(result, Shuffle<3, 1, 3, 1>(X_, Y_));
+    _mm_store_ps(result + 4, Shuffle<2, 0, 2, 0>(X_, Y_));
+    _mm_store_ps(result + 8, Shuffle<3, 1, 3, 1>(Z_, W_));
+    _mm_store_ps(result + 12, Shuffle<2, 0, 2, 0>(Z_, W_));
+}
+
+//As Swizzle, within each 128-bit half.
+template<int X, int Y, int Z, int W>
+MATRIX4_TARGET_AVX2 inline __m256 Swizzle8(__m256 v) {
+    return _mm256_permute_ps(v, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+MATRIX4_TARGET_AVX2 void MultiplyAvx2(const float* lhs, const float* rhs, float* result) {
+    const auto b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs));
+    const auto b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 4));
+    const auto b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 8));
+    const auto b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 12));
+    //Two lhs rows per register, so two result rows per instruction.
+    const auto a01 = _mm256_loadu_ps(lhs);
+    const auto a23 = _mm256_loadu_ps(lhs + 8);
+    auto r01 = _mm256_mul_ps(Swizzle8<0, 0, 0, 0>(a01), b0);
+    auto r23 = _mm256_mul_ps(Swizzle8<0, 0, 0, 0>(a23), b0);
+    r01 = _mm256_fmadd_ps(Swizzle8<1, 1, 1, 1>(a01), b1, r01);
+    r23 = _mm256_fmadd_ps(Swizzle8<1, 1, 1, 1>(a23), b1, r23);
+    r01 = _mm256_fmadd_ps(Swizzle8<2, 2, 2, 2>(a01), b2, r01);
+    r23 = _mm256_fmadd_ps(Swizzle8<2, 2, 2, 2>(a23), b2, r23);
+    r01 = _mm256_fmadd_ps(Swizzle8<3, 3, 3, 3>(a01), b3, r01);
+    r23 = _mm256_fmadd_ps(Swizzle8<3, 3, 3, 3>(a23), b3, r23);
+    _mm256_storeu_ps(result, r01);
+    _mm256_storeu_ps(result + 8, r23);
+    _mm256_zeroupper();
+}
+
+MATRIX4_TARGET_AVX2 void TransformAvx2(const float* m, const float* v, float* result) {
+    const auto vec = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(v));
+    const auto p01 = _mm256_mul_ps(_mm256_loadu_ps(m), vec);
+    const auto p23 = _mm256_mul_ps(_mm256_loadu_ps(m + 8), vec);
+    //Low half (row 0, row 2), high half (row 1, row 3), then the sums themselves.
+    auto sums = _mm256_hadd_ps(p01, p23);
+    sums = _mm256_hadd_ps(sums, sums);
+    const auto even = _mm256_castps256_ps128(sums);
+    const auto odd = _mm256_extractf128_ps(sums, 1);
+    _mm_storeu_ps(result, _mm_unpacklo_ps(even, odd));
+    _mm256_zeroupper();
+}
+
+//Three-float points, packed or strided, are transformed a column at a time: m * (x, y, z, w) = x*c0 + y*c1 + z*c2 + w*c3.
+struct Columns {
+    __m128 c0;
+    __m128 c1;
+    __m128 c2;
+    __m128 c3w;
+};
+
+MATRIX4_TARGET_SSE4 inline Columns LoadColumns(const float* m, float w) {
+    auto r0 = _mm_load_ps(m);
+    auto r1 = _mm_load_ps(m + 4);
+    auto r2 = _mm_load_ps(m + 8);
+    auto r3 = _mm_load_ps(m + 12);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    return Columns{ r0, r1, r2, _mm_mul_ps(r3, _mm_set1_ps(w)) };
+}
+
+MATRIX4_TARGET_SSE4 inline void StoreVector3(float* result, __m128 v) {
+    _mm_storel_pi(reinterpret_cast<__m64*>(result), v);
+    _mm_store_ss(result + 2, _mm_movehl_ps(v, v));
+}
+
+MATRIX4_TARGET_SSE4 inline void TransformVector3Sse4(const Columns& m, const float* in, float* result) {
+    auto r = _mm_add_ps(_mm_mul_ps(m.c0, _mm_set1_ps(in[0])), m.c3w);
+    r = _mm_add_ps(r, _mm_mul_ps(m.c1, _mm_set1_ps(in[1])));
+    r = _mm_add_ps(r, _mm_mul_ps(m.c2, _mm_set1_ps(in[2])));
+    StoreVector3(result, r);
+}
+
+MATRIX4_TARGET_AVX2 inline void TransformVector3Avx2(const Columns& m, const float* in, float* result) {
+    auto r = _mm_fmadd_ps(m.c0, _mm_set1_ps(in[0]), m.c3w);
+    r = _mm_fmadd_ps(m.c1, _mm_set1_ps(in[1]), r);
+    r = _mm_fmadd_ps(m.c2, _mm_set1_ps(in[2]), r);
+    StoreVector3(result, r);
+}
+
+MATRIX4_TARGET_SSE4 void TransformVector3sSse4(const float* m, const float* in, float* result, std::size_t count, std::size_t stride, float w) {
+    const auto columns = LoadColumns(m, w);
+    std::size_t i = 0u;
+    if(stride == 3u * sizeof(float)) {
+        const auto m00 = _mm_set1_ps(m[0]), m01 = _mm_set1_ps(m[1]), m02 = _mm_set1_ps(m[2]);
+        const auto m10 = _mm_set1_ps(m[4]), m11 = _mm_set1_ps(m[5]), m12 = _mm_set1_ps(m[6]);
+        const auto m20 = _mm_set1_ps(m[8]), m21 = _mm_set1_ps(m[9]), m22 = _mm_set1_ps(m[10]);
+        const auto t0 = _mm_set1_ps(m[3] * w), t1 = _mm_set1_ps(m[7] * w), t2 = _mm_set1_ps(m[11] * w);
+        //Four packed points are three registers: (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3).
+        for(; i + 4u <= count; i += 4u) {
+            const auto a = _mm_loadu_ps(in + 3u * i);
+            const auto b = _mm_loadu_ps(in + 3u * i + 4u);
+            const auto c = _mm_loadu_ps(in + 3u * i + 8u);
+            const auto xs = Shuffle<0, 3, 0, 2>(a, Shuffle<2, 2, 1, 1>(b, c));
+            const auto ys = Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 0, 0>(a, b), Shuffle<3, 3, 2, 2>(b, c));
+            const auto zs = Shuffle<0, 2, 0, 3>(Shuffle<2, 2, 1, 1>(a, b), c);
+            const auto X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, xs), _mm_mul_ps(m01, ys)), _mm_add_ps(_mm_mul_ps(m02, zs), t0));
+            const auto Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, xs), _mm_mul_ps(m11, ys)), _mm_add_ps(_mm_mul_ps(m12, zs), t1));
+            const auto Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, xs), _mm_mul_ps(m21, ys)), _mm_add_ps(_mm_mul_ps(m22, zs), t2));
+            _mm_storeu_ps(result + 3u * i, Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 0, 0>(X, Y), Shuffle<0, 0, 1, 1>(Z, X)));
+            _mm_storeu_ps(result + 3u * i + 4u, Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 1, 1>(Y, Z), Shuffle<2, 2, 2, 2>(X, Y)));
+            _mm_storeu_ps(result + 3u * i + 8u, Shuffle<0, 2, 0, 2>(Shuffle<2, 2, 3, 3>(Z, X), Shuffle<3, 3, 3, 3>(Y, Z)));
+        }
+    }
+    const auto* in_bytes = reinterpret_cast<const unsigned char*>(in);
+    auto* result_bytes = reinterpret_cast<unsigned char*>(result);
+    for(; i < count; ++i) {
+        TransformVector3Sse4(columns, reinterpret_cast<const float*>(in_bytes + i * stride), reinterpret_cast<float*>(result_bytes + i * stride));
+    }
+}
+
+//As Shuffle, within each 128-bit half.
+template<int X, int Y, int Z, int W>
+MATRIX4_TARGET_AVX2 inline __m256 Shuffle8(__m256 a, __m256 b) {
+    return _mm256_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+MATRIX4_TARGET_AVX2 void TransformVector3sAvx2(const float* m, const float* in, float* result, std::size_t count, std::size_t stride, float w) {
+    const auto columns = LoadColumns(m, w);
+    std::size_t i = 0u;
+    if(stride == 3u * sizeof(float)) {
+        const auto m00 = _mm256_set1_ps(m[0]), m01 = _mm256_set1_ps(m[1]), m02 = _mm256_set1_ps(m[2]);
+        const auto m10 = _mm256_set1_ps(m[4]), m11 = _mm256_set1_ps(m[5]), m12 = _mm256_set1_ps(m[6]);
+        const auto m20 = _mm256_set1_ps(m[8]), m21 = _mm256_set1_ps(m[9]), m22 = _mm256_set1_ps(m[10]);
+        const auto t0 = _mm256_set1_ps(m[3] * w), t1 = _mm256_set1_ps(m[7] * w), t2 = _mm256_set1_ps(m[11] * w);
+        //The SSE4 layout with points 0-3 in the low halves and points 4-7 in the high halves.
+        for(; i + 8u <= count; i += 8u) {
+            const auto f0 = _mm256_loadu_ps(in + 3u * i);
+            const auto f1 = _mm256_loadu_ps(in + 3u * i + 8u);
+            const auto f2 = _mm256_loadu_ps(in + 3u * i + 16u);
+            const auto a = _mm256_permute2f128_ps(f0, f1, 0x30);
+            const auto b = _mm256_permute2f128_ps(f0, f2, 0x21);
+            const auto c = _mm256_permute2f128_ps(f1, f2, 0x30);
+            const auto xs = Shuffle8<0, 3, 0, 2>(a, Shuffle8<2, 2, 1, 1>(b, c));
+            const auto ys = Shuffle8<0, 2, 0, 2>(Shuffle8<1, 1, 0, 0>(a, b), Shuffle8<3, 3, 2, 2>(b, c));
+            const auto zs = Shuffle8<0, 2, 0, 3>(Shuffle8<2, 2, 1, 1>(a, b), c);
+            const auto X = _mm256_fmadd_ps(m00, xs, _mm256_fmadd_ps(m01, ys, _mm256_fmadd_ps(m02, zs, t0)));
+            const auto Y = _mm256_fmadd_ps(m10, xs, _mm256_fmadd_ps(m11, ys, _mm256_fmadd_ps(m12, zs, t1)));
+            const auto Z = _mm256_fmadd_ps(m20, xs, _mm256_fmadd_ps(m21, ys, _mm256_fmadd_ps(m22, zs, t2)));
+            const auto ra = Shuffle8<0, 2, 0, 2>(Shuffle8<0, 0, 0, 0>(X, Y), Shuffle8<0, 0, 1, 1>(Z, X));
+            const auto rb = Shuffle8<0, 2, 0, 2>(Shuffle8<1, 1, 1, 1>(Y, Z), Shuffle8<2, 2, 2, 2>(X, Y));
+            const auto rc = Shuffle8<0, 2, 0, 2>(Shuffle8<2, 2, 3, 3>(Z, X), Shuffle8<3, 3, 3, 3>(Y, Z));
+            _mm256_storeu_ps(result + 3u * i, _mm256_permute2f128_ps(ra, rb, 0x20));
+            _mm256_storeu_ps(result + 3u * i + 8u, _mm256_permute2f128_ps(rc, ra, 0x30));
+            _mm256_storeu_ps(result + 3u * i + 16u, _mm256_permute2f128_ps(rb, rc, 0x31));
+        }
+    }
+    const auto* in_bytes = reinterpret_cast<const unsigned char*>(in);
+    auto* result_bytes = reinterpret_cast<unsigned char*>(result);
+    for(; i < count; ++i) {
+        TransformVector3Avx2(columns, reinterpret_cast<const float*>(in_bytes + i * stride), reinterpret_cast<float*>(result_bytes + i * stride));
+    }
+    _mm256_zeroupper();
+}
+
+#else
+
+Matrix4Simd::Level DetectLevel() {
+    return Matrix4Simd::Level::Scalar;
+}
+
+#endif
+
+const Matrix4Simd::Level g_supported_level = DetectLevel();
+//Zero-initialized to Scalar before the dynamic initializer runs.
+std::atomic<Matrix4Simd::Level> g_level{ g_supported_level };
+
+} //End anonymous namespace
+
+namespace Matrix4Simd {
+
+Level GetSupportedLevel() {
+    return g_supported_level;
+}
+
+Level GetLevel() {
+    return g_level.load(std::memory_order_relaxed);
+}
+
+Level SetLevel(Level level) {
+    if(static_cast<int>(level) > static_cast<int>(g_supported_level)) {
+        level = g_supported_level;
+    }
+    g_level.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+void Multiply(const float* lhs, const float* rhs, float* result) {
+#ifdef MATRIX4_SIMD_X86
+    if(GetLevel() == Level::Avx2) {
+        MultiplyAvx2(lhs, rhs, result);
+    } else {
+        MultiplySse4(lhs, rhs, result);
+    }
+#else
+    UNUSED(lhs);
+    UNUSED(rhs);
+    UNUSED(result);
+#endif
+}
+
+void Transform(const float* m, const float* v, float* result) {
+#ifdef MATRIX4_SIMD_X86
+    if(GetLevel() == Level::Avx2) {
+        TransformAvx2(m, v, result);
+    } else {
+        TransformSse4(m, v, result);
+    }
+#else
+    UNUSED(m);
+    UNUSED(v);
+    UNUSED(result);
+#endif
+}
+
+void Inverse(const float* m, float* result) {
+#ifdef MATRIX4_SIMD_X86
+    //Also at Avx2: pairing the blocks in 256-bit registers measured slower and less accurate.
+    InverseSse4(m, result);
+#else
+    UNUSED(m);
+    UNUSED(result);
+#endif
+}
+
+void TransformVector3s(const float* m, const float* in, float* result, std::size_t count, std::size_t stride, float w) {
+#ifdef MATRIX4_SIMD_X86
+    if(GetLevel() == Level::Avx2) {
+        TransformVector3sAvx2(m, in, result, count, stride, w);
+    } else {
+        TransformVector3sSse4(m, in, result, count, stride, w);
+    }
+#else
+    UNUSED(m);
+    UNUSED(in);
+    UNUSED(result);
+    UNUSED(count);
+    UNUSED(stride);
+    UNUSED(w);
+#endif
+}
+
+} //End Matrix4Simd
+
+std::string to_string(const Matrix4Simd::Level& level) {
+    switch(level) {
+    case Matrix4Simd::Level::Scalar:
+        return "Scalar";
+    case Matrix4Simd::Level::Sse4:
+        return "SSE4";
+    case Matrix4Simd::Level::Avx2:
+        return "AVX2";
+    default:
+        return "Unknown";
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+//SIMD kernels behind Matrix4's multiply, transform and general inverse, and MathUtils' batch transforms.
+//Matrices are 16 row-major floats on a 16-byte boundary, as Matrix4 stores them. Results may alias inputs.
+//The level is picked once from CPUID: AVX2 works on two rows per instruction and fuses multiply-adds,
+//SSE4 works one row at a time. CPUs with neither, and non-x86 builds, use Matrix4's scalar code.
+
+#include <cstddef>
+#include <string>
+
+namespace Matrix4Simd {
+
+enum class Level {
+    Scalar
+    ,Sse4
+    ,Avx2
+};
+
+//Best level this CPU and OS support.
+Level GetSupportedLevel();
+//Level Matrix4 uses. Reads Scalar until static initialization of the engine has run.
+Level GetLevel();
+//Clamped to the supported level and returned. For benchmarks and tests that compare paths;
+//not synchronized with Matrix4 math running on other threads.
+Level SetLevel(Level level);
+
+//Call only when GetLevel() is not Scalar.
+void Multiply(const float* lhs, const float* rhs, float* result);
+//result = m * v for one homogeneous vector; v and result need no alignment.
+void Transform(const float* m, const float* v, float* result);
+//Block-wise (2x2 adjugate) inverse, the SSE4 kernel at both levels. Like the scalar inverse, a singular matrix is not detected.
+void Inverse(const float* m, float* result);
+//result[i] = m * (in[i], w) for count three-float points whose starts are stride bytes apart in both
+//arrays, e.g. sizeof(Vector3) or sizeof(Vertex3D). Packed points go 4 (SSE4) or 8 (AVX2) per iteration.
+//result may be in, but must not otherwise overlap it. No alignment is needed.
+void TransformVector3s(const float* m, const float* in, float* result, std::size_t count, std::size_t stride, float w);
+
+} //End Matrix4Simd
+
+std::string to_string(const Matrix4Simd::Level& level);
@@ -0,0 +1,105 @@
+#include "Engine/Memory/FrameArena.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+LinearArena::LinearArena(std::size_t capacity, std::pmr::memory_resource* upstream /*= std::pmr::new_delete_resource()*/)
+    : _upstream(upstream)
+    , _capacity(capacity)
+{
+    GUARANTEE_OR_DIE(_upstream, "LinearArena: upstream resource is null.");
+    if(_capacity) {
+        _block = static_cast<unsigned char*>(_upstream->allocate(_capacity, BLOCK_ALIGNMENT));
+    }
+}
+
+LinearArena::~LinearArena() {
+    ReleaseOverflow();
+    if(_block) {
+        _upstream->deallocate(_block, _capacity, BLOCK_ALIGNMENT);
+        _block = nullptr;
+    }
+}
+
+void LinearArena::Reset() {
+    if(!_overflow.empty()) {
+        const auto needed = _offset + _overflow_bytes;
+        ReleaseOverflow();
+        if(_block) {
+            _upstream->deallocate(_block, _capacity, BLOCK_ALIGNMENT);
+        }
+        _capacity = (std::max)(needed, _capacity * 2u);
+        _block = static_cast<unsigned char*>(_upstream->allocate(_capacity, BLOCK_ALIGNMENT));
+    }
+    _offset = 0u;
+}
+
+std::size_t LinearArena::GetCapacity() const {
+    return _capacity;
+}
+
+std::size_t LinearArena::GetUsedBytes() const {
+    return _offset + _overflow_bytes;
+}
+
+std::size_t LinearArena::GetHighWaterMark() const {
+    return _high_water_mark;
+}
+
+void* LinearArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    const auto base = reinterpret_cast<std::uintptr_t>(_block);
+    const auto aligned = (base + _offset + alignment - 1u) & ~(static_cast<std::uintptr_t>(alignment) - 1u);
+    const auto new_offset = static_cast<std::size_t>(aligned - base) + bytes;
+    if(_block && new_offset <= _capacity) {
+        _offset = new_offset;
+        _high_water_mark = (std::max)(_high_water_mark, GetUsedBytes());
+        return reinterpret_cast<void*>(aligned);
+    }
+    //Out of room this frame. Serve it from upstream and size the block to fit on the next Reset.
+    auto ptr = _upstream->allocate(bytes, alignment);
+    _overflow.push_back(Overflow{ ptr, bytes, alignment });
+    _overflow_bytes += bytes;
+    _high_water_mark = (std::max)(_high_water_mark, GetUsedBytes());
+    return ptr;
+}
+
+void LinearArena::do_deallocate(void* /*ptr*/, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+    /* DO NOTHING */
+}
+
+bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void LinearArena::ReleaseOverflow() {
+    for(auto& overflow : _overflow) {
+        _upstream->deallocate(overflow.ptr, overflow.bytes, overflow.alignment);
+    }
+    _overflow.clear();
+    _overflow_bytes = 0u;
+}
+
+FrameArena::FrameArena(std::size_t bytesPerFrame, std::pmr::memory_resource* upstream /*= std::pmr::new_delete_resource()*/)
+    : _arenas{ { LinearArena{ bytesPerFrame, upstream }, LinearArena{ bytesPerFrame, upstream } } }
+{
+    /* DO NOTHING */
+}
+
+void FrameArena::BeginFrame() {
+    _current = 1u - _current;
+    _arenas[_current].Reset();
+}
+
+LinearArena& FrameArena::GetCurrent() {
+    return _arenas[_current];
+}
+
+const LinearArena& FrameArena::GetCurrent() const {
+    return _arenas[_current];
+}
+
+const LinearArena& FrameArena::GetPrevious() const {
+    return _arenas[1u - _current];
+}
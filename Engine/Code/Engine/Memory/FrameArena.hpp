@@ -0,0 +1,74 @@
+#pragma once
+//Bump allocation for data that lives exactly one or two frames.
+//LinearArena hands out memory by advancing an offset and frees everything at once in Reset.
+//FrameArena double-buffers two of them: a consumer (e.g. a render thread) can still read
+//frame N's allocations while frame N+1 is built in the other arena.
+//Neither is thread-safe; each arena has a single owning thread at a time.
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+class LinearArena : public std::pmr::memory_resource {
+public:
+    explicit LinearArena(std::size_t capacity, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    LinearArena(const LinearArena& other) = delete;
+    LinearArena(LinearArena&& other) = delete;
+    LinearArena& operator=(const LinearArena& rhs) = delete;
+    LinearArena& operator=(LinearArena&& rhs) = delete;
+    virtual ~LinearArena();
+
+    //Releases every allocation. O(1) unless the arena overflowed since the last Reset; then the
+    //overflow is freed and the block grows to fit it, so the next Reset is O(1) again.
+    void Reset();
+
+    std::size_t GetCapacity() const;
+    std::size_t GetUsedBytes() const;
+    //Most bytes in use at once since construction, overflow included.
+    std::size_t GetHighWaterMark() const;
+
+protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    //Individual frees are no-ops; memory comes back on Reset.
+    virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Overflow {
+        void* ptr = nullptr;
+        std::size_t bytes = 0u;
+        std::size_t alignment = 0u;
+    };
+    static constexpr std::size_t BLOCK_ALIGNMENT = 64u;
+
+    void ReleaseOverflow();
+
+    std::pmr::memory_resource* _upstream = nullptr;
+    unsigned char* _block = nullptr;
+    std::size_t _capacity = 0u;
+    std::size_t _offset = 0u;
+    std::vector<Overflow> _overflow{};
+    std::size_t _overflow_bytes = 0u;
+    std::size_t _high_water_mark = 0u;
+};
+
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t bytesPerFrame, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() = default;
+
+    //Switches to the other arena and resets it. Allocations made during frame N stay valid
+    //until BeginFrame starts frame N+2.
+    void BeginFrame();
+
+    LinearArena& GetCurrent();
+    const LinearArena& GetCurrent() const;
+    const LinearArena& GetPrevious() const;
+
+protected:
+private:
+    std::array<LinearArena, 2> _arenas;
+    std::size_t _current = 0u;
+};
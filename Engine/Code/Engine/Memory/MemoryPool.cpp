@@ -0,0 +1,217 @@
+#include "Engine/Memory/MemoryPool.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
+namespace {
+
+std::atomic<std::uint64_t> g_next_pool_id{ 1u };
+
+//Pools that are still alive, by id. Thread caches outlive pools, and ids are never reused,
+//so a cache for a destroyed pool is recognized and dropped instead of touching freed pages.
+struct PoolRegistry {
+    std::mutex cs{};
+    std::unordered_map<std::uint64_t, FixedBlockPool*> pools{};
+};
+
+PoolRegistry& GetPoolRegistry() {
+    //Never destroyed: threads may exit after static destruction has begun.
+    static auto* registry = new PoolRegistry{};
+    return *registry;
+}
+
+std::size_t RoundUpToMultiple(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1u) / multiple * multiple;
+}
+
+} //End anonymous namespace
+
+FixedBlockPool::FixedBlockPool(std::size_t blockSize, std::size_t blockAlignment /*= alignof(std::max_align_t)*/, std::size_t blocksPerPage /*= DEFAULT_BLOCKS_PER_PAGE*/, bool useThreadCache /*= false*/, std::pmr::memory_resource* upstream /*= std::pmr::get_default_resource()*/)
+    : _upstream(upstream)
+    , _page_alignment((std::max)({ blockAlignment, alignof(FreeBlock), alignof(std::max_align_t) }))
+    , _blocks_per_page((std::max)(blocksPerPage, std::size_t{ 1u }))
+    , _id(g_next_pool_id++)
+    , _use_thread_cache(useThreadCache)
+{
+    GUARANTEE_OR_DIE(blockAlignment && !(blockAlignment & (blockAlignment - 1u)), "FixedBlockPool: block alignment must be a power of two.");
+    GUARANTEE_OR_DIE(_upstream, "FixedBlockPool: upstream resource is null.");
+    _block_size = RoundUpToMultiple((std::max)(blockSize, sizeof(FreeBlock)), (std::max)(blockAlignment, alignof(FreeBlock)));
+    //Pages are at least max_align_t aligned, so blocks whose size is a multiple of 16 also
+    //satisfy the default std::pmr alignment even when T itself only needs 8.
+    _block_alignment = (std::min)(_page_alignment, _block_size & (~_block_size + 1u));
+    _batch_size = (std::max)(_blocks_per_page / 4u, std::size_t{ 1u });
+    auto& registry = GetPoolRegistry();
+    std::scoped_lock<std::mutex> lock(registry.cs);
+    registry.pools[_id] = this;
+}
+
+FixedBlockPool::~FixedBlockPool() {
+    {
+        auto& registry = GetPoolRegistry();
+        std::scoped_lock<std::mutex> lock(registry.cs);
+        registry.pools.erase(_id);
+    }
+    for(auto page : _pages) {
+        _upstream->deallocate(page, _block_size * _blocks_per_page, _page_alignment);
+    }
+    _pages.clear();
+    _free_head = nullptr;
+}
+
+void* FixedBlockPool::Allocate() {
+    if(_use_thread_cache) {
+        auto& cache = GetThreadCache();
+        if(!cache.head) {
+            cache.head = TakeBatch(cache.count);
+        }
+        auto block = cache.head;
+        cache.head = block->next;
+        --cache.count;
+        return block;
+    }
+    std::scoped_lock<std::mutex> lock(_cs);
+    if(!_free_head) {
+        AddPage();
+    }
+    auto block = _free_head;
+    _free_head = block->next;
+    return block;
+}
+
+void FixedBlockPool::Deallocate(void* block) {
+    if(!block) {
+        return;
+    }
+    if(!_use_thread_cache) {
+        std::scoped_lock<std::mutex> lock(_cs);
+        _free_head = ::new(block) FreeBlock{ _free_head };
+        return;
+    }
+    auto& cache = GetThreadCache();
+    cache.head = ::new(block) FreeBlock{ cache.head };
+    ++cache.count;
+    if(cache.count < 2u * _batch_size) {
+        return;
+    }
+    //Keep one batch warm, hand the other back.
+    auto batch_head = cache.head;
+    auto batch_tail = batch_head;
+    for(std::size_t i = 1; i < _batch_size; ++i) {
+        batch_tail = batch_tail->next;
+    }
+    cache.head = batch_tail->next;
+    cache.count -= _batch_size;
+    batch_tail->next = nullptr;
+    GiveBatch(batch_head, batch_tail);
+}
+
+std::size_t FixedBlockPool::GetBlockSize() const {
+    return _block_size;
+}
+
+std::size_t FixedBlockPool::GetBlockAlignment() const {
+    return _block_alignment;
+}
+
+std::size_t FixedBlockPool::GetPageCount() const {
+    std::scoped_lock<std::mutex> lock(_cs);
+    return _pages.size();
+}
+
+void* FixedBlockPool::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if(bytes <= _block_size && alignment <= _block_alignment) {
+        return Allocate();
+    }
+    return _upstream->allocate(bytes, alignment);
+}
+
+void FixedBlockPool::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    if(bytes <= _block_size && alignment <= _block_alignment) {
+        Deallocate(ptr);
+        return;
+    }
+    _upstream->deallocate(ptr, bytes, alignment);
+}
+
+bool FixedBlockPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+FixedBlockPool::ThreadCache& FixedBlockPool::GetThreadCache() {
+    thread_local ThreadCacheList list{};
+    auto& caches = list.caches;
+    if(list.last_hit < caches.size() && caches[list.last_hit].pool_id == _id) {
+        return caches[list.last_hit];
+    }
+    for(std::size_t i = 0; i < caches.size(); ++i) {
+        if(caches[i].pool_id == _id) {
+            list.last_hit = i;
+            return caches[i];
+        }
+    }
+    //First use on this thread. Drop caches of pools destroyed since; their blocks are gone.
+    {
+        auto& registry = GetPoolRegistry();
+        std::scoped_lock<std::mutex> lock(registry.cs);
+        caches.erase(std::remove_if(std::begin(caches), std::end(caches), [&registry](const ThreadCache& cache) {
+            return registry.pools.find(cache.pool_id) == std::end(registry.pools);
+        }), std::end(caches));
+    }
+    ThreadCache cache{};
+    cache.pool_id = _id;
+    caches.push_back(cache);
+    list.last_hit = caches.size() - 1u;
+    return caches.back();
+}
+
+FixedBlockPool::FreeBlock* FixedBlockPool::TakeBatch(std::size_t& count) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    if(!_free_head) {
+        AddPage();
+    }
+    auto head = _free_head;
+    auto tail = head;
+    count = 1u;
+    while(count < _batch_size && tail->next) {
+        tail = tail->next;
+        ++count;
+    }
+    _free_head = tail->next;
+    tail->next = nullptr;
+    return head;
+}
+
+void FixedBlockPool::GiveBatch(FreeBlock* head, FreeBlock* tail) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    tail->next = _free_head;
+    _free_head = head;
+}
+
+void FixedBlockPool::AddPage() {
+    auto page = static_cast<unsigned char*>(_upstream->allocate(_block_size * _blocks_per_page, _page_alignment));
+    _pages.push_back(page);
+    for(std::size_t i = _blocks_per_page; i > 0; --i) {
+        _free_head = ::new(page + (i - 1u) * _block_size) FreeBlock{ _free_head };
+    }
+}
+
+FixedBlockPool::ThreadCacheList::~ThreadCacheList() {
+    auto& registry = GetPoolRegistry();
+    std::scoped_lock<std::mutex> lock(registry.cs);
+    for(auto& cache : caches) {
+        auto found = registry.pools.find(cache.pool_id);
+        if(found != std::end(registry.pools) && cache.head) {
+            auto tail = cache.head;
+            while(tail->next) {
+                tail = tail->next;
+            }
+            found->second->GiveBatch(cache.head, tail);
+        }
+        cache.head = nullptr;
+        cache.count = 0u;
+    }
+    caches.clear();
+}
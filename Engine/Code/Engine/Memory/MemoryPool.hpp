@@ -1,62 +1,154 @@
 #pragma once
+//Fixed-size block allocators.
+//FixedBlockPool hands out blocks of a single size from an intrusive free list in O(1),
+//accepts frees in any order, and grows one page of blocks at a time from an upstream
+//std::pmr::memory_resource. Requests that do not fit a block are forwarded to upstream,
+//so a pool can back any pmr container whose nodes are block-sized.
 
 #include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
 
-template<typename T, std::size_t maxSize>
-class MemoryPool {
+class FixedBlockPool : public std::pmr::memory_resource {
 public:
-	MemoryPool();
-	~MemoryPool();
+    static constexpr std::size_t DEFAULT_BLOCKS_PER_PAGE = 256u;
 
-    [[nodiscard]] void* allocate(std::size_t size);
-    void deallocate(void* ptr, std::size_t size);
+    //With useThreadCache each thread keeps up to two batches (a quarter page each) of free blocks
+    //and only takes the pool's lock to exchange a whole batch.
+    explicit FixedBlockPool(std::size_t blockSize, std::size_t blockAlignment = alignof(std::max_align_t), std::size_t blocksPerPage = DEFAULT_BLOCKS_PER_PAGE, bool useThreadCache = false, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    FixedBlockPool(const FixedBlockPool& other) = delete;
+    FixedBlockPool(FixedBlockPool&& other) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool& rhs) = delete;
+    FixedBlockPool& operator=(FixedBlockPool&& rhs) = delete;
+    virtual ~FixedBlockPool();
+
+    [[nodiscard]] void* Allocate();
+    void Deallocate(void* block);
+
+    //Bytes a node-based pmr container (std::pmr::list, std::pmr::map...) requests per inserted element,
+    //measured once by inserting a default-constructed element. Node layouts differ between standard
+    //libraries, so pools backing such containers are sized from this instead of a guess.
+    template<typename Container>
+    static std::size_t GetNodeSize();
+
+    std::size_t GetBlockSize() const;
+    //Alignment every block is guaranteed to have; at least the requested alignment.
+    std::size_t GetBlockAlignment() const;
+    std::size_t GetPageCount() const;
 
 protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
 private:
+    struct FreeBlock {
+        FreeBlock* next = nullptr;
+    };
+    struct ThreadCache {
+        std::uint64_t pool_id = 0u;
+        FreeBlock* head = nullptr;
+        std::size_t count = 0u;
+    };
+    //Every pool's cache for one thread. Returns the blocks to pools that are still alive on thread exit.
+    struct ThreadCacheList {
+        std::vector<ThreadCache> caches{};
+        std::size_t last_hit = 0u;
+        ~ThreadCacheList();
+    };
 
-    std::size_t _count = 0;
-    std::size_t _max = 0;
-    T* _data = nullptr;
-    T* _ptr = nullptr;
+    ThreadCache& GetThreadCache();
+    FreeBlock* TakeBatch(std::size_t& count);
+    //head..tail must already be linked.
+    void GiveBatch(FreeBlock* head, FreeBlock* tail);
+    void AddPage();
+
+    std::pmr::memory_resource* _upstream = nullptr;
+    std::size_t _block_size = 0u;
+    std::size_t _block_alignment = 0u;
+    std::size_t _page_alignment = 0u;
+    std::size_t _blocks_per_page = 0u;
+    std::size_t _batch_size = 0u;
+    std::uint64_t _id = 0u;
+    bool _use_thread_cache = false;
+    mutable std::mutex _cs{};
+    FreeBlock* _free_head = nullptr;
+    std::vector<void*> _pages{};
 };
 
-template<typename T, std::size_t maxSize>
-[[nodiscard]] void* MemoryPool<T, maxSize>::allocate(std::size_t size) {
-    std::size_t elems = size / sizeof(T);
-    if(_count + elems < _max) {
-        auto front = _ptr;
-        _count += elems;
-        _ptr += _count;
-        return reinterpret_cast<void*>(front);
-    }
-    return nullptr;
+template<typename Container>
+std::size_t FixedBlockPool::GetNodeSize() {
+    //Records the size of the most recent request and forwards it to the heap.
+    class NodeSizeProbe : public std::pmr::memory_resource {
+    public:
+        std::size_t last_bytes = 0u;
+    protected:
+        virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            last_bytes = bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+        virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+    static const std::size_t node_size = []() {
+        NodeSizeProbe probe{};
+        Container container{ &probe };
+        //Skip anything the empty container allocated, such as a sentinel node or debug proxy.
+        probe.last_bytes = 0u;
+        container.emplace(std::end(container));
+        return probe.last_bytes;
+    }();
+    return node_size;
 }
 
-template<typename T, std::size_t maxSize>
-void MemoryPool<T, maxSize>::deallocate(void* ptr, std::size_t size) {
-    auto elems = static_cast<int>(size / sizeof(T));
-    if(0 < _count - elems) {
-        _ptr -= elems;
-        _count -= elems;
-    } else {
-        _ptr = _data;
-        _count = 0;
-    }
+//A FixedBlockPool sized for T.
+//allocate/deallocate (from std::pmr::memory_resource) hand out raw blocks; Create/Destroy construct in place.
+template<typename T, std::size_t blocksPerPage = FixedBlockPool::DEFAULT_BLOCKS_PER_PAGE>
+class MemoryPool : public FixedBlockPool {
+public:
+    explicit MemoryPool(bool useThreadCache = false, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    virtual ~MemoryPool() = default;
+
+    template<typename... Args>
+    [[nodiscard]] T* Create(Args&&... args);
+    void Destroy(T* ptr);
+
+protected:
+private:
+};
+
+template<typename T, std::size_t blocksPerPage>
+MemoryPool<T, blocksPerPage>::MemoryPool(bool useThreadCache /*= false*/, std::pmr::memory_resource* upstream /*= std::pmr::get_default_resource()*/)
+    : FixedBlockPool(sizeof(T), alignof(T), blocksPerPage, useThreadCache, upstream)
+{
+    /* DO NOTHING */
 }
 
-template<typename T, std::size_t maxSize>
-MemoryPool<T, maxSize>::~MemoryPool() {
-    std::free(_data);
-    _data = nullptr;
-    _ptr = nullptr;
-    _count = 0;
-    _max = 0;
+template<typename T, std::size_t blocksPerPage>
+template<typename... Args>
+[[nodiscard]] T* MemoryPool<T, blocksPerPage>::Create(Args&&... args) {
+    auto block = Allocate();
+    try {
+        return ::new(block) T(std::forward<Args>(args)...);
+    } catch(...) {
+        Deallocate(block);
+        throw;
+    }
 }
 
-template<typename T, std::size_t maxSize>
-MemoryPool<T, maxSize>::MemoryPool() {
-    _data = reinterpret_cast<T*>(std::malloc(maxSize * sizeof(T)));
-    _ptr = _data;
-    _count = 0;
-    _max = maxSize;
+template<typename T, std::size_t blocksPerPage>
+void MemoryPool<T, blocksPerPage>::Destroy(T* ptr) {
+    if(!ptr) {
+        return;
+    }
+    ptr->~T();
+    Deallocate(ptr);
 }
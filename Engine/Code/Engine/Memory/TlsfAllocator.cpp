@@ -0,0 +1,346 @@
+#include "Engine/Memory/TlsfAllocator.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+//Bit scans for the free-list bitmaps. value is never 0: callers check their maps first.
+std::size_t FindFirstSet(std::uint32_t value) {
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return static_cast<std::size_t>(__builtin_ctz(value));
+#endif
+}
+
+std::size_t FindLastSet(std::size_t value) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return index;
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return index;
+#else
+    return sizeof(unsigned long long) * CHAR_BIT - 1u - static_cast<std::size_t>(__builtin_clzll(value));
+#endif
+}
+
+std::uintptr_t AlignUp(std::uintptr_t value, std::size_t alignment) {
+    return (value + alignment - 1u) & ~(static_cast<std::uintptr_t>(alignment) - 1u);
+}
+
+} //End anonymous namespace
+
+double TlsfAllocator::FragmentationReport::Fragmentation() const {
+    if(!free_bytes) {
+        return 0.0;
+    }
+    return 1.0 - static_cast<double>(largest_free_block) / static_cast<double>(free_bytes);
+}
+
+std::ostream& operator<<(std::ostream& out, const TlsfAllocator::FragmentationReport& report) {
+    const auto old_flags = out.flags();
+    const auto old_precision = out.precision();
+    out << std::left << std::setw(25) << "Pools:" << std::right << std::setw(25) << report.pool_count << '\n';
+    out << std::left << std::setw(25) << "Pool bytes:" << std::right << std::setw(25) << report.pool_bytes << '\n';
+    out << std::left << std::setw(25) << "Used bytes:" << std::right << std::setw(25) << report.used_bytes << '\n';
+    out << std::left << std::setw(25) << "Used blocks:" << std::right << std::setw(25) << report.used_block_count << '\n';
+    out << std::left << std::setw(25) << "Free bytes:" << std::right << std::setw(25) << report.free_bytes << '\n';
+    out << std::left << std::setw(25) << "Free blocks:" << std::right << std::setw(25) << report.free_block_count << '\n';
+    out << std::left << std::setw(25) << "Largest free block:" << std::right << std::setw(25) << report.largest_free_block << '\n';
+    out << std::left << std::setw(25) << "Fragmentation:" << std::right << std::setw(24) << std::fixed << std::setprecision(1) << report.Fragmentation() * 100.0 << "%\n";
+    out.flags(old_flags);
+    out.precision(old_precision);
+    return out;
+}
+
+TlsfAllocator::TlsfAllocator(std::size_t poolSize /*= DEFAULT_POOL_SIZE*/, bool growable /*= true*/)
+    : _pool_size(AlignUp((std::max)(poolSize, MIN_BLOCK_SIZE), ALIGNMENT))
+    , _growable(growable)
+{
+    GUARANTEE_OR_DIE(_pool_size < MAX_BLOCK_SIZE, "TlsfAllocator: pool size is larger than the largest block.");
+    std::scoped_lock<std::mutex> lock(_cs);
+    GUARANTEE_OR_DIE(AddPool(MIN_BLOCK_SIZE), "TlsfAllocator: could not allocate the initial pool.");
+}
+
+TlsfAllocator::~TlsfAllocator() {
+    auto* pool = _pools;
+    while(pool) {
+        auto* next = pool->next;
+        std::free(pool->raw);
+        pool = next;
+    }
+    _pools = nullptr;
+}
+
+void* TlsfAllocator::Allocate(std::size_t bytes) {
+    return Allocate(bytes, ALIGNMENT);
+}
+
+void* TlsfAllocator::Allocate(std::size_t bytes, std::size_t alignment) {
+    if(alignment & (alignment - 1u)) {
+        return nullptr;
+    }
+    alignment = (std::max)(alignment, ALIGNMENT);
+    //Leaves room for the header, rounding and an alignment gap without overflowing.
+    if(bytes >= MAX_BLOCK_SIZE / 2u || alignment >= MAX_BLOCK_SIZE / 4u) {
+        return nullptr;
+    }
+    const auto block_size = (std::max)(static_cast<std::size_t>(AlignUp(bytes + HEADER_SIZE, ALIGNMENT)), MIN_BLOCK_SIZE);
+    std::scoped_lock<std::mutex> lock(_cs);
+    return AllocateBlock(block_size, alignment);
+}
+
+void TlsfAllocator::Deallocate(void* ptr) {
+    if(!ptr) {
+        return;
+    }
+    std::scoped_lock<std::mutex> lock(_cs);
+    auto* block = GetBlock(ptr);
+    block->size |= FREE_BIT;
+    //Neighbors in the free lists are never adjacent, so one merge each way restores that.
+    if(auto* prev = block->prev_phys; prev && IsFree(prev)) {
+        RemoveFreeBlock(prev);
+        prev->size += GetSize(block);
+        block = prev;
+    }
+    if(auto* next = GetNextPhys(block); IsFree(next)) {
+        RemoveFreeBlock(next);
+        block->size += GetSize(next);
+    }
+    GetNextPhys(block)->prev_phys = block;
+    InsertFreeBlock(block);
+}
+
+std::size_t TlsfAllocator::GetAllocationSize(const void* ptr) const {
+    if(!ptr) {
+        return 0u;
+    }
+    return GetSize(GetBlock(ptr)) - HEADER_SIZE;
+}
+
+TlsfAllocator::FragmentationReport TlsfAllocator::GetFragmentationReport() const {
+    FragmentationReport report{};
+    std::scoped_lock<std::mutex> lock(_cs);
+    for(auto* pool = _pools; pool; pool = pool->next) {
+        ++report.pool_count;
+        report.pool_bytes += pool->size;
+        auto* base = reinterpret_cast<unsigned char*>(pool);
+        const auto* sentinel = reinterpret_cast<const Block*>(base + pool->size - HEADER_SIZE);
+        for(auto* block = reinterpret_cast<const Block*>(base + POOL_HEADER_SIZE); block != sentinel; block = GetNextPhys(block)) {
+            const auto size = GetSize(block);
+            if(IsFree(block)) {
+                ++report.free_block_count;
+                report.free_bytes += size;
+                report.largest_free_block = (std::max)(report.largest_free_block, size);
+            } else {
+                ++report.used_block_count;
+                report.used_bytes += size;
+            }
+        }
+    }
+    return report;
+}
+
+void* TlsfAllocator::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if(auto ptr = Allocate(bytes, alignment)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void TlsfAllocator::do_deallocate(void* ptr, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+    Deallocate(ptr);
+}
+
+bool TlsfAllocator::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+std::size_t TlsfAllocator::GetSize(const Block* block) {
+    return block->size & ~FREE_BIT;
+}
+
+bool TlsfAllocator::IsFree(const Block* block) {
+    return (block->size & FREE_BIT) != 0u;
+}
+
+TlsfAllocator::Block* TlsfAllocator::GetNextPhys(const Block* block) {
+    return reinterpret_cast<Block*>(reinterpret_cast<std::uintptr_t>(block) + GetSize(block));
+}
+
+void* TlsfAllocator::GetPayload(const Block* block) {
+    return reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(block) + HEADER_SIZE);
+}
+
+TlsfAllocator::Block* TlsfAllocator::GetBlock(const void* payload) {
+    return reinterpret_cast<Block*>(reinterpret_cast<std::uintptr_t>(payload) - HEADER_SIZE);
+}
+
+void TlsfAllocator::Map(std::size_t size, std::size_t& fl, std::size_t& sl) {
+    if(size < SMALL_BLOCK_SIZE) {
+        fl = 0u;
+        sl = size >> ALIGNMENT_LOG2;
+        return;
+    }
+    const auto last_set = FindLastSet(size);
+    sl = (size >> (last_set - SL_COUNT_LOG2)) ^ SL_COUNT;
+    fl = last_set - (FL_SHIFT - 1u);
+}
+
+void* TlsfAllocator::AllocateBlock(std::size_t blockSize, std::size_t alignment) {
+    //Room to move the payload up to the alignment, leaving a gap big enough to be a free block.
+    const auto gap_allowance = alignment > ALIGNMENT ? alignment + MIN_BLOCK_SIZE : 0u;
+    const auto search_size = blockSize + gap_allowance;
+    auto* block = FindFreeBlock(search_size);
+    if(!block) {
+        if(!_growable || !AddPool(search_size)) {
+            return nullptr;
+        }
+        block = FindFreeBlock(search_size);
+        if(!block) {
+            return nullptr;
+        }
+    }
+    RemoveFreeBlock(block);
+    if(gap_allowance) {
+        const auto payload = reinterpret_cast<std::uintptr_t>(GetPayload(block));
+        auto aligned = AlignUp(payload, alignment);
+        if(aligned != payload && aligned - payload < MIN_BLOCK_SIZE) {
+            aligned = AlignUp(payload + MIN_BLOCK_SIZE, alignment);
+        }
+        if(const auto gap = static_cast<std::size_t>(aligned - payload)) {
+            auto* aligned_block = reinterpret_cast<Block*>(reinterpret_cast<std::uintptr_t>(block) + gap);
+            aligned_block->size = GetSize(block) - gap;
+            aligned_block->prev_phys = block;
+            GetNextPhys(aligned_block)->prev_phys = aligned_block;
+            block->size = gap | FREE_BIT;
+            InsertFreeBlock(block);
+            block = aligned_block;
+        }
+    }
+    TrimBack(block, blockSize);
+    block->size &= ~FREE_BIT;
+    return GetPayload(block);
+}
+
+TlsfAllocator::Block* TlsfAllocator::FindFreeBlock(std::size_t size) {
+    //Round up to the next list start so any block in the list found is big enough.
+    if(size >= SMALL_BLOCK_SIZE) {
+        size += (std::size_t{ 1u } << (FindLastSet(size) - SL_COUNT_LOG2)) - 1u;
+    }
+    std::size_t fl = 0u;
+    std::size_t sl = 0u;
+    Map(size, fl, sl);
+    if(fl >= FL_COUNT) {
+        return nullptr;
+    }
+    auto sl_map = _sl_bitmap[fl] & (~0u << sl);
+    if(!sl_map) {
+        if(fl + 1u >= FL_COUNT) {
+            return nullptr;
+        }
+        const auto fl_map = _fl_bitmap & (~0u << (fl + 1u));
+        if(!fl_map) {
+            return nullptr;
+        }
+        fl = FindFirstSet(fl_map);
+        sl_map = _sl_bitmap[fl];
+    }
+    sl = FindFirstSet(sl_map);
+    return _free_lists[fl][sl];
+}
+
+void TlsfAllocator::InsertFreeBlock(Block* block) {
+    std::size_t fl = 0u;
+    std::size_t sl = 0u;
+    Map(GetSize(block), fl, sl);
+    auto*& head = _free_lists[fl][sl];
+    block->next_free = head;
+    block->prev_free = nullptr;
+    if(head) {
+        head->prev_free = block;
+    }
+    head = block;
+    _fl_bitmap |= 1u << fl;
+    _sl_bitmap[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFreeBlock(Block* block) {
+    std::size_t fl = 0u;
+    std::size_t sl = 0u;
+    Map(GetSize(block), fl, sl);
+    auto*& head = _free_lists[fl][sl];
+    if(block->prev_free) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        head = block->next_free;
+    }
+    if(block->next_free) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if(!head) {
+        _sl_bitmap[fl] &= ~(1u << sl);
+        if(!_sl_bitmap[fl]) {
+            _fl_bitmap &= ~(1u << fl);
+        }
+    }
+}
+
+void TlsfAllocator::TrimBack(Block* block, std::size_t size) {
+    const auto total = GetSize(block);
+    if(total - size < MIN_BLOCK_SIZE) {
+        return;
+    }
+    auto* rest = reinterpret_cast<Block*>(reinterpret_cast<std::uintptr_t>(block) + size);
+    rest->size = (total - size) | FREE_BIT;
+    rest->prev_phys = block;
+    GetNextPhys(rest)->prev_phys = rest;
+    block->size = size | (block->size & FREE_BIT);
+    InsertFreeBlock(rest);
+}
+
+bool TlsfAllocator::AddPool(std::size_t minBlockSize) {
+    //A block of exactly minBlockSize can sit one list below where FindFreeBlock rounds up to.
+    const auto headroom = (minBlockSize >> SL_COUNT_LOG2) + ALIGNMENT;
+    const auto block_size = static_cast<std::size_t>(AlignUp((std::max)(_pool_size, minBlockSize + headroom), ALIGNMENT));
+    if(block_size >= MAX_BLOCK_SIZE) {
+        return false;
+    }
+    const auto pool_size = POOL_HEADER_SIZE + block_size + HEADER_SIZE;
+    auto* raw = std::malloc(pool_size + ALIGNMENT);
+    if(!raw) {
+        return false;
+    }
+    const auto base = AlignUp(reinterpret_cast<std::uintptr_t>(raw), ALIGNMENT);
+    auto* pool = ::new(reinterpret_cast<void*>(base)) Pool{};
+    pool->next = _pools;
+    pool->size = pool_size;
+    pool->raw = raw;
+    _pools = pool;
+
+    auto* block = ::new(reinterpret_cast<void*>(base + POOL_HEADER_SIZE)) Block{};
+    block->size = block_size | FREE_BIT;
+    block->prev_phys = nullptr;
+    //Never free, so nothing coalesces past the end of the pool.
+    //Only the header fields exist here; the sentinel has no payload.
+    auto* sentinel = GetNextPhys(block);
+    sentinel->size = HEADER_SIZE;
+    sentinel->prev_phys = block;
+    InsertFreeBlock(block);
+    return true;
+}
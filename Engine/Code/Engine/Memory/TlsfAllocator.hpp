@@ -0,0 +1,121 @@
+#pragma once
+//Two-Level Segregated Fit allocator (Masmano, Ripoll, Crespo, Real; ECRTS 2004).
+//Free blocks are binned by size into FL_COUNT power-of-two classes, each split into SL_COUNT
+//linear sub-classes. Two bitmaps find a non-empty bin with one bit scan each, so Allocate and
+//Deallocate are O(1) with immediate coalescing and no search loops. The only unbounded step is
+//growing: when no free block fits, a new pool is taken from the system. Size the initial pool
+//for the working set to keep that off the frame.
+//Thread-safe; every call takes the allocator's one lock, so threads allocating from the same instance
+//serialize on it. As the MEMORY_BACKEND_TLSF backend for the TRACK_MEMORY operator new overrides that
+//lock is process-wide; see TlsfAllocator/Replace/*/Threads:N in MicroBenchmarks for what it costs
+//against malloc as threads are added. Give busy threads their own instance instead of sharing one.
+//Pools come from std::malloc, never operator new, so the allocator can back those overrides.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <ostream>
+
+class TlsfAllocator : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t ALIGNMENT = 16u;
+    static constexpr std::size_t DEFAULT_POOL_SIZE = 16u * 1024u * 1024u;
+
+    struct FragmentationReport {
+        std::size_t pool_count = 0u;
+        std::size_t pool_bytes = 0u;
+        std::size_t used_bytes = 0u;
+        std::size_t used_block_count = 0u;
+        std::size_t free_bytes = 0u;
+        std::size_t free_block_count = 0u;
+        std::size_t largest_free_block = 0u;
+        //1 - largest free block / free bytes: 0 when all free memory is one block.
+        double Fragmentation() const;
+        friend std::ostream& operator<<(std::ostream& out, const FragmentationReport& report);
+    };
+
+    //With growable false, Allocate returns nullptr once the first pool is exhausted.
+    explicit TlsfAllocator(std::size_t poolSize = DEFAULT_POOL_SIZE, bool growable = true);
+    TlsfAllocator(const TlsfAllocator& other) = delete;
+    TlsfAllocator(TlsfAllocator&& other) = delete;
+    TlsfAllocator& operator=(const TlsfAllocator& rhs) = delete;
+    TlsfAllocator& operator=(TlsfAllocator&& rhs) = delete;
+    virtual ~TlsfAllocator();
+
+    //ALIGNMENT-aligned. nullptr when out of memory.
+    [[nodiscard]] void* Allocate(std::size_t bytes);
+    [[nodiscard]] void* Allocate(std::size_t bytes, std::size_t alignment);
+    void Deallocate(void* ptr);
+
+    //Usable bytes at ptr; at least what was requested.
+    std::size_t GetAllocationSize(const void* ptr) const;
+    //Walks every block: O(blocks), not for per-frame use.
+    FragmentationReport GetFragmentationReport() const;
+
+protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    struct Block {
+        //Total bytes including this header. Bit 0 is set while the block is free.
+        std::size_t size = 0u;
+        //Block physically before this one in its pool; null for the first block.
+        Block* prev_phys = nullptr;
+        //Free blocks only; overlaps the payload of used blocks.
+        Block* next_free = nullptr;
+        Block* prev_free = nullptr;
+    };
+    //Sits at the start of each pool, followed by its blocks and an end sentinel.
+    struct Pool {
+        Pool* next = nullptr;
+        //Bytes from the Pool header through the end sentinel.
+        std::size_t size = 0u;
+        //What std::malloc returned, before alignment.
+        void* raw = nullptr;
+    };
+
+    static constexpr std::size_t ALIGNMENT_LOG2 = 4u;
+    static constexpr std::size_t SL_COUNT_LOG2 = 5u;
+    static constexpr std::size_t SL_COUNT = std::size_t{ 1u } << SL_COUNT_LOG2;
+    static constexpr std::size_t FL_SHIFT = SL_COUNT_LOG2 + ALIGNMENT_LOG2;
+    static constexpr std::size_t FL_MAX = sizeof(std::size_t) == 8u ? 40u : 30u;
+    static constexpr std::size_t FL_COUNT = FL_MAX - FL_SHIFT + 1u;
+    //Sizes below this all map to first level 0, in ALIGNMENT steps.
+    static constexpr std::size_t SMALL_BLOCK_SIZE = std::size_t{ 1u } << FL_SHIFT;
+    //size and prev_phys; the payload starts right after.
+    static constexpr std::size_t HEADER_SIZE = ALIGNMENT;
+    static constexpr std::size_t MIN_BLOCK_SIZE = 2u * ALIGNMENT;
+    static constexpr std::size_t POOL_HEADER_SIZE = (sizeof(Pool) + ALIGNMENT - 1u) / ALIGNMENT * ALIGNMENT;
+    static constexpr std::size_t MAX_BLOCK_SIZE = std::size_t{ 1u } << (FL_MAX - 1u);
+    static constexpr std::size_t FREE_BIT = 1u;
+
+    static_assert(FL_COUNT <= 32u, "First-level bitmap is 32 bits.");
+    static_assert(2u * sizeof(void*) <= HEADER_SIZE && sizeof(Block) <= MIN_BLOCK_SIZE, "Block header does not fit.");
+
+    static std::size_t GetSize(const Block* block);
+    static bool IsFree(const Block* block);
+    static Block* GetNextPhys(const Block* block);
+    static void* GetPayload(const Block* block);
+    static Block* GetBlock(const void* payload);
+    static void Map(std::size_t size, std::size_t& fl, std::size_t& sl);
+
+    void* AllocateBlock(std::size_t blockSize, std::size_t alignment);
+    Block* FindFreeBlock(std::size_t size);
+    void InsertFreeBlock(Block* block);
+    void RemoveFreeBlock(Block* block);
+    //Splits off and frees everything past size, if the remainder can hold a block.
+    void TrimBack(Block* block, std::size_t size);
+    bool AddPool(std::size_t minBlockSize);
+
+    mutable std::mutex _cs{};
+    std::uint32_t _fl_bitmap = 0u;
+    std::array<std::uint32_t, FL_COUNT> _sl_bitmap{};
+    std::array<std::array<Block*, SL_COUNT>, FL_COUNT> _free_lists{};
+    Pool* _pools = nullptr;
+    std::size_t _pool_size = 0u;
+    bool _growable = true;
+};
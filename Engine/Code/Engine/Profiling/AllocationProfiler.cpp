@@ -0,0 +1,235 @@
+#include "Engine/Profiling/AllocationProfiler.hpp"
+
+#include "Engine/Profiling/StackTrace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+std::atomic_bool AllocationProfiler::_enabled{ false };
+std::atomic<std::uint32_t> AllocationProfiler::_sample_mask{ AllocationProfiler::DEFAULT_SAMPLE_INTERVAL - 1u };
+std::atomic<std::uint16_t> AllocationProfiler::_generation{ 0u };
+thread_local std::uint32_t AllocationProfiler::_sample_counter = 0u;
+thread_local bool AllocationProfiler::_suspended = false;
+
+struct AllocationProfiler::SuspendScope {
+    SuspendScope() noexcept : _previous(_suspended) { _suspended = true; }
+    ~SuspendScope() noexcept { _suspended = _previous; }
+    bool _previous = false;
+};
+
+namespace {
+
+//Frames inside RecordAllocation, Memory::allocate and operator new.
+constexpr unsigned long FRAMES_TO_SKIP = 3ul;
+constexpr unsigned long MAX_SITE_FRAMES = 16ul;
+//Deeper frames are usually the same engine plumbing for every site.
+constexpr std::size_t MAX_REPORTED_FRAMES = 6u;
+
+//The map is written from inside operator new, so its nodes must not come from operator new.
+template<typename T>
+struct MallocAllocator {
+    using value_type = T;
+    MallocAllocator() noexcept = default;
+    template<typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {}
+    T* allocate(std::size_t n) {
+        if(auto ptr = std::malloc(n * sizeof(T))) {
+            return static_cast<T*>(ptr);
+        }
+        throw std::bad_alloc{};
+    }
+    void deallocate(T* ptr, std::size_t /*n*/) noexcept {
+        std::free(ptr);
+    }
+    template<typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const MallocAllocator<U>&) const noexcept { return false; }
+};
+
+struct Site {
+    std::uint32_t hash = 0u;
+    unsigned long frame_count = 0ul;
+    std::array<void*, MAX_SITE_FRAMES> frames{};
+    std::atomic<std::uint64_t> alloc_count{ 0u };
+    std::atomic<std::uint64_t> alloc_bytes{ 0u };
+    std::atomic<std::uint64_t> free_count{ 0u };
+    std::atomic<std::uint64_t> free_bytes{ 0u };
+};
+
+using site_map_t = std::unordered_map<std::uint32_t, Site*, std::hash<std::uint32_t>, std::equal_to<std::uint32_t>, MallocAllocator<std::pair<const std::uint32_t, Site*>>>;
+
+struct Shard {
+    std::shared_mutex cs{};
+    site_map_t sites{};
+};
+
+constexpr std::size_t SHARD_COUNT = 64u;
+using shards_t = std::array<Shard, SHARD_COUNT>;
+
+shards_t& GetShards() {
+    //Never destroyed: frees keep arriving during static destruction.
+    static auto* shards = ::new(std::malloc(sizeof(shards_t))) shards_t{};
+    return *shards;
+}
+
+Shard& GetShard(std::uint32_t hash) {
+    return GetShards()[hash % SHARD_COUNT];
+}
+
+Site* FindSite(Shard& shard, std::uint32_t hash) {
+    std::shared_lock<std::shared_mutex> lock(shard.cs);
+    auto found = shard.sites.find(hash);
+    return found != std::end(shard.sites) ? found->second : nullptr;
+}
+
+std::uint64_t SaturatingSubtract(std::uint64_t a, std::uint64_t b) {
+    return a > b ? a - b : 0u;
+}
+
+const char* GetSortKeyName(AllocationProfiler::SortKey key) {
+    switch(key) {
+    case AllocationProfiler::SortKey::Bytes:       return "bytes allocated";
+    case AllocationProfiler::SortKey::Count:       return "allocation count";
+    case AllocationProfiler::SortKey::LeakedBytes: return "leaked bytes";
+    default:                                       return "unknown";
+    }
+}
+
+} //End anonymous namespace
+
+void AllocationProfiler::Enable(bool enable) {
+    _enabled = enable;
+}
+
+void AllocationProfiler::SetSampleInterval(std::uint32_t interval) {
+    std::uint32_t rounded = 1u;
+    while(rounded < interval && rounded < 0x80000000u) {
+        rounded <<= 1;
+    }
+    _sample_mask = rounded - 1u;
+}
+
+std::uint32_t AllocationProfiler::GetSampleInterval() {
+    return _sample_mask + 1u;
+}
+
+std::uint32_t AllocationProfiler::RecordAllocation(std::size_t bytes) {
+    SuspendScope suspend{};
+    std::array<void*, MAX_SITE_FRAMES> frames{};
+    unsigned long stack_hash = 0ul;
+    const auto frame_count = StackTrace::CaptureFrames(FRAMES_TO_SKIP, MAX_SITE_FRAMES, frames.data(), &stack_hash);
+    //0 marks an allocation that was not recorded.
+    const auto hash = static_cast<std::uint32_t>(stack_hash) ? static_cast<std::uint32_t>(stack_hash) : 1u;
+    auto& shard = GetShard(hash);
+    auto* site = FindSite(shard, hash);
+    if(!site) {
+        std::unique_lock<std::shared_mutex> lock(shard.cs);
+        auto& slot = shard.sites[hash];
+        if(!slot) {
+            auto* raw = std::malloc(sizeof(Site));
+            if(!raw) {
+                shard.sites.erase(hash);
+                return 0u;
+            }
+            slot = ::new(raw) Site{};
+            slot->hash = hash;
+            slot->frame_count = (std::min)(frame_count, MAX_SITE_FRAMES);
+            std::copy_n(std::begin(frames), slot->frame_count, std::begin(slot->frames));
+        }
+        site = slot;
+    }
+    site->alloc_count.fetch_add(1u, std::memory_order_relaxed);
+    site->alloc_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return hash;
+}
+
+void AllocationProfiler::RecordFree(std::uint32_t siteHash, std::size_t bytes, std::uint16_t generation) {
+    //The site's counters were zeroed after this allocation was charged to them.
+    if(generation != GetGeneration()) {
+        return;
+    }
+    if(auto* site = FindSite(GetShard(siteHash), siteHash)) {
+        site->free_count.fetch_add(1u, std::memory_order_relaxed);
+        site->free_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+AllocationProfiler::Report AllocationProfiler::GetReport(SortKey sortKey, std::size_t topN) {
+    SuspendScope suspend{};
+    Report report{};
+    report.sort_key = sortKey;
+    report.sample_interval = GetSampleInterval();
+    std::vector<SiteStats> sites{};
+    for(auto& shard : GetShards()) {
+        std::shared_lock<std::shared_mutex> lock(shard.cs);
+        for(const auto& [hash, site] : shard.sites) {
+            SiteStats stats{};
+            stats.hash = hash;
+            stats.alloc_count = site->alloc_count.load(std::memory_order_relaxed);
+            stats.alloc_bytes = site->alloc_bytes.load(std::memory_order_relaxed);
+            stats.leaked_count = SaturatingSubtract(stats.alloc_count, site->free_count.load(std::memory_order_relaxed));
+            stats.leaked_bytes = SaturatingSubtract(stats.alloc_bytes, site->free_bytes.load(std::memory_order_relaxed));
+            if(!stats.alloc_count) {
+                continue;
+            }
+            stats.frames.assign(std::begin(site->frames), std::begin(site->frames) + site->frame_count);
+            sites.push_back(std::move(stats));
+        }
+    }
+    report.site_count = sites.size();
+    auto key = [sortKey](const SiteStats& stats) {
+        switch(sortKey) {
+        case SortKey::Count:       return stats.alloc_count;
+        case SortKey::LeakedBytes: return stats.leaked_bytes;
+        case SortKey::Bytes:
+        default:                   return stats.alloc_bytes;
+        }
+    };
+    const auto n = (std::min)(topN, sites.size());
+    std::partial_sort(std::begin(sites), std::begin(sites) + n, std::end(sites), [&key](const SiteStats& a, const SiteStats& b) { return key(a) > key(b); });
+    sites.resize(n);
+    for(auto& site : sites) {
+        const auto frame_count = (std::min)(site.frames.size(), MAX_REPORTED_FRAMES);
+        for(std::size_t i = 0; i < frame_count; ++i) {
+            site.symbols.push_back(StackTrace::ResolveFrame(site.frames[i]));
+        }
+    }
+    report.sites = std::move(sites);
+    return report;
+}
+
+void AllocationProfiler::Reset() {
+    _generation.fetch_add(1u, std::memory_order_relaxed);
+    for(auto& shard : GetShards()) {
+        std::shared_lock<std::shared_mutex> lock(shard.cs);
+        for(auto& [hash, site] : shard.sites) {
+            site->alloc_count = 0u;
+            site->alloc_bytes = 0u;
+            site->free_count = 0u;
+            site->free_bytes = 0u;
+        }
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const AllocationProfiler::Report& report) {
+    out << "Top " << report.sites.size() << " of " << report.site_count << " call sites by " << GetSortKeyName(report.sort_key);
+    out << " (recording 1 in " << report.sample_interval << " allocations)\n";
+    for(const auto& site : report.sites) {
+        out << std::setw(12) << site.alloc_bytes << " bytes" << std::setw(10) << site.alloc_count << " allocs";
+        out << std::setw(12) << site.leaked_bytes << " leaked bytes" << std::setw(10) << site.leaked_count << " leaked";
+        out << "  [0x" << std::hex << std::setw(8) << std::setfill('0') << site.hash << std::setfill(' ') << std::dec << "]\n";
+        for(const auto& symbol : site.symbols) {
+            out << "\t" << symbol << '\n';
+        }
+    }
+    return out;
+}
@@ -0,0 +1,97 @@
+#pragma once
+//Call-site attribution for tracked allocations (TRACK_MEMORY builds).
+//While enabled, a sampled allocation captures its return addresses with StackTrace::CaptureFrames
+//and is charged to the call site keyed by that stack's hash. Memory stores the hash in the
+//allocation's header, with the current Reset generation, so the matching free is charged to the same
+//site without a lookup by pointer, and skipped if the site has been reset since.
+//Call sites live in a sharded concurrent map; only the first allocation from a site takes a shard's
+//exclusive lock. Symbols are resolved only when a report is printed, and cached by StackTrace.
+
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Console;
+
+class AllocationProfiler {
+public:
+    enum class SortKey {
+        Bytes
+        ,Count
+        ,LeakedBytes
+    };
+
+    struct SiteStats {
+        std::uint32_t hash = 0u;
+        std::uint64_t alloc_count = 0u;
+        std::uint64_t alloc_bytes = 0u;
+        //Allocated while enabled and not yet freed.
+        std::uint64_t leaked_count = 0u;
+        std::uint64_t leaked_bytes = 0u;
+        std::vector<void*> frames{};
+        //The top frames, resolved when the report is built.
+        std::vector<std::string> symbols{};
+    };
+
+    struct Report {
+        SortKey sort_key = SortKey::Bytes;
+        std::size_t site_count = 0u;
+        std::uint32_t sample_interval = 1u;
+        //At most the requested N, best first.
+        std::vector<SiteStats> sites{};
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    static void Enable(bool enable);
+    static bool IsEnabled();
+    //True for one allocation in every sample interval on this thread while enabled.
+    static bool ShouldRecord();
+    //Rounded up to a power of two.
+    static void SetSampleInterval(std::uint32_t interval);
+    static std::uint32_t GetSampleInterval();
+
+    //Returns the call-site hash to keep with the allocation; never 0.
+    static std::uint32_t RecordAllocation(std::size_t bytes);
+    //generation is GetGeneration() from when the allocation was recorded; frees from before
+    //the last Reset are ignored.
+    static void RecordFree(std::uint32_t siteHash, std::size_t bytes, std::uint16_t generation);
+    //Advanced by every Reset; kept with each recorded allocation.
+    static std::uint16_t GetGeneration();
+
+    static Report GetReport(SortKey sortKey, std::size_t topN);
+    //Zeroes every site. Frees of allocations made before the reset are ignored.
+    static void Reset();
+
+    //allocsites [on|off|reset|sample N|bytes N|count N|leaks N]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    static constexpr std::uint32_t DEFAULT_SAMPLE_INTERVAL = 1u;
+
+    static std::atomic_bool _enabled;
+    static std::atomic<std::uint32_t> _sample_mask;
+    static std::atomic<std::uint16_t> _generation;
+    static thread_local std::uint32_t _sample_counter;
+    //Set while the profiler itself allocates, so its own work is never recorded.
+    static thread_local bool _suspended;
+
+    struct SuspendScope;
+};
+
+//Inline: these run on every tracked allocation.
+inline bool AllocationProfiler::IsEnabled() {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline std::uint16_t AllocationProfiler::GetGeneration() {
+    return _generation.load(std::memory_order_relaxed);
+}
+
+inline bool AllocationProfiler::ShouldRecord() {
+    return IsEnabled() && !_suspended && (++_sample_counter & _sample_mask.load(std::memory_order_relaxed)) == 0u;
+}
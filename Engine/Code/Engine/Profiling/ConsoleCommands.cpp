@@ -0,0 +1,387 @@
+//Console commands of the profiling systems.
+//Kept apart from the systems themselves so tools that build the profilers without the Console can link them.
+
+#include "Engine/Core/ArgumentParser.hpp"
+#include "Engine/Core/Console.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/TimeUtils.hpp"
+
+#include "Engine/Profiling/AllocationProfiler.hpp"
+#include "Engine/Profiling/FrameStats.hpp"
+#include "Engine/Profiling/JobInstrumentation.hpp"
+#include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/MemoryBudgets.hpp"
+#include "Engine/Profiling/Profiler.hpp"
+#include "Engine/Profiling/SamplingProfiler.hpp"
+#include "Engine/Profiling/TraceExporter.hpp"
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+void Profiler::RegisterConsoleCommands(Console& console) {
+    Console::Command profile{};
+    profile.command_name = "profile";
+    profile.help_text_short = "Displays the per-thread scope tree of recent frames.";
+    profile.help_text_long = "profile [on|off|reset|avg N]: Enables, disables or clears the frame profiler. With no argument, displays the last frame's scope tree; with avg N, the average of the last N frames.";
+    profile.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        std::size_t frame_count = 1u;
+        if(arg_set >> arg) {
+            arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+            if(arg == "on") {
+                Enable(true);
+                console.PrintMsg("Frame profiler enabled.");
+                return;
+            } else if(arg == "off") {
+                Enable(false);
+                console.PrintMsg("Frame profiler disabled.");
+                return;
+            } else if(arg == "reset") {
+                Reset();
+                console.PrintMsg("Frame profiler reset.");
+                return;
+            } else if(arg == "avg") {
+                unsigned int count = 0u;
+                //Without a count, every kept frame; GetAverage clamps to the history.
+                frame_count = (arg_set >> count) && count ? count : (std::numeric_limits<std::size_t>::max)();
+            } else {
+                console.WarnMsg("profile: unknown argument \'" + arg + "\'.");
+                return;
+            }
+        }
+        if(!IsEnabled()) {
+            console.WarnMsg("The frame profiler is disabled. Use \'profile on\'.");
+        }
+        std::ostringstream ss;
+        ss << GetAverage(frame_count);
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(profile);
+}
+
+void JobInstrumentation::RegisterConsoleCommands(Console& console) {
+    Console::Command jobstats{};
+    jobstats.command_name = "jobstats";
+    jobstats.help_text_short = "Displays job queue depth, wait and run times per job type.";
+    jobstats.help_text_long = "jobstats [on|off|reset|sample N]: Enables, disables or clears job instrumentation, or records one job in every N. With no argument, displays the collected statistics.";
+    jobstats.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        if(arg_set >> arg) {
+            arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+            if(arg == "on") {
+                Enable(true);
+                console.PrintMsg("Job instrumentation enabled.");
+            } else if(arg == "off") {
+                Enable(false);
+                console.PrintMsg("Job instrumentation disabled.");
+            } else if(arg == "reset") {
+                Reset();
+                console.PrintMsg("Job instrumentation reset.");
+            } else if(arg == "sample") {
+                unsigned int interval = 0u;
+                if(arg_set >> interval) {
+                    SetSampleInterval(interval);
+                }
+                console.PrintMsg("Recording one job in every " + std::to_string(GetSampleInterval()) + '.');
+            } else {
+                console.WarnMsg("jobstats: unknown argument \'" + arg + "\'.");
+            }
+            return;
+        }
+        if(!IsEnabled()) {
+            console.WarnMsg("Job instrumentation is disabled. Use \'jobstats on\'.");
+        }
+        std::ostringstream ss;
+        ss << GetReport();
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(jobstats);
+}
+
+void AllocationProfiler::RegisterConsoleCommands(Console& console) {
+    Console::Command allocsites{};
+    allocsites.command_name = "allocsites";
+    allocsites.help_text_short = "Displays the call sites that allocate or leak the most memory.";
+    allocsites.help_text_long = "allocsites [on|off|reset|sample N|bytes N|count N|leaks N]: Enables, disables or clears call-site recording, or records one allocation in every N. Otherwise displays the top N (default 10) call sites by bytes allocated, allocation count, or bytes not yet freed.";
+    allocsites.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        SortKey key = SortKey::Bytes;
+        if(arg_set >> arg) {
+            arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+            if(arg == "on") {
+                Enable(true);
+                console.PrintMsg("Allocation call-site recording enabled.");
+                return;
+            } else if(arg == "off") {
+                Enable(false);
+                console.PrintMsg("Allocation call-site recording disabled.");
+                return;
+            } else if(arg == "reset") {
+                Reset();
+                console.PrintMsg("Allocation call sites reset.");
+                return;
+            } else if(arg == "sample") {
+                unsigned int interval = 0u;
+                if(arg_set >> interval) {
+                    SetSampleInterval(interval);
+                }
+                console.PrintMsg("Recording one allocation in every " + std::to_string(GetSampleInterval()) + '.');
+                return;
+            } else if(arg == "bytes") {
+                key = SortKey::Bytes;
+            } else if(arg == "count") {
+                key = SortKey::Count;
+            } else if(arg == "leaks") {
+                key = SortKey::LeakedBytes;
+            } else {
+                console.WarnMsg("allocsites: unknown argument \'" + arg + "\'.");
+                return;
+            }
+        }
+        unsigned int count = 10u;
+        arg_set >> count;
+        if(!IsEnabled()) {
+            console.WarnMsg("Allocation call-site recording is disabled. Use \'allocsites on\'.");
+        }
+        std::ostringstream ss;
+        ss << GetReport(key, count);
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(allocsites);
+}
+
+void Memory::register_console_commands(Console& console) {
+    Console::Command memtimeline{};
+    memtimeline.command_name = "memtimeline";
+    memtimeline.help_text_short = "Displays or saves per-frame allocation churn.";
+    memtimeline.help_text_long = "memtimeline [N|csv [file]]: Displays the last N (default 10) frames' allocations, frees and peak working set, or writes every frame in the timeline to file (default Data/Stats/MemoryTimeline.csv). Frames with allocation spikes stand out in the bytes column.";
+    memtimeline.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        if(arg_set >> arg) {
+            arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+            if(arg == "csv") {
+                std::string path{};
+                if(!(arg_set >> path)) {
+                    path = "Data/Stats/MemoryTimeline.csv";
+                }
+                if(write_timeline_csv(path)) {
+                    console.PrintMsg("Memory timeline written to " + path);
+                } else {
+                    console.WarnMsg("memtimeline: could not write \'" + path + "\'.");
+                }
+                return;
+            }
+        }
+        unsigned int count = 10;
+        if(!arg.empty()) {
+            ArgumentParser count_arg(arg);
+            if(!(count_arg >> count)) {
+                console.WarnMsg("memtimeline: unknown argument \'" + arg + "\'.");
+                return;
+            }
+        }
+        const auto frames = timeline();
+        const auto first = frames.size() > count ? frames.size() - count : std::size_t{ 0 };
+        std::ostringstream ss;
+        ss << std::right << std::setw(10) << "Frame" << std::setw(10) << "Allocs" << std::setw(14) << "Alloc bytes"
+           << std::setw(10) << "Frees" << std::setw(14) << "Free bytes" << std::setw(14) << "Live bytes" << std::setw(16) << "Peak working set" << '\n';
+        for(auto i = first; i < frames.size(); ++i) {
+            const auto& frame = frames[i];
+            ss << std::setw(10) << frame.frame_id << std::setw(10) << frame.allocs << std::setw(14) << frame.alloc_bytes
+               << std::setw(10) << frame.frees << std::setw(14) << frame.free_bytes << std::setw(14) << frame.live_bytes << std::setw(16) << frame.peak_working_set << '\n';
+        }
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(memtimeline);
+}
+
+void MemoryBudgets::RegisterConsoleCommands(Console& console) {
+    Console::Command membudget{};
+    membudget.command_name = "membudget";
+    membudget.help_text_short = "Displays or sets per-tag memory budgets.";
+    membudget.help_text_long = "membudget [tag soft hard]: With no arguments, displays each tag's live, peak and budgeted bytes. Otherwise sets the tag's soft and hard budgets in bytes, with an optional KB, MB or GB suffix; 0 removes a budget.";
+    membudget.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string tag_name{};
+        if(arg_set >> tag_name) {
+            MemoryTag tag = MemoryTag::General;
+            if(!ParseTag(StringUtils::TrimWhitespace(tag_name), tag)) {
+                console.WarnMsg("membudget: unknown tag \'" + tag_name + "\'.");
+                return;
+            }
+            std::string soft{};
+            std::string hard{};
+            Budget budget{};
+            if(!(arg_set >> soft) || !(arg_set >> hard) || !ParseByteCount(soft, budget.soft_bytes) || !ParseByteCount(hard, budget.hard_bytes)) {
+                console.WarnMsg("membudget: expected a soft and a hard budget, e.g. \'membudget renderer 384MB 512MB\'.");
+                return;
+            }
+            SetBudget(tag, budget);
+            console.PrintMsg("Budgets for " + to_string(tag) + " set.");
+            return;
+        }
+        std::ostringstream ss;
+        ss << GetReport();
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(membudget);
+}
+
+void FrameStats::RegisterConsoleCommands(Console& console) {
+    Console::Command framestats{};
+    framestats.command_name = "framestats";
+    framestats.help_text_short = "Displays, resets or saves frame, update and render time percentiles.";
+    framestats.help_text_long = "framestats [reset|csv [file]]: With no arguments, displays frame, update and render time percentiles since the last reset. reset clears them. csv appends them to file (default Data/Stats/FrameStats.csv) for regression tracking.";
+    framestats.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        if(arg_set >> arg) {
+            arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+            if(arg == "reset") {
+                Reset();
+                console.PrintMsg("Frame statistics reset.");
+            } else if(arg == "csv") {
+                std::string path{};
+                if(!(arg_set >> path)) {
+                    path = "Data/Stats/FrameStats.csv";
+                }
+                if(AppendCsv(path)) {
+                    console.PrintMsg("Frame statistics appended to " + path);
+                } else {
+                    console.WarnMsg("framestats: could not write \'" + path + "\'.");
+                }
+            } else {
+                console.WarnMsg("framestats: unknown argument \'" + arg + "\'.");
+            }
+            return;
+        }
+        std::ostringstream ss;
+        ss << GetReport();
+        for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+            console.PrintMsg(line);
+        }
+    };
+    console.RegisterCommand(framestats);
+}
+
+void SamplingProfiler::RegisterConsoleCommands(Console& console) {
+    Console::Command sampler{};
+    sampler.command_name = "sampler";
+    sampler.help_text_short = "Samples CPU call stacks to find hot code without profiler scopes.";
+    sampler.help_text_long = "sampler [start [hz]|stop [file]|reset|flat [N]|collapsed [file]]: Starts sampling every thread's call stack hz times per CPU second (default 1000), or stops and writes the collapsed stacks to file (default Data/Profiles/<timestamp>.folded) for flamegraph.pl or speedscope. With no arguments or flat, displays the top N (default 20) functions by self samples. Linux profile builds only.";
+    sampler.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        unsigned int count = 20u;
+        const auto print_report = [&console](std::size_t topN) {
+            std::ostringstream ss;
+            ss << GetReport(topN);
+            for(const auto& line : StringUtils::Split(ss.str(), '\n')) {
+                console.PrintMsg(line);
+            }
+        };
+        const auto write_collapsed = [&console, &arg_set]() {
+            std::string path{};
+            if(!(arg_set >> path)) {
+                TimeUtils::DateTimeStampOptions opts{};
+                opts.use_separator = true;
+                opts.is_filename = true;
+                path = "Data/Profiles/" + TimeUtils::GetDateTimeStampFromNow(opts) + ".folded";
+            }
+            if(WriteCollapsedStacks(path)) {
+                console.PrintMsg("Collapsed stacks written to " + path);
+            } else {
+                console.WarnMsg("sampler: could not write \'" + path + "\'.");
+            }
+        };
+        if(!(arg_set >> arg)) {
+            print_report(count);
+            return;
+        }
+        arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+        if(arg == "start") {
+            unsigned int frequency = DEFAULT_FREQUENCY_HZ;
+            arg_set >> frequency;
+            if(Start(frequency)) {
+                console.PrintMsg("Sampling profiler started.");
+            } else {
+                console.WarnMsg(IsRunning() ? "sampler: already running." : "sampler: not supported in this build.");
+            }
+        } else if(arg == "stop") {
+            if(!IsRunning()) {
+                console.WarnMsg("sampler: not running.");
+                return;
+            }
+            Stop();
+            write_collapsed();
+            print_report(count);
+        } else if(arg == "reset") {
+            Reset();
+            console.PrintMsg("Sampling profile reset.");
+        } else if(arg == "flat") {
+            arg_set >> count;
+            print_report(count);
+        } else if(arg == "collapsed") {
+            write_collapsed();
+        } else {
+            console.WarnMsg("sampler: unknown argument \'" + arg + "\'.");
+        }
+    };
+    console.RegisterCommand(sampler);
+}
+
+void TraceExporter::RegisterConsoleCommands(Console& console) {
+    Console::Command trace{};
+    trace.command_name = "trace";
+    trace.help_text_short = "Captures a Chrome/Perfetto trace of frames, profiler scopes and jobs.";
+    trace.help_text_long = "trace [start [file]|stop]: Starts streaming a trace-event JSON capture to file (default Data/Traces/<timestamp>.json), or stops and closes it. Open the file in chrome://tracing or ui.perfetto.dev.";
+    trace.command_function = [&console](const std::string& args)->void {
+        ArgumentParser arg_set(args);
+        std::string arg{};
+        if(!(arg_set >> arg)) {
+            console.PrintMsg(IsCapturing() ? "Trace capture running." : "No trace capture running.");
+            return;
+        }
+        arg = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(arg));
+        if(arg == "start") {
+            std::string path{};
+            if(!(arg_set >> path)) {
+                TimeUtils::DateTimeStampOptions opts{};
+                opts.use_separator = true;
+                opts.is_filename = true;
+                path = "Data/Traces/" + TimeUtils::GetDateTimeStampFromNow(opts) + ".json";
+            }
+            if(Start(path)) {
+                console.PrintMsg("Trace capture started: " + path);
+            } else {
+                console.WarnMsg("trace: could not start a capture to \'" + path + "\'.");
+            }
+        } else if(arg == "stop") {
+            if(!IsCapturing()) {
+                console.WarnMsg("trace: no capture running.");
+                return;
+            }
+            Stop();
+            console.PrintMsg("Trace capture stopped.");
+        } else {
+            console.WarnMsg("trace: unknown argument \'" + arg + "\'.");
+        }
+    };
+    console.RegisterCommand(trace);
+}
@@ -0,0 +1,235 @@
+#include "Engine/Profiling/FrameStats.hpp"
+
+#include "Engine/Core/FileUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+std::array<FrameStats::Histogram, static_cast<std::size_t>(FrameStats::Metric::Max)> FrameStats::_histograms{};
+std::atomic<std::int64_t> FrameStats::_last_mark{ 0 };
+
+namespace {
+
+constexpr std::uint64_t HALF_SUB_BUCKET_COUNT = FrameStats::Histogram::SUB_BUCKET_COUNT / 2u;
+
+double ToMilliseconds(std::uint64_t microseconds) {
+    return static_cast<double>(microseconds) / 1000.0;
+}
+
+std::uint64_t ToMicroseconds(TimeUtils::FPSeconds duration) {
+    const auto microseconds = std::chrono::duration<double, std::micro>{ duration }.count();
+    if(!(0.0 < microseconds)) {
+        return 0u;
+    }
+    if(static_cast<double>(FrameStats::Histogram::MAX_VALUE) < microseconds) {
+        return FrameStats::Histogram::MAX_VALUE;
+    }
+    return static_cast<std::uint64_t>(microseconds + 0.5);
+}
+
+} //End anonymous namespace
+
+std::size_t FrameStats::Histogram::GetBucketIndex(std::uint64_t value) {
+    value = (std::min)(value, MAX_VALUE);
+    if(value < SUB_BUCKET_COUNT) {
+        return static_cast<std::size_t>(value);
+    }
+    std::size_t msb = SUB_BUCKET_BITS;
+    while(value >> (msb + 1u)) {
+        ++msb;
+    }
+    //Keeps the top SUB_BUCKET_BITS bits, so the value lands in [HALF_SUB_BUCKET_COUNT, SUB_BUCKET_COUNT).
+    const auto shift = msb - (SUB_BUCKET_BITS - 1u);
+    return static_cast<std::size_t>(shift * HALF_SUB_BUCKET_COUNT + (value >> shift));
+}
+
+std::uint64_t FrameStats::Histogram::GetBucketUpperBound(std::size_t index) {
+    if(index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const auto shift = index / HALF_SUB_BUCKET_COUNT - 1u;
+    const auto sub_bucket = index - shift * HALF_SUB_BUCKET_COUNT;
+    return ((std::uint64_t{ sub_bucket } + 1u) << shift) - 1u;
+}
+
+void FrameStats::Histogram::Record(std::uint64_t value) {
+    value = (std::min)(value, MAX_VALUE);
+    _buckets[GetBucketIndex(value)].fetch_add(1u, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+    auto min = _min.load(std::memory_order_relaxed);
+    while(value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed)) {
+        /* DO NOTHING */
+    }
+    auto max = _max.load(std::memory_order_relaxed);
+    while(max < value && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        /* DO NOTHING */
+    }
+    //Last, so a reader that sees the count also sees the bucket.
+    _count.fetch_add(1u, std::memory_order_release);
+}
+
+void FrameStats::Histogram::Reset() {
+    _count.store(0u, std::memory_order_relaxed);
+    for(auto& bucket : _buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+    }
+    _sum.store(0u, std::memory_order_relaxed);
+    _min.store(MAX_VALUE, std::memory_order_relaxed);
+    _max.store(0u, std::memory_order_relaxed);
+}
+
+std::uint64_t FrameStats::Histogram::GetCount() const {
+    return _count.load(std::memory_order_acquire);
+}
+
+std::uint64_t FrameStats::Histogram::GetMin() const {
+    return GetCount() ? _min.load(std::memory_order_relaxed) : 0u;
+}
+
+std::uint64_t FrameStats::Histogram::GetMax() const {
+    return _max.load(std::memory_order_relaxed);
+}
+
+double FrameStats::Histogram::GetMean() const {
+    const auto count = GetCount();
+    return count ? static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+
+std::uint64_t FrameStats::Histogram::GetPercentile(double percentile) const {
+    //Recording may continue while this runs, so count against the buckets actually read.
+    std::uint64_t total = 0u;
+    for(const auto& bucket : _buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if(!total) {
+        return 0u;
+    }
+    percentile = std::clamp(percentile, 0.0, 1.0);
+    const auto target = static_cast<std::uint64_t>(percentile * static_cast<double>(total - 1u)) + 1u;
+    const auto max = GetMax();
+    std::uint64_t seen = 0u;
+    for(std::size_t index = 0u; index < BUCKET_COUNT; ++index) {
+        seen += _buckets[index].load(std::memory_order_relaxed);
+        if(target <= seen) {
+            return (std::min)(GetBucketUpperBound(index), max);
+        }
+    }
+    return max;
+}
+
+std::string to_string(const FrameStats::Metric& metric) {
+    switch(metric) {
+    case FrameStats::Metric::Frame:
+        return "Frame";
+    case FrameStats::Metric::Update:
+        return "Update";
+    case FrameStats::Metric::Render:
+        return "Render";
+    default:
+        return "Unknown";
+    }
+}
+
+FrameStats::Histogram& FrameStats::GetHistogram(Metric metric) {
+    return _histograms[static_cast<std::size_t>(metric)];
+}
+
+void FrameStats::MarkFrame() {
+    //Never 0 once the clock has started, which leaves 0 to mean "no previous mark".
+    const auto now = (std::max)(std::int64_t{ 1 }, static_cast<std::int64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    const auto previous = _last_mark.exchange(now, std::memory_order_relaxed);
+    if(previous && previous < now) {
+        Record(Metric::Frame, std::chrono::steady_clock::duration{ now - previous });
+    }
+}
+
+void FrameStats::Record(Metric metric, TimeUtils::FPSeconds duration) {
+    if(metric < Metric::Max) {
+        GetHistogram(metric).Record(ToMicroseconds(duration));
+    }
+}
+
+FrameStats::Report FrameStats::GetReport() {
+    Report report{};
+    for(std::size_t i = 0u; i < report.metrics.size(); ++i) {
+        const auto metric = static_cast<Metric>(i);
+        const auto& histogram = GetHistogram(metric);
+        auto& summary = report.metrics[i];
+        summary.metric = metric;
+        summary.count = histogram.GetCount();
+        summary.mean_ms = histogram.GetMean() / 1000.0;
+        summary.min_ms = ToMilliseconds(histogram.GetMin());
+        summary.p50_ms = ToMilliseconds(histogram.GetPercentile(0.50));
+        summary.p90_ms = ToMilliseconds(histogram.GetPercentile(0.90));
+        summary.p95_ms = ToMilliseconds(histogram.GetPercentile(0.95));
+        summary.p99_ms = ToMilliseconds(histogram.GetPercentile(0.99));
+        summary.p999_ms = ToMilliseconds(histogram.GetPercentile(0.999));
+        summary.max_ms = ToMilliseconds(histogram.GetMax());
+    }
+    return report;
+}
+
+void FrameStats::Reset() {
+    for(auto& histogram : _histograms) {
+        histogram.Reset();
+    }
+    _last_mark.store(0, std::memory_order_relaxed);
+}
+
+std::ostream& operator<<(std::ostream& out, const FrameStats::Report& report) {
+    constexpr int column_width = 10;
+    out << std::left << std::setw(8) << "Metric"
+        << std::right << std::setw(column_width) << "Count"
+        << std::right << std::setw(column_width) << "Mean"
+        << std::right << std::setw(column_width) << "Min"
+        << std::right << std::setw(column_width) << "p50"
+        << std::right << std::setw(column_width) << "p90"
+        << std::right << std::setw(column_width) << "p95"
+        << std::right << std::setw(column_width) << "p99"
+        << std::right << std::setw(column_width) << "p99.9"
+        << std::right << std::setw(column_width) << "Max"
+        << '\n';
+    out << std::fixed << std::setprecision(3);
+    for(const auto& summary : report.metrics) {
+        out << std::left << std::setw(8) << to_string(summary.metric)
+            << std::right << std::setw(column_width) << summary.count
+            << std::right << std::setw(column_width) << summary.mean_ms
+            << std::right << std::setw(column_width) << summary.min_ms
+            << std::right << std::setw(column_width) << summary.p50_ms
+            << std::right << std::setw(column_width) << summary.p90_ms
+            << std::right << std::setw(column_width) << summary.p95_ms
+            << std::right << std::setw(column_width) << summary.p99_ms
+            << std::right << std::setw(column_width) << summary.p999_ms
+            << std::right << std::setw(column_width) << summary.max_ms
+            << '\n';
+    }
+    out << "(milliseconds)\n";
+    return out;
+}
+
+bool FrameStats::AppendCsv(const std::filesystem::path& filepath) {
+    namespace FS = std::filesystem;
+    if(filepath.has_parent_path()) {
+        FileUtils::CreateFolders(filepath.parent_path().string());
+    }
+    std::error_code ec{};
+    const auto needs_header = !FS::exists(filepath, ec) || FS::file_size(filepath, ec) == 0u;
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::app);
+    if(!file) {
+        return false;
+    }
+    if(needs_header) {
+        file << "timestamp,metric,count,mean_ms,min_ms,p50_ms,p90_ms,p95_ms,p99_ms,p99.9_ms,max_ms\n";
+    }
+    const auto timestamp = TimeUtils::GetDateTimeStampFromNow();
+    file << std::fixed << std::setprecision(3);
+    for(const auto& summary : GetReport().metrics) {
+        file << timestamp << ',' << to_string(summary.metric) << ',' << summary.count
+             << ',' << summary.mean_ms << ',' << summary.min_ms
+             << ',' << summary.p50_ms << ',' << summary.p90_ms << ',' << summary.p95_ms
+             << ',' << summary.p99_ms << ',' << summary.p999_ms << ',' << summary.max_ms << '\n';
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,96 @@
+#pragma once
+//Rolling frame, update and render time statistics.
+//Every sample lands in an HDR-style histogram: values below SUB_BUCKET_COUNT microseconds are exact,
+//larger ones share a bucket with values within 1/128 of them, up to about two minutes. Recording is a
+//handful of relaxed atomic adds, so any thread may record while another reads or resets.
+//Renderer::UpdateGameTime marks frames; the application records Update and Render durations.
+
+#include "Engine/Core/TimeUtils.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+class Console;
+
+class FrameStats {
+public:
+    enum class Metric : std::uint8_t {
+        Frame
+        ,Update
+        ,Render
+        ,Max
+    };
+
+    //Values are microseconds.
+    class Histogram {
+    public:
+        static constexpr std::size_t SUB_BUCKET_BITS = 8u;
+        static constexpr std::size_t SUB_BUCKET_COUNT = std::size_t{ 1u } << SUB_BUCKET_BITS;
+        static constexpr std::size_t MAX_VALUE_BITS = 27u;
+        static constexpr std::uint64_t MAX_VALUE = (std::uint64_t{ 1u } << MAX_VALUE_BITS) - 1u;
+        static constexpr std::size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 2u) * (SUB_BUCKET_COUNT / 2u);
+
+        //Larger values are clamped to MAX_VALUE.
+        void Record(std::uint64_t value);
+        void Reset();
+
+        std::uint64_t GetCount() const;
+        std::uint64_t GetMin() const;
+        std::uint64_t GetMax() const;
+        double GetMean() const;
+        //Highest value sharing a bucket with the percentile's sample, clamped to the max.
+        std::uint64_t GetPercentile(double percentile) const;
+
+        static std::size_t GetBucketIndex(std::uint64_t value);
+        static std::uint64_t GetBucketUpperBound(std::size_t index);
+    private:
+        std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> _buckets{};
+        std::atomic<std::uint64_t> _count{ 0u };
+        std::atomic<std::uint64_t> _sum{ 0u };
+        std::atomic<std::uint64_t> _min{ MAX_VALUE };
+        std::atomic<std::uint64_t> _max{ 0u };
+    };
+
+    struct Summary {
+        Metric metric = Metric::Frame;
+        std::uint64_t count = 0u;
+        double mean_ms = 0.0;
+        double min_ms = 0.0;
+        double p50_ms = 0.0;
+        double p90_ms = 0.0;
+        double p95_ms = 0.0;
+        double p99_ms = 0.0;
+        double p999_ms = 0.0;
+        double max_ms = 0.0;
+    };
+
+    struct Report {
+        std::array<Summary, static_cast<std::size_t>(Metric::Max)> metrics{};
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    //Records the time since the previous mark as a frame. The first mark after a reset only starts the clock.
+    static void MarkFrame();
+    static void Record(Metric metric, TimeUtils::FPSeconds duration);
+    static Report GetReport();
+    static void Reset();
+
+    //Appends one row per metric, writing the header first if the file is new or empty.
+    static bool AppendCsv(const std::filesystem::path& filepath);
+
+    //framestats [reset|csv [file]]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    static Histogram& GetHistogram(Metric metric);
+    static std::array<Histogram, static_cast<std::size_t>(Metric::Max)> _histograms;
+    //steady_clock ticks of the last MarkFrame, or 0 after a reset.
+    static std::atomic<std::int64_t> _last_mark;
+};
+
+std::string to_string(const FrameStats::Metric& metric);
@@ -0,0 +1,254 @@
+#include "Engine/Profiling/JobInstrumentation.hpp"
+
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+std::atomic_bool JobInstrumentation::_enabled{ false };
+std::atomic<std::uint32_t> JobInstrumentation::_sample_mask{ JobInstrumentation::DEFAULT_SAMPLE_INTERVAL - 1u };
+thread_local std::uint32_t JobInstrumentation::_sample_counter = 0u;
+std::mutex JobInstrumentation::_cs{};
+std::vector<std::unique_ptr<JobInstrumentation::ThreadRing>> JobInstrumentation::_rings{};
+JobInstrumentation::Report JobInstrumentation::_report{};
+JobInstrumentation::span_listener_t JobInstrumentation::_span_listener{};
+
+namespace {
+
+double ToMicroseconds(std::uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+} //End anonymous namespace
+
+void JobInstrumentation::Histogram::Add(std::uint64_t value) {
+    std::size_t bucket = 0u;
+    while(bucket < BUCKET_COUNT - 1u && (value >> bucket) != 0u) {
+        ++bucket;
+    }
+    ++buckets[bucket];
+    ++count;
+    sum += value;
+    max = (std::max)(max, value);
+}
+
+std::uint64_t JobInstrumentation::Histogram::Percentile(double percentile) const {
+    if(!count) {
+        return 0u;
+    }
+    const auto target = static_cast<std::uint64_t>(percentile * static_cast<double>(count - 1u)) + 1u;
+    std::uint64_t seen = 0u;
+    for(std::size_t bucket = 0u; bucket < BUCKET_COUNT; ++bucket) {
+        seen += buckets[bucket];
+        if(target <= seen) {
+            const auto upper_bound = bucket ? (std::uint64_t{ 1u } << bucket) - 1u : std::uint64_t{ 0u };
+            return (std::min)(upper_bound, max);
+        }
+    }
+    return max;
+}
+
+double JobInstrumentation::Histogram::Mean() const {
+    return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+void JobInstrumentation::ThreadRing::Push(const Record& record) {
+    const auto head = _head.load(std::memory_order_relaxed);
+    if(head - _tail.load(std::memory_order_acquire) == CAPACITY) {
+        _dropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+    _records[head % CAPACITY] = record;
+    _head.store(head + 1u, std::memory_order_release);
+}
+
+template<typename F>
+void JobInstrumentation::ThreadRing::Drain(F&& f) {
+    auto tail = _tail.load(std::memory_order_relaxed);
+    const auto head = _head.load(std::memory_order_acquire);
+    for(; tail != head; ++tail) {
+        f(_records[tail % CAPACITY]);
+    }
+    _tail.store(tail, std::memory_order_release);
+}
+
+std::uint64_t JobInstrumentation::ThreadRing::TakeDroppedCount() {
+    return _dropped.exchange(0u, std::memory_order_relaxed);
+}
+
+const char* JobInstrumentation::GetJobTypeName(const JobType& type) {
+    switch(type) {
+    case JobType::Generic: return "Generic";
+    case JobType::Logging: return "Logging";
+    case JobType::Io:      return "Io";
+    case JobType::Render:  return "Render";
+    case JobType::Main:    return "Main";
+    default:               return "Unknown";
+    }
+}
+
+void JobInstrumentation::Enable(bool enable) {
+    if(enable) {
+        //Calibrate before the first job is timed rather than on the first Collect.
+        GetNanosecondsPerTick();
+    }
+    _enabled = enable;
+}
+
+void JobInstrumentation::SetSampleInterval(std::uint32_t interval) {
+    std::uint32_t rounded = 1u;
+    while(rounded < interval && rounded < 0x80000000u) {
+        rounded <<= 1;
+    }
+    _sample_mask = rounded - 1u;
+}
+
+std::uint32_t JobInstrumentation::GetSampleInterval() {
+    return _sample_mask + 1u;
+}
+
+void JobInstrumentation::RecordJob(const JobType& type, std::size_t queue_depth, std::size_t worker_index, std::uint64_t submit_ticks, std::uint64_t start_ticks, std::uint64_t end_ticks) {
+    Record record{};
+    record.submit_ticks = submit_ticks;
+    record.start_ticks = start_ticks;
+    record.end_ticks = end_ticks;
+    record.queue_depth = static_cast<std::uint32_t>((std::min)(queue_depth, std::size_t{ 0xFFFFFFFFu }));
+    record.worker_index = worker_index < NOT_A_WORKER ? static_cast<std::uint16_t>(worker_index) : NOT_A_WORKER;
+    record.type = static_cast<std::uint8_t>(type);
+    GetThreadRing().Push(record);
+}
+
+void JobInstrumentation::Collect() {
+    const auto ns_per_tick = GetNanosecondsPerTick();
+    auto to_ns = [ns_per_tick](std::uint64_t first, std::uint64_t last) {
+        //Timestamps taken on different cores may be slightly out of order.
+        return last < first ? std::uint64_t{ 0u } : static_cast<std::uint64_t>(static_cast<double>(last - first) * ns_per_tick);
+    };
+    std::scoped_lock<std::mutex> lock(_cs);
+    for(auto& ring : _rings) {
+        //Read before draining: once set, the owning thread has pushed its last record.
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        ring->Drain([&to_ns](const Record& record) {
+            if(_span_listener) {
+                _span_listener(Span{ static_cast<JobType>(record.type), record.worker_index, record.queue_depth, record.submit_ticks, record.start_ticks, record.end_ticks });
+            }
+            auto& stats = _report.categories[record.type];
+            stats.queue_depth.Add(record.queue_depth);
+            stats.wait_ns.Add(to_ns(record.submit_ticks, record.start_ticks));
+            stats.run_ns.Add(to_ns(record.start_ticks, record.end_ticks));
+            if(record.worker_index == NOT_A_WORKER) {
+                ++_report.jobs_on_other_threads;
+                return;
+            }
+            if(_report.jobs_per_worker.size() <= record.worker_index) {
+                _report.jobs_per_worker.resize(record.worker_index + 1u);
+            }
+            ++_report.jobs_per_worker[record.worker_index];
+        });
+        _report.dropped_records += ring->TakeDroppedCount();
+        if(retired) {
+            ring.reset();
+        }
+    }
+    _rings.erase(std::remove(std::begin(_rings), std::end(_rings), nullptr), std::end(_rings));
+}
+
+JobInstrumentation::Report JobInstrumentation::GetReport() {
+    Collect();
+    std::scoped_lock<std::mutex> lock(_cs);
+    auto report = _report;
+    report.sample_interval = GetSampleInterval();
+    return report;
+}
+
+void JobInstrumentation::Reset() {
+    std::scoped_lock<std::mutex> lock(_cs);
+    for(auto& ring : _rings) {
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        ring->Drain([](const Record& /*record*/) { /* DO NOTHING */ });
+        ring->TakeDroppedCount();
+        if(retired) {
+            ring.reset();
+        }
+    }
+    _rings.erase(std::remove(std::begin(_rings), std::end(_rings), nullptr), std::end(_rings));
+    _report = Report{};
+}
+
+void JobInstrumentation::SetSpanListener(span_listener_t onSpan) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    _span_listener = std::move(onSpan);
+}
+
+JobInstrumentation::ThreadRing& JobInstrumentation::GetThreadRing() {
+    thread_local ThreadRing* ring = nullptr;
+    if(!ring) {
+        //Retires the ring when the thread exits; the next Collect or Reset drains and frees it.
+        //Jobs run by thread_local destructors that run after this one must not be recorded.
+        struct RingRetirer {
+            ThreadRing* ring = nullptr;
+            ~RingRetirer() {
+                if(ring) {
+                    ring->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+        thread_local RingRetirer retirer{};
+        std::scoped_lock<std::mutex> lock(_cs);
+        _rings.push_back(std::make_unique<ThreadRing>());
+        ring = _rings.back().get();
+        retirer.ring = ring;
+    }
+    return *ring;
+}
+
+double JobInstrumentation::GetNanosecondsPerTick() {
+    return Profiler::GetNanosecondsPerTick();
+}
+
+std::ostream& operator<<(std::ostream& out, const JobInstrumentation::Report& report) {
+    auto old_fmt = out.flags();
+    auto old_w = out.width();
+    auto old_p = out.precision();
+    constexpr int column_width = 12;
+    out << std::left << std::setw(10) << "Type"
+        << std::right << std::setw(column_width) << "Jobs"
+        << std::right << std::setw(column_width) << "Wait p50"
+        << std::right << std::setw(column_width) << "Wait p99"
+        << std::right << std::setw(column_width) << "Wait max"
+        << std::right << std::setw(column_width) << "Run p50"
+        << std::right << std::setw(column_width) << "Run p99"
+        << std::right << std::setw(column_width) << "Run max"
+        << std::right << std::setw(column_width) << "Depth p50"
+        << std::right << std::setw(column_width) << "Depth p99"
+        << '\n';
+    out << std::fixed << std::setprecision(1);
+    for(std::size_t i = 0u; i < report.categories.size(); ++i) {
+        const auto& stats = report.categories[i];
+        if(!stats.run_ns.count) {
+            continue;
+        }
+        out << std::left << std::setw(10) << JobInstrumentation::GetJobTypeName(static_cast<JobType>(i))
+            << std::right << std::setw(column_width) << stats.run_ns.count
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.wait_ns.Percentile(0.50))
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.wait_ns.Percentile(0.99))
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.wait_ns.max)
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.run_ns.Percentile(0.50))
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.run_ns.Percentile(0.99))
+            << std::right << std::setw(column_width) << ToMicroseconds(stats.run_ns.max)
+            << std::right << std::setw(column_width) << stats.queue_depth.Percentile(0.50)
+            << std::right << std::setw(column_width) << stats.queue_depth.Percentile(0.99)
+            << '\n';
+    }
+    out << "(times in microseconds, one job in every " << report.sample_interval << " recorded)\n";
+    for(std::size_t i = 0u; i < report.jobs_per_worker.size(); ++i) {
+        out << std::left << std::setw(25) << ("Worker " + std::to_string(i) + ':') << std::right << std::setw(column_width) << report.jobs_per_worker[i] << '\n';
+    }
+    out << std::left << std::setw(25) << "Other threads:" << std::right << std::setw(column_width) << report.jobs_on_other_threads << '\n';
+    out << std::left << std::setw(25) << "Dropped records:" << std::right << std::setw(column_width) << report.dropped_records << '\n';
+    out.flags(old_fmt);
+    out.width(old_w);
+    out.precision(old_p);
+    return out;
+}
@@ -0,0 +1,148 @@
+#pragma once
+//Per-job submit/start/end timing for the JobSystem.
+//Each thread that runs jobs appends fixed-size records to its own single-producer ring;
+//Collect drains every ring into per-JobType histograms of queue depth, wait time and run time.
+//A recorded job costs three timestamp reads and one ring write. Only one job in every sample
+//interval (per submitting thread) is recorded, which keeps the amortized cost to a few nanoseconds.
+
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/JobSystem.hpp"
+
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+class Console;
+
+class JobInstrumentation {
+public:
+    //Power-of-two buckets: bucket i holds values in [2^(i-1), 2^i).
+    struct Histogram {
+        static constexpr std::size_t BUCKET_COUNT = 64u;
+        std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+        std::uint64_t count = 0u;
+        std::uint64_t sum = 0u;
+        std::uint64_t max = 0u;
+        void Add(std::uint64_t value);
+        //Upper bound of the bucket holding the percentile, clamped to max.
+        std::uint64_t Percentile(double percentile) const;
+        double Mean() const;
+    };
+
+    struct CategoryStats {
+        Histogram queue_depth{};
+        Histogram wait_ns{};
+        Histogram run_ns{};
+    };
+
+    struct Report {
+        std::array<CategoryStats, static_cast<std::size_t>(JobType::Max)> categories{};
+        //Indexed by generic worker.
+        std::vector<std::uint64_t> jobs_per_worker{};
+        //Jobs run by the main, Io, logging or any other non-worker thread.
+        std::uint64_t jobs_on_other_threads = 0u;
+        std::uint64_t dropped_records = 0u;
+        std::uint32_t sample_interval = 1u;
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    //One recorded job, for capture tools that need the timeline rather than the histograms.
+    struct Span {
+        JobType type = JobType::Generic;
+        //Generic worker that ran the job, or NOT_A_WORKER.
+        std::uint16_t worker_index = 0u;
+        std::uint32_t queue_depth = 0u;
+        std::uint64_t submit_ticks = 0u;
+        std::uint64_t start_ticks = 0u;
+        std::uint64_t end_ticks = 0u;
+    };
+    using span_listener_t = std::function<void(const Span&)>;
+
+    static constexpr std::uint16_t NOT_A_WORKER = 0xFFFFu;
+
+    static void Enable(bool enable);
+    static bool IsEnabled();
+    //True for one job in every sample interval submitted from this thread while enabled.
+    static bool ShouldRecord();
+    static std::uint64_t Now();
+    //Rounded up to a power of two.
+    static void SetSampleInterval(std::uint32_t interval);
+    static std::uint32_t GetSampleInterval();
+
+    static void RecordJob(const JobType& type, std::size_t queue_depth, std::size_t worker_index, std::uint64_t submit_ticks, std::uint64_t start_ticks, std::uint64_t end_ticks);
+    //Drains every thread's ring into the histograms, and into the span listener if set. Any thread.
+    static void Collect();
+    static Report GetReport();
+    static void Reset();
+    //Called from Collect under the instrumentation lock; an empty function removes it.
+    static void SetSpanListener(span_listener_t onSpan);
+
+    static const char* GetJobTypeName(const JobType& type);
+
+    //jobstats [on|off|reset|sample N]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    struct Record {
+        std::uint64_t submit_ticks = 0u;
+        std::uint64_t start_ticks = 0u;
+        std::uint64_t end_ticks = 0u;
+        std::uint32_t queue_depth = 0u;
+        std::uint16_t worker_index = 0u;
+        std::uint8_t type = 0u;
+    };
+
+    //Single producer (the owning thread), single consumer (Collect, under _cs).
+    //A full ring drops new records rather than blocking the job.
+    class ThreadRing {
+    public:
+        void Push(const Record& record);
+        template<typename F>
+        void Drain(F&& f);
+        std::uint64_t TakeDroppedCount();
+        //Set when the owning thread exits; the consumer frees the ring after its last drain.
+        std::atomic_bool retired{ false };
+    private:
+        static constexpr std::size_t CAPACITY = 4096u;
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+        std::array<Record, CAPACITY> _records{};
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _head{ 0u };
+        std::atomic<std::uint64_t> _dropped{ 0u };
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _tail{ 0u };
+    };
+
+    static ThreadRing& GetThreadRing();
+    static double GetNanosecondsPerTick();
+
+    static constexpr std::uint32_t DEFAULT_SAMPLE_INTERVAL = 16u;
+
+    static std::atomic_bool _enabled;
+    static std::atomic<std::uint32_t> _sample_mask;
+    static thread_local std::uint32_t _sample_counter;
+    static std::mutex _cs;
+    static std::vector<std::unique_ptr<ThreadRing>> _rings;
+    static Report _report;
+    static span_listener_t _span_listener;
+};
+
+//Inline: these run on every job dispatch.
+inline bool JobInstrumentation::IsEnabled() {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline bool JobInstrumentation::ShouldRecord() {
+    return IsEnabled() && (++_sample_counter & _sample_mask.load(std::memory_order_relaxed)) == 0u;
+}
+
+//Same timebase as the Profiler, so job spans and profiled scopes line up.
+inline std::uint64_t JobInstrumentation::Now() {
+    return Profiler::Now();
+}
@@ -1,5 +1,371 @@
 #include "Engine/Profiling/Memory.hpp"
 
+#include "Engine/Core/FileUtils.hpp"
+
+#include "Engine/Memory/TlsfAllocator.hpp"
+
+#include "Engine/Profiling/AllocationProfiler.hpp"
+#include "Engine/Profiling/MemoryBudgets.hpp"
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+
+#ifdef PLATFORM_WINDOWS
+#include "Engine/Core/Win.hpp"
+#include <Psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#elif defined(PLATFORM_LINUX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+constexpr auto TAG_COUNT = static_cast<std::size_t>(MemoryTag::Max);
+
+//Written only by the owning thread (load + store, no read-modify-write) and read by tick.
+//Blocks are never freed: a thread may still allocate during its own teardown, and threads
+//are few and long-lived, so a handful of leaked blocks is cheaper than synchronizing reuse.
+struct thread_counters_t {
+    struct counters_t {
+        std::atomic<std::size_t> alloc_count{ 0 };
+        std::atomic<std::size_t> alloc_bytes{ 0 };
+        std::atomic<std::size_t> free_count{ 0 };
+        std::atomic<std::size_t> free_bytes{ 0 };
+    };
+    std::array<counters_t, TAG_COUNT> tags{};
+    thread_counters_t* next = nullptr;
+};
+
+struct block_header_t {
+    std::size_t size = 0;
+    //AllocationProfiler call site; 0 when not recorded.
+    std::uint32_t site = 0;
+    MemoryTag tag = MemoryTag::General;
+    bool counted = false;
+    //AllocationProfiler generation the site was charged in.
+    std::uint16_t generation = 0;
+};
+//Keeps the user pointer at the alignment operator new promises.
+constexpr std::size_t HEADER_SIZE = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+static_assert(sizeof(block_header_t) <= HEADER_SIZE);
+
+//Plain totals: merged from every thread's counters and kept between ticks.
+struct counters_t {
+    std::size_t alloc_count = 0;
+    std::size_t alloc_bytes = 0;
+    std::size_t free_count = 0;
+    std::size_t free_bytes = 0;
+};
+using tag_counters_t = std::array<counters_t, TAG_COUNT>;
+
+std::atomic<thread_counters_t*> g_thread_counters{ nullptr };
+//Trivially initialized so operator new may touch them at any point in a thread's life.
+thread_local thread_counters_t* t_counters = nullptr;
+thread_local MemoryTag t_tag = MemoryTag::General;
+
+//Null only if the counters themselves could not be allocated; the allocation then goes uncounted.
+thread_counters_t* GetThreadCounters() noexcept {
+    if(t_counters) {
+        return t_counters;
+    }
+    //malloc, not new: this runs inside operator new.
+    auto* raw = std::malloc(sizeof(thread_counters_t));
+    if(!raw) {
+        return nullptr;
+    }
+    auto* counters = ::new(raw) thread_counters_t{};
+    counters->next = g_thread_counters.load(std::memory_order_relaxed);
+    while(!g_thread_counters.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed)) {
+        /* DO NOTHING */
+    }
+    t_counters = counters;
+    return counters;
+}
+
+void Bump(std::atomic<std::size_t>& counter, std::size_t amount) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+#if MEMORY_BACKEND == MEMORY_BACKEND_TLSF
+TlsfAllocator& GetTlsfBackend() {
+    //Never destroyed: frees keep arriving during static destruction.
+    static auto* backend = ::new(std::malloc(sizeof(TlsfAllocator))) TlsfAllocator{};
+    return *backend;
+}
+#endif
+
+void* AllocateFromBackend(std::size_t bytes) noexcept {
+#if MEMORY_BACKEND == MEMORY_BACKEND_TLSF
+    return GetTlsfBackend().Allocate(bytes);
+#else
+    return std::malloc(bytes);
+#endif
+}
+
+void FreeToBackend(void* ptr) noexcept {
+#if MEMORY_BACKEND == MEMORY_BACKEND_TLSF
+    GetTlsfBackend().Deallocate(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+std::size_t SaturatingSubtract(std::size_t a, std::size_t b) noexcept {
+    return a > b ? a - b : 0;
+}
+
+tag_counters_t MergeCounters() {
+    tag_counters_t result{};
+    for(auto* counters = g_thread_counters.load(std::memory_order_acquire); counters; counters = counters->next) {
+        for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+            const auto& tag = counters->tags[i];
+            result[i].alloc_count += tag.alloc_count.load(std::memory_order_relaxed);
+            result[i].alloc_bytes += tag.alloc_bytes.load(std::memory_order_relaxed);
+            result[i].free_count += tag.free_count.load(std::memory_order_relaxed);
+            result[i].free_bytes += tag.free_bytes.load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+std::size_t GetPeakWorkingSet() noexcept {
+#ifdef PLATFORM_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters{};
+    if(::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+#elif defined(PLATFORM_LINUX)
+    rusage usage{};
+    if(::getrusage(RUSAGE_SELF, &usage) == 0) {
+        //Kilobytes.
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+    }
+#endif
+    return 0;
+}
+
+std::mutex g_tick_cs{};
+std::size_t g_frame_counter = 0;
+tag_counters_t g_last_tick{};
+tag_counters_t g_last_frame{};
+std::array<std::size_t, TAG_COUNT> g_peak_bytes{};
+std::uint64_t g_last_tick_time = 0;
+std::array<Memory::timeline_frame_t, Memory::TIMELINE_FRAMES> g_timeline{};
+
+} //End anonymous namespace
+
+std::string to_string(const MemoryTag& tag) {
+    switch(tag) {
+    case MemoryTag::General:
+        return "General";
+    case MemoryTag::Renderer:
+        return "Renderer";
+    case MemoryTag::Audio:
+        return "Audio";
+    case MemoryTag::UI:
+        return "UI";
+    case MemoryTag::Jobs:
+        return "Jobs";
+    case MemoryTag::Logging:
+        return "Logging";
+    default:
+        return "Unknown";
+    }
+}
+
+void* Memory::allocate(std::size_t n) {
+    if(n > (std::numeric_limits<std::size_t>::max)() - HEADER_SIZE) {
+        throw std::bad_alloc{};
+    }
+    auto* block = static_cast<unsigned char*>(AllocateFromBackend(HEADER_SIZE + n));
+    if(!block) {
+        throw std::bad_alloc{};
+    }
+    auto* header = ::new(block) block_header_t{ n, 0, t_tag, _active.load(std::memory_order_relaxed) };
+    if(header->counted) {
+        if(auto* thread_counters = GetThreadCounters()) {
+            auto& counters = thread_counters->tags[static_cast<std::size_t>(header->tag)];
+            Bump(counters.alloc_count, 1);
+            Bump(counters.alloc_bytes, n);
+        }
+    }
+    if(AllocationProfiler::ShouldRecord()) {
+        header->generation = AllocationProfiler::GetGeneration();
+        header->site = AllocationProfiler::RecordAllocation(n);
+    }
+    return block + HEADER_SIZE;
+}
+
+void Memory::deallocate(void* ptr) noexcept {
+    if(!ptr) {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(ptr) - HEADER_SIZE;
+    const auto* header = reinterpret_cast<const block_header_t*>(block);
+    //Only frees of counted blocks are counted, so toggling enable never skews live totals.
+    if(header->counted) {
+        if(auto* thread_counters = GetThreadCounters()) {
+            auto& counters = thread_counters->tags[static_cast<std::size_t>(header->tag)];
+            Bump(counters.free_count, 1);
+            Bump(counters.free_bytes, header->size);
+        }
+    }
+    if(header->site) {
+        AllocationProfiler::RecordFree(header->site, header->size, header->generation);
+    }
+    FreeToBackend(block);
+}
+
+void Memory::tick() {
+    std::array<std::size_t, TAG_COUNT> live_bytes{};
+    const auto peak_working_set = GetPeakWorkingSet();
+    const auto tick_time = Profiler::Now();
+    {
+        std::scoped_lock<std::mutex> lock(g_tick_cs);
+        const auto now = MergeCounters();
+        auto& entry = g_timeline[g_frame_counter % TIMELINE_FRAMES];
+        entry = timeline_frame_t{};
+        entry.frame_id = g_frame_counter;
+        entry.begin_ticks = g_last_tick_time ? g_last_tick_time : tick_time;
+        entry.end_ticks = tick_time;
+        entry.peak_working_set = peak_working_set;
+        for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+            g_last_frame[i].alloc_count = now[i].alloc_count - g_last_tick[i].alloc_count;
+            g_last_frame[i].alloc_bytes = now[i].alloc_bytes - g_last_tick[i].alloc_bytes;
+            g_last_frame[i].free_count = now[i].free_count - g_last_tick[i].free_count;
+            g_last_frame[i].free_bytes = now[i].free_bytes - g_last_tick[i].free_bytes;
+            live_bytes[i] = SaturatingSubtract(now[i].alloc_bytes, now[i].free_bytes);
+            g_peak_bytes[i] = (std::max)(g_peak_bytes[i], live_bytes[i]);
+            entry.allocs += g_last_frame[i].alloc_count;
+            entry.alloc_bytes += g_last_frame[i].alloc_bytes;
+            entry.frees += g_last_frame[i].free_count;
+            entry.free_bytes += g_last_frame[i].free_bytes;
+            entry.live_bytes += live_bytes[i];
+        }
+        g_last_tick = now;
+        g_last_tick_time = tick_time;
+        ++g_frame_counter;
+    }
+    //Unlocked: handlers may allocate, free, or ask for status.
+    for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+        MemoryBudgets::Check(static_cast<MemoryTag>(i), live_bytes[i]);
+    }
+    if(auto frame = frame_status()) {
+        std::string status = frame;
+        DebuggerPrintf("%s", status.c_str());
+    }
+}
+
+MemoryTag Memory::set_thread_tag(MemoryTag tag) noexcept {
+    const auto previous = t_tag;
+    t_tag = tag;
+    return previous;
+}
+
+MemoryTag Memory::get_thread_tag() noexcept {
+    return t_tag;
+}
+
+Memory::status_t Memory::status() {
+    status_t result{};
+    std::size_t freed_objs = 0;
+    std::size_t freed_bytes = 0;
+    for(const auto& counters : MergeCounters()) {
+        result.leaked_objs += counters.alloc_count;
+        result.leaked_bytes += counters.alloc_bytes;
+        freed_objs += counters.free_count;
+        freed_bytes += counters.free_bytes;
+    }
+    //The merge is not a snapshot; a free can be seen before the allocation it pairs with.
+    result.leaked_objs = SaturatingSubtract(result.leaked_objs, freed_objs);
+    result.leaked_bytes = SaturatingSubtract(result.leaked_bytes, freed_bytes);
+    return result;
+}
+
+Memory::status_frame_t Memory::frame_status() {
+    std::scoped_lock<std::mutex> lock(g_tick_cs);
+    status_frame_t result{};
+    result.frame_id = g_frame_counter ? g_frame_counter - 1 : 0;
+    std::size_t freed_objs = 0;
+    std::size_t freed_bytes = 0;
+    for(const auto& counters : g_last_frame) {
+        result.leaked_objs += counters.alloc_count;
+        result.leaked_bytes += counters.alloc_bytes;
+        freed_objs += counters.free_count;
+        freed_bytes += counters.free_bytes;
+    }
+    result.leaked_objs = SaturatingSubtract(result.leaked_objs, freed_objs);
+    result.leaked_bytes = SaturatingSubtract(result.leaked_bytes, freed_bytes);
+    return result;
+}
+
+Memory::tag_status_t Memory::tag_status(MemoryTag tag) {
+    const auto index = static_cast<std::size_t>(tag);
+    tag_status_t result{};
+    result.tag = tag;
+    if(index >= TAG_COUNT) {
+        return result;
+    }
+    const auto live = MergeCounters()[index];
+    result.live_objs = SaturatingSubtract(live.alloc_count, live.free_count);
+    result.live_bytes = SaturatingSubtract(live.alloc_bytes, live.free_bytes);
+    std::scoped_lock<std::mutex> lock(g_tick_cs);
+    const auto& frame = g_last_frame[index];
+    result.peak_bytes = g_peak_bytes[index];
+    result.frame_allocs = frame.alloc_count;
+    result.frame_alloc_bytes = frame.alloc_bytes;
+    result.frame_frees = frame.free_count;
+    result.frame_free_bytes = frame.free_bytes;
+    return result;
+}
+
+std::string Memory::tag_report() {
+    std::ostringstream ss;
+    for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+        ss << tag_status(static_cast<MemoryTag>(i));
+    }
+    return ss.str();
+}
+
+std::vector<Memory::timeline_frame_t> Memory::timeline(std::size_t firstFrameId) {
+    std::scoped_lock<std::mutex> lock(g_tick_cs);
+    const auto oldest = SaturatingSubtract(g_frame_counter, TIMELINE_FRAMES);
+    std::vector<timeline_frame_t> result{};
+    for(auto frame_id = (std::max)(oldest, firstFrameId); frame_id < g_frame_counter; ++frame_id) {
+        result.push_back(g_timeline[frame_id % TIMELINE_FRAMES]);
+    }
+    return result;
+}
+
+bool Memory::write_timeline_csv(const std::filesystem::path& filepath) {
+    const auto frames = timeline();
+    if(filepath.has_parent_path()) {
+        FileUtils::CreateFolders(filepath.parent_path().string());
+    }
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::trunc);
+    if(!file) {
+        return false;
+    }
+    file << "frame,begin_ms,duration_ms,allocs,alloc_bytes,frees,free_bytes,live_bytes,peak_working_set_bytes\n";
+    const auto ms_per_tick = Profiler::GetNanosecondsPerTick() / 1000000.0;
+    const auto origin = frames.empty() ? 0 : frames.front().begin_ticks;
+    file << std::fixed << std::setprecision(3);
+    for(const auto& frame : frames) {
+        file << frame.frame_id
+             << ',' << static_cast<double>(frame.begin_ticks - origin) * ms_per_tick
+             << ',' << static_cast<double>(frame.end_ticks - frame.begin_ticks) * ms_per_tick
+             << ',' << frame.allocs << ',' << frame.alloc_bytes
+             << ',' << frame.frees << ',' << frame.free_bytes
+             << ',' << frame.live_bytes << ',' << frame.peak_working_set << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
 #ifdef TRACK_MEMORY
 
 void* operator new(std::size_t size) {
@@ -10,12 +376,20 @@ void* operator new[](std::size_t size) {
     return Memory::allocate(size);
 }
 
-void operator delete(void* ptr, std::size_t size) noexcept {
-    Memory::deallocate(ptr, size);
+void operator delete(void* ptr) noexcept {
+    Memory::deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    Memory::deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    Memory::deallocate(ptr);
 }
 
-void operator delete[](void* ptr, std::size_t size) noexcept {
-    Memory::deallocate(ptr, size);
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+    Memory::deallocate(ptr);
 }
 
-#endif
\ No newline at end of file
+#endif
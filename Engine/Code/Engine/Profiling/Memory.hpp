@@ -7,8 +7,29 @@
 
 #include "Engine/Profiling/StackTrace.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
 #include <new>
 #include <sstream>
+#include <string>
+#include <vector>
+
+class Console;
+
+//Subsystem an allocation is charged to. Set per thread with MEMORY_TAG_SCOPE.
+enum class MemoryTag : std::uint8_t {
+    General
+    ,Renderer
+    ,Audio
+    ,UI
+    ,Jobs
+    ,Logging
+    ,Max
+};
+
+std::string to_string(const MemoryTag& tag);
 
 class Memory {
 public:
@@ -44,32 +65,47 @@ public:
             return s;
         }
     };
-
-    [[nodiscard]] static void* allocate(std::size_t n) {
-        if(_active) {
-            ++frameCount;
-            frameSize += n;
-            ++allocCount;
-            allocSize += n;
-            if(maxSize < allocSize) {
-                maxSize = allocSize;
-            }
-            if(maxCount < allocCount) {
-                maxCount = allocCount;
-            }
+    struct tag_status_t {
+        MemoryTag tag = MemoryTag::General;
+        std::size_t live_objs = 0;
+        std::size_t live_bytes = 0;
+        //Most live bytes seen by tick.
+        std::size_t peak_bytes = 0;
+        std::size_t frame_allocs = 0;
+        std::size_t frame_alloc_bytes = 0;
+        std::size_t frame_frees = 0;
+        std::size_t frame_free_bytes = 0;
+        friend std::ostream& operator<<(std::ostream& os, const tag_status_t s) {
+            os << std::left << std::setw(10) << to_string(s.tag)
+               << std::right << std::setw(12) << s.live_objs << " objs"
+               << std::setw(14) << s.live_bytes << " bytes"
+               << std::setw(14) << s.peak_bytes << " peak"
+               << std::setw(10) << s.frame_allocs << " allocs/frame"
+               << std::setw(12) << s.frame_alloc_bytes << " bytes/frame\n";
+            return os;
         }
-        return std::malloc(n);
-    }
+    };
+    //One frame of the timeline, all tags together.
+    struct timeline_frame_t {
+        std::size_t frame_id = 0;
+        //Profiler::Now() at the previous tick and at this one.
+        std::uint64_t begin_ticks = 0;
+        std::uint64_t end_ticks = 0;
+        std::size_t allocs = 0;
+        std::size_t alloc_bytes = 0;
+        std::size_t frees = 0;
+        std::size_t free_bytes = 0;
+        std::size_t live_bytes = 0;
+        //Largest resident size the process has reached, as the OS reports it.
+        std::size_t peak_working_set = 0;
+    };
+    //Frames the timeline ring holds; older frames are overwritten.
+    static constexpr std::size_t TIMELINE_FRAMES = 1024;
 
-    static void deallocate(void* ptr, std::size_t size) noexcept {
-        if(_active) {
-            ++framefreeCount;
-            framefreeSize += size;
-            ++freeCount;
-            freeSize += size;
-        }
-        std::free(ptr);
-    }
+    //Each block carries a small header with its size and tag, so frees are charged
+    //to the tag that allocated them no matter which thread or scope releases them.
+    [[nodiscard]] static void* allocate(std::size_t n);
+    static void deallocate(void* ptr) noexcept;
 
     static void enable(bool e) {
         _active = e;
@@ -83,51 +119,70 @@ public:
         _trace = doTrace;
     }
 
-    static void tick() {
-        if(auto f = Memory::frame_status()) {
-            std::string status = f;
-            DebuggerPrintf(status.c_str(), "%s");
-        }
-        ++frameCounter;
-        resetframecounters();
-    }
+    //Merges every thread's counters into the frame and per-tag totals, records the frame in the
+    //timeline, then checks MemoryBudgets. Call once per frame from one thread; budget handlers run on it.
+    static void tick();
 
-    static void resetframecounters() {
-        frameSize = 0;
-        frameCount = 0;
-        framefreeCount = 0;
-        framefreeSize = 0;
-    }
+    //Tag charged for allocations made on the calling thread. Returns the previous tag.
+    static MemoryTag set_thread_tag(MemoryTag tag) noexcept;
+    static MemoryTag get_thread_tag() noexcept;
 
-    static status_t status() {
-        return { allocCount - freeCount, allocSize - freeSize };
-    }
+    //Live totals are merged on demand; frame numbers are for the last frame completed by tick.
+    static status_t status();
+    static status_frame_t frame_status();
+    static tag_status_t tag_status(MemoryTag tag);
+    static std::string tag_report();
+    //Frames still in the ring with ids at or after firstFrameId, oldest first.
+    static std::vector<timeline_frame_t> timeline(std::size_t firstFrameId = 0);
+    //One row per frame in the ring, overwriting filepath.
+    static bool write_timeline_csv(const std::filesystem::path& filepath);
+
+    //memtimeline [N|csv [file]]
+    static void register_console_commands(Console& console);
+
+protected:
+private:
+    inline static std::atomic_bool _active{ false };
+    inline static std::atomic_bool _trace{ false };
+};
 
-    static status_frame_t frame_status() {
-        return { frameCounter, frameCount - framefreeCount, frameSize - framefreeSize };
+//Charges allocations on this thread to a tag until the end of the enclosing scope.
+class ScopedMemoryTag {
+public:
+    explicit ScopedMemoryTag(MemoryTag tag) noexcept
+        : _previous(Memory::set_thread_tag(tag))
+    {
+        /* DO NOTHING */
+    }
+    ~ScopedMemoryTag() noexcept {
+        Memory::set_thread_tag(_previous);
     }
 
-    inline static std::size_t maxSize = 0;
-    inline static std::size_t maxCount = 0;
-    inline static std::size_t allocSize = 0;
-    inline static std::size_t allocCount = 0;
-    inline static std::size_t frameSize = 0;
-    inline static std::size_t frameCount = 0;
-    inline static std::size_t frameCounter = 0;
-    inline static std::size_t freeCount = 0;
-    inline static std::size_t freeSize = 0;
-    inline static std::size_t framefreeCount = 0;
-    inline static std::size_t framefreeSize = 0;
+    ScopedMemoryTag() = delete;
+    ScopedMemoryTag(const ScopedMemoryTag&) = delete;
+    ScopedMemoryTag(ScopedMemoryTag&&) = delete;
+    ScopedMemoryTag& operator=(const ScopedMemoryTag&) = delete;
+    ScopedMemoryTag& operator=(ScopedMemoryTag&&) = delete;
 protected:
 private:
-    inline static bool _active = false;
-    inline static bool _trace = false;
+    MemoryTag _previous = MemoryTag::General;
 };
 
+#if defined MEMORY_TAG_SCOPE
+#undef MEMORY_TAG_SCOPE
+#endif
+#ifdef TRACK_MEMORY
+#define MEMORY_TAG_SCOPE(tag) ScopedMemoryTag TOKEN_PASTE(__memtag_,__LINE__)(MemoryTag::tag)
+#else
+#define MEMORY_TAG_SCOPE(tag)
+#endif
+
 #ifdef TRACK_MEMORY
 
 void* operator new(std::size_t size);
 void* operator new[](std::size_t size);
+void operator delete(void* ptr) noexcept;
+void operator delete[](void* ptr) noexcept;
 void operator delete(void* ptr, std::size_t size) noexcept;
 void operator delete[](void* ptr, std::size_t size) noexcept;
 
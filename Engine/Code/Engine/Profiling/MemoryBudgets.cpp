@@ -0,0 +1,189 @@
+#include "Engine/Profiling/MemoryBudgets.hpp"
+
+#include "Engine/Core/Config.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+#include <array>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+constexpr auto TAG_COUNT = static_cast<std::size_t>(MemoryTag::Max);
+
+struct BudgetState {
+    MemoryBudgets::Budget budget{};
+    MemoryBudgets::hard_budget_cb_t hard_callback{};
+    //Set while over the soft budget, so the event fires once per crossing.
+    bool over_soft = false;
+};
+
+std::mutex g_budget_cs{};
+std::array<BudgetState, TAG_COUNT> g_budgets{};
+
+BudgetState* GetState(MemoryTag tag) {
+    const auto index = static_cast<std::size_t>(tag);
+    return index < TAG_COUNT ? &g_budgets[index] : nullptr;
+}
+
+std::string FormatBudget(std::size_t bytes) {
+    return bytes ? std::to_string(bytes) : std::string{ "-" };
+}
+
+} //End anonymous namespace
+
+bool MemoryBudgets::ParseByteCount(std::string text, std::size_t& bytes) {
+    //TrimWhitespace does not accept blank strings.
+    if(text.find_first_not_of(" \r\n\t\v\f") == std::string::npos) {
+        return false;
+    }
+    text = StringUtils::ToLowerCase(StringUtils::TrimWhitespace(text));
+    std::size_t scale = 1u;
+    auto strip_suffix = [&text](const std::string& suffix) {
+        if(text.size() > suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            text.erase(text.size() - suffix.size());
+            return true;
+        }
+        return false;
+    };
+    if(strip_suffix("gb") || strip_suffix("g")) {
+        scale = 1024u * 1024u * 1024u;
+    } else if(strip_suffix("mb") || strip_suffix("m")) {
+        scale = 1024u * 1024u;
+    } else if(strip_suffix("kb") || strip_suffix("k")) {
+        scale = 1024u;
+    } else {
+        strip_suffix("b");
+    }
+    if(text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    unsigned long long value = 0u;
+    try {
+        value = std::stoull(text);
+    } catch(...) {
+        return false;
+    }
+    //Reject counts that do not fit in size_t once scaled instead of letting them wrap.
+    if(value > (std::numeric_limits<std::size_t>::max)() / scale) {
+        return false;
+    }
+    bytes = static_cast<std::size_t>(value) * scale;
+    return true;
+}
+
+bool MemoryBudgets::ParseTag(const std::string& text, MemoryTag& tag) {
+    const auto name = StringUtils::ToLowerCase(text);
+    for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+        if(StringUtils::ToLowerCase(to_string(static_cast<MemoryTag>(i))) == name) {
+            tag = static_cast<MemoryTag>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MemoryBudgets::SetBudget(MemoryTag tag, const Budget& budget) {
+    std::scoped_lock<std::mutex> lock(g_budget_cs);
+    if(auto* state = GetState(tag)) {
+        state->budget = budget;
+    }
+}
+
+MemoryBudgets::Budget MemoryBudgets::GetBudget(MemoryTag tag) {
+    std::scoped_lock<std::mutex> lock(g_budget_cs);
+    if(const auto* state = GetState(tag)) {
+        return state->budget;
+    }
+    return Budget{};
+}
+
+void MemoryBudgets::LoadFromConfig(Config& config) {
+    for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+        const auto tag = static_cast<MemoryTag>(i);
+        const auto prefix = "memory_budget_" + StringUtils::ToLowerCase(to_string(tag));
+        auto budget = GetBudget(tag);
+        auto load = [&config](const std::string& key, std::size_t& bytes) {
+            if(!config.HasKey(key)) {
+                return;
+            }
+            std::string value{};
+            config.GetValue(key, value);
+            if(!ParseByteCount(value, bytes)) {
+                DebuggerPrintf("MemoryBudgets: ignoring malformed value \"%s\" for %s.\n", value.c_str(), key.c_str());
+            }
+        };
+        load(prefix + "_soft", budget.soft_bytes);
+        load(prefix + "_hard", budget.hard_bytes);
+        SetBudget(tag, budget);
+    }
+}
+
+Event<MemoryTag, std::size_t, std::size_t>& MemoryBudgets::OnSoftBudgetExceeded() {
+    static Event<MemoryTag, std::size_t, std::size_t> event{};
+    return event;
+}
+
+void MemoryBudgets::SetHardBudgetCallback(MemoryTag tag, hard_budget_cb_t callback) {
+    std::scoped_lock<std::mutex> lock(g_budget_cs);
+    if(auto* state = GetState(tag)) {
+        state->hard_callback = std::move(callback);
+    }
+}
+
+void MemoryBudgets::Check(MemoryTag tag, std::size_t liveBytes) {
+    bool fire_soft = false;
+    hard_budget_cb_t hard_callback{};
+    Budget budget{};
+    {
+        std::scoped_lock<std::mutex> lock(g_budget_cs);
+        auto* state = GetState(tag);
+        if(!state) {
+            return;
+        }
+        budget = state->budget;
+        const auto over_soft = budget.soft_bytes && budget.soft_bytes < liveBytes;
+        fire_soft = over_soft && !state->over_soft;
+        state->over_soft = over_soft;
+        if(budget.hard_bytes && budget.hard_bytes < liveBytes) {
+            hard_callback = state->hard_callback;
+        }
+    }
+    //Handlers run unlocked so they may change budgets or callbacks.
+    if(fire_soft) {
+        OnSoftBudgetExceeded().Trigger(tag, liveBytes, budget.soft_bytes);
+    }
+    if(hard_callback) {
+        hard_callback(tag, liveBytes, budget.hard_bytes);
+    }
+}
+
+MemoryBudgets::Report MemoryBudgets::GetReport() {
+    Report report{};
+    for(std::size_t i = 0; i < TAG_COUNT; ++i) {
+        const auto tag = static_cast<MemoryTag>(i);
+        const auto status = Memory::tag_status(tag);
+        report.rows.push_back(Report::Row{ tag, GetBudget(tag), status.live_bytes, status.peak_bytes });
+    }
+    return report;
+}
+
+std::ostream& operator<<(std::ostream& out, const MemoryBudgets::Report& report) {
+    out << std::left << std::setw(10) << "Tag"
+        << std::right << std::setw(14) << "Live" << std::setw(14) << "Peak"
+        << std::setw(14) << "Soft" << std::setw(14) << "Hard" << '\n';
+    for(const auto& row : report.rows) {
+        out << std::left << std::setw(10) << to_string(row.tag)
+            << std::right << std::setw(14) << row.live_bytes << std::setw(14) << row.peak_bytes
+            << std::setw(14) << FormatBudget(row.budget.soft_bytes) << std::setw(14) << FormatBudget(row.budget.hard_bytes);
+        if(row.budget.hard_bytes && row.budget.hard_bytes < row.live_bytes) {
+            out << "  OVER HARD";
+        } else if(row.budget.soft_bytes && row.budget.soft_bytes < row.live_bytes) {
+            out << "  over soft";
+        }
+        out << '\n';
+    }
+    return out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+//Per-tag byte budgets for tracked memory (TRACK_MEMORY builds).
+//Memory::tick compares each tag's live bytes against its budgets once per frame, on the ticking thread:
+//- Crossing the soft budget triggers OnSoftBudgetExceeded once; it re-arms when the tag drops back under.
+//- Over the hard budget, the tag's callback runs on every tick until the tag is back under, so a cache
+//  can evict a little each frame instead of growing until allocation fails.
+//Checks happen per tick, never inside operator new, so handlers are free to allocate and free.
+
+#include "Engine/Core/Event.hpp"
+
+#include "Engine/Profiling/Memory.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Config;
+class Console;
+
+class MemoryBudgets {
+public:
+    //0 means no budget.
+    struct Budget {
+        std::size_t soft_bytes = 0u;
+        std::size_t hard_bytes = 0u;
+    };
+
+    struct Report {
+        struct Row {
+            MemoryTag tag = MemoryTag::General;
+            Budget budget{};
+            std::size_t live_bytes = 0u;
+            //High-water mark of live bytes, sampled at each tick.
+            std::size_t peak_bytes = 0u;
+        };
+        std::vector<Row> rows{};
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    //Tag, live bytes, budget bytes.
+    using hard_budget_cb_t = std::function<void(MemoryTag, std::size_t, std::size_t)>;
+
+    static void SetBudget(MemoryTag tag, const Budget& budget);
+    static Budget GetBudget(MemoryTag tag);
+
+    //Reads memory_budget_<tag>_soft and memory_budget_<tag>_hard, e.g. memory_budget_renderer_hard=512MB.
+    //Values are bytes with an optional KB, MB or GB suffix. Tags without keys keep their budgets.
+    static void LoadFromConfig(Config& config);
+
+    //Subscribers are not synchronized: subscribe from the thread that calls Memory::tick.
+    static Event<MemoryTag, std::size_t, std::size_t>& OnSoftBudgetExceeded();
+    //One callback per tag; an empty function clears it.
+    static void SetHardBudgetCallback(MemoryTag tag, hard_budget_cb_t callback);
+
+    //Called by Memory::tick with the tag's live bytes.
+    static void Check(MemoryTag tag, std::size_t liveBytes);
+
+    static Report GetReport();
+
+    //membudget [tag soft hard]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    //Plain bytes, or a number with a KB, MB or GB suffix (powers of 1024). False if malformed or too large for size_t.
+    static bool ParseByteCount(std::string text, std::size_t& bytes);
+    //Case-insensitive tag name, as printed by to_string.
+    static bool ParseTag(const std::string& text, MemoryTag& tag);
+};
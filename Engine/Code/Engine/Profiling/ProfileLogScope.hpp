@@ -1,15 +1,14 @@
 #pragma once
 
 #include "Engine/Core/BuildConfig.hpp"
-#include "Engine/Core/TimeUtils.hpp"
-
-#include <chrono>
-#include <string>
 
+#include "Engine/Profiling/Profiler.hpp"
 
+//Records the enclosing scope in the frame Profiler while it is enabled.
 class ProfileLogScope {
 public:
-    explicit ProfileLogScope(const std::string& scopeName) noexcept;
+    //scopeName is kept by pointer: pass a string literal or __FUNCTION__.
+    explicit ProfileLogScope(const char* scopeName) noexcept;
     ~ProfileLogScope() noexcept;
 
     ProfileLogScope() = delete;
@@ -19,12 +18,24 @@ public:
     ProfileLogScope& operator=(ProfileLogScope&&) = delete;
 protected:
 private:
-    using time_point_t = std::chrono::time_point<std::chrono::steady_clock>;
-
-    std::string _scope_name{};
-    time_point_t _time_at_creation{};
+    //So toggling the profiler mid-scope never leaves an unmatched begin or end.
+    bool _recording = false;
 };
 
+inline ProfileLogScope::ProfileLogScope(const char* scopeName) noexcept
+    : _recording(Profiler::IsEnabled())
+{
+    if(_recording) {
+        Profiler::BeginScope(scopeName);
+    }
+}
+
+inline ProfileLogScope::~ProfileLogScope() noexcept {
+    if(_recording) {
+        Profiler::EndScope();
+    }
+}
+
 #if defined PROFILE_LOG_SCOPE || defined PROFILE_LOG_SCOPE_FUNCTION
 #undef PROFILE_LOG_SCOPE
 #undef PROFILE_LOG_SCOPE_FUNCTION
@@ -0,0 +1,399 @@
+#include "Engine/Profiling/Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <unordered_map>
+
+std::atomic_bool Profiler::_enabled{ false };
+std::mutex Profiler::_cs{};
+std::vector<std::unique_ptr<Profiler::ThreadRing>> Profiler::_rings{};
+thread_local Profiler::ThreadRing* Profiler::_thread_ring = nullptr;
+thread_local const char* Profiler::_thread_name = nullptr;
+Profiler::span_listener_t Profiler::_span_listener{};
+Profiler::frame_listener_t Profiler::_frame_listener{};
+
+namespace {
+
+//Consumer-side state for one thread, keyed by ThreadRing::thread_index. Guarded by Profiler::_cs.
+struct Collector {
+    struct OpenScope {
+        const char* name = nullptr;
+        std::uint64_t begin_ticks = 0u;
+        std::uint64_t child_ticks = 0u;
+    };
+    std::vector<OpenScope> open{};
+    Profiler::Node root{};
+};
+
+std::unordered_map<std::uint32_t, Collector> g_collectors{};
+//Indices are never reused, so a new thread is not merged with an exited one in GetAverage.
+std::uint32_t g_next_thread_index = 0u;
+std::vector<Profiler::Frame> g_history{};
+std::size_t g_history_next = 0u;
+std::uint64_t g_frame_id = 0u;
+std::uint64_t g_frame_begin = 0u;
+
+//PROFILE_BUILD sets the history length; other builds compile the scope macros out.
+#ifdef MAX_PROFILE_HISTORY
+constexpr std::size_t HISTORY_SIZE = static_cast<std::size_t>(MAX_PROFILE_HISTORY);
+#else
+constexpr std::size_t HISTORY_SIZE = 1u;
+#endif
+constexpr std::size_t DEFAULT_REPORT_DEPTH = 8u;
+
+bool IsSameName(const char* a, const char* b) {
+    return a == b || (a && b && std::strcmp(a, b) == 0);
+}
+
+Profiler::Node& FindOrAddChild(Profiler::Node& parent, const char* name) {
+    auto found = std::find_if(std::begin(parent.children), std::end(parent.children), [name](const Profiler::Node& child) { return IsSameName(child.name, name); });
+    if(found != std::end(parent.children)) {
+        return *found;
+    }
+    parent.children.push_back(Profiler::Node{});
+    parent.children.back().name = name;
+    return parent.children.back();
+}
+
+void MergeNode(Profiler::Node& into, const Profiler::Node& from) {
+    into.inclusive_ns += from.inclusive_ns;
+    into.exclusive_ns += from.exclusive_ns;
+    into.calls += from.calls;
+    for(const auto& child : from.children) {
+        MergeNode(FindOrAddChild(into, child.name), child);
+    }
+}
+
+void DivideNode(Profiler::Node& node, std::uint32_t divisor) {
+    node.inclusive_ns /= divisor;
+    node.exclusive_ns /= divisor;
+    for(auto& child : node.children) {
+        DivideNode(child, divisor);
+    }
+}
+
+void SortNode(Profiler::Node& node) {
+    std::sort(std::begin(node.children), std::end(node.children), [](const Profiler::Node& a, const Profiler::Node& b) { return a.inclusive_ns > b.inclusive_ns; });
+    for(auto& child : node.children) {
+        SortNode(child);
+    }
+}
+
+double ToMilliseconds(std::uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1'000'000.0;
+}
+
+void PrintNode(std::ostream& out, const Profiler::Node& node, std::size_t depth, std::uint64_t frame_ns, std::uint32_t frame_count) {
+    if(DEFAULT_REPORT_DEPTH < depth) {
+        return;
+    }
+    const auto label = std::string(2u * depth, ' ') + (node.name ? node.name : "?");
+    const auto percent = frame_ns ? 100.0 * static_cast<double>(node.inclusive_ns) / static_cast<double>(frame_ns) : 0.0;
+    out << std::left << std::setw(48) << label
+        << std::right << std::setw(12) << ToMilliseconds(node.inclusive_ns)
+        << std::setw(12) << ToMilliseconds(node.exclusive_ns)
+        << std::setw(12) << static_cast<double>(node.calls) / static_cast<double>(frame_count)
+        << std::setw(9) << percent << "%\n";
+    for(const auto& child : node.children) {
+        PrintNode(out, child, depth + 1u, frame_ns, frame_count);
+    }
+}
+
+} //End anonymous namespace
+
+void Profiler::ThreadRing::PushBegin(const char* name, std::uint64_t ticks) {
+    const auto head = _head.load(std::memory_order_relaxed);
+    //Room for this begin, its end, and the end of every scope already open.
+    const auto needed = std::uint64_t{ _open } + 2u;
+    if(_skipped || CAPACITY - (head - _tail.load(std::memory_order_acquire)) < needed) {
+        ++_skipped;
+        _dropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+    _records[head % CAPACITY] = Record{ name, ticks };
+    _head.store(head + 1u, std::memory_order_release);
+    ++_open;
+}
+
+void Profiler::ThreadRing::PushEnd(std::uint64_t ticks) {
+    if(_skipped) {
+        --_skipped;
+        return;
+    }
+    if(!_open) {
+        return;
+    }
+    const auto head = _head.load(std::memory_order_relaxed);
+    _records[head % CAPACITY] = Record{ nullptr, ticks };
+    _head.store(head + 1u, std::memory_order_release);
+    --_open;
+}
+
+template<typename F>
+void Profiler::ThreadRing::Drain(F&& f) {
+    auto tail = _tail.load(std::memory_order_relaxed);
+    const auto head = _head.load(std::memory_order_acquire);
+    for(; tail != head; ++tail) {
+        f(_records[tail % CAPACITY]);
+    }
+    _tail.store(tail, std::memory_order_release);
+}
+
+std::uint64_t Profiler::ThreadRing::TakeDroppedCount() {
+    return _dropped.exchange(0u, std::memory_order_relaxed);
+}
+
+double Profiler::Frame::Milliseconds() const {
+    const auto ticks = end_ticks < begin_ticks ? std::uint64_t{ 0u } : end_ticks - begin_ticks;
+    return static_cast<double>(ticks) * GetNanosecondsPerTick() / 1'000'000.0 / static_cast<double>(frame_count ? frame_count : 1u);
+}
+
+std::ostream& operator<<(std::ostream& out, const Profiler::Frame& frame) {
+    auto old_fmt = out.flags();
+    auto old_w = out.width();
+    auto old_p = out.precision();
+    const auto frame_ns = static_cast<std::uint64_t>(frame.Milliseconds() * 1'000'000.0);
+    out << std::fixed << std::setprecision(3);
+    if(frame.frame_count > 1u) {
+        out << "Average of " << frame.frame_count << " frames ending with frame " << frame.frame_id;
+    } else {
+        out << "Frame " << frame.frame_id;
+    }
+    out << ": " << frame.Milliseconds() << " ms";
+    if(frame.dropped_scopes) {
+        out << " (" << frame.dropped_scopes << " scopes dropped)";
+    }
+    out << '\n';
+    out << std::left << std::setw(48) << "Scope"
+        << std::right << std::setw(12) << "Incl (ms)"
+        << std::setw(12) << "Excl (ms)"
+        << std::setw(12) << "Calls"
+        << std::setw(10) << "Frame" << '\n';
+    for(const auto& thread : frame.threads) {
+        if(thread.root.children.empty()) {
+            continue;
+        }
+        out << "[" << (thread.thread_name.empty() ? "Thread " + std::to_string(thread.thread_index) : thread.thread_name) << "]\n";
+        for(const auto& child : thread.root.children) {
+            PrintNode(out, child, 0u, frame_ns, frame.frame_count ? frame.frame_count : 1u);
+        }
+    }
+    out.flags(old_fmt);
+    out.width(old_w);
+    out.precision(old_p);
+    return out;
+}
+
+void Profiler::Enable(bool enable) {
+    if(enable) {
+        //Calibrate before the first scope is timed rather than on the first EndFrame.
+        GetNanosecondsPerTick();
+    }
+    _enabled = enable;
+}
+
+void Profiler::SetThreadName(const char* name) {
+    thread_local std::string thread_name{};
+    std::scoped_lock<std::mutex> lock(_cs);
+    thread_name = name ? name : "";
+    _thread_name = thread_name.c_str();
+    if(_thread_ring) {
+        _thread_ring->thread_name = thread_name;
+    }
+}
+
+void Profiler::EndFrame() {
+    const auto ns_per_tick = GetNanosecondsPerTick();
+    auto to_ns = [ns_per_tick](std::uint64_t ticks) {
+        return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick);
+    };
+    std::vector<Span> spans{};
+    span_listener_t span_listener{};
+    frame_listener_t frame_listener{};
+    Frame finished{};
+    {
+        std::scoped_lock<std::mutex> lock(_cs);
+        span_listener = _span_listener;
+        frame_listener = _frame_listener;
+        Frame frame{};
+        frame.frame_id = g_frame_id++;
+        frame.begin_ticks = g_frame_begin ? g_frame_begin : Now();
+        for(auto& ring : _rings) {
+            //Read before draining: once set, the owning thread has pushed its last record.
+            const bool retired = ring->retired.load(std::memory_order_acquire);
+            auto& collector = g_collectors[ring->thread_index];
+            const auto thread_index = ring->thread_index;
+            const bool capture_spans = static_cast<bool>(span_listener);
+            ring->Drain([&collector, &to_ns, &spans, thread_index, capture_spans](const Record& record) {
+                if(record.name) {
+                    collector.open.push_back(Collector::OpenScope{ record.name, record.ticks, 0u });
+                    return;
+                }
+                //Only possible for scopes opened before a Reset.
+                if(collector.open.empty()) {
+                    return;
+                }
+                const auto scope = collector.open.back();
+                collector.open.pop_back();
+                //Timestamps taken on different cores may be slightly out of order.
+                const auto inclusive = record.ticks < scope.begin_ticks ? std::uint64_t{ 0u } : record.ticks - scope.begin_ticks;
+                const auto exclusive = scope.child_ticks < inclusive ? inclusive - scope.child_ticks : std::uint64_t{ 0u };
+                if(!collector.open.empty()) {
+                    collector.open.back().child_ticks += inclusive;
+                }
+                auto* node = &collector.root;
+                for(const auto& parent : collector.open) {
+                    node = &FindOrAddChild(*node, parent.name);
+                }
+                node = &FindOrAddChild(*node, scope.name);
+                node->inclusive_ns += to_ns(inclusive);
+                node->exclusive_ns += to_ns(exclusive);
+                ++node->calls;
+                if(capture_spans) {
+                    spans.push_back(Span{ scope.name, thread_index, scope.begin_ticks, record.ticks });
+                }
+            });
+            frame.dropped_scopes += ring->TakeDroppedCount();
+            ThreadTree tree{};
+            tree.thread_index = ring->thread_index;
+            tree.thread_name = ring->thread_name;
+            tree.root = std::move(collector.root);
+            collector.root = Node{};
+            SortNode(tree.root);
+            frame.threads.push_back(std::move(tree));
+            if(retired) {
+                g_collectors.erase(ring->thread_index);
+                ring.reset();
+            }
+        }
+        _rings.erase(std::remove(std::begin(_rings), std::end(_rings), nullptr), std::end(_rings));
+        frame.end_ticks = Now();
+        g_frame_begin = frame.end_ticks;
+        if(frame_listener) {
+            finished = frame;
+        }
+        if(g_history.size() < HISTORY_SIZE) {
+            g_history.push_back(std::move(frame));
+        } else {
+            g_history[g_history_next] = std::move(frame);
+        }
+        g_history_next = (g_history_next + 1u) % HISTORY_SIZE;
+    }
+    for(const auto& span : spans) {
+        span_listener(span);
+    }
+    if(frame_listener) {
+        frame_listener(finished);
+    }
+}
+
+std::vector<Profiler::Frame> Profiler::GetHistory() {
+    std::scoped_lock<std::mutex> lock(_cs);
+    std::vector<Frame> history{};
+    history.reserve(g_history.size());
+    const auto oldest = g_history.size() < HISTORY_SIZE ? 0u : g_history_next;
+    for(std::size_t i = 0u; i < g_history.size(); ++i) {
+        history.push_back(g_history[(oldest + i) % g_history.size()]);
+    }
+    return history;
+}
+
+Profiler::Frame Profiler::GetLastFrame() {
+    return GetAverage(1u);
+}
+
+Profiler::Frame Profiler::GetAverage(std::size_t frameCount) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    Frame result{};
+    const auto count = (std::min)(frameCount, g_history.size());
+    if(!count) {
+        result.frame_count = 0u;
+        return result;
+    }
+    const auto newest = (g_history_next + HISTORY_SIZE - 1u) % HISTORY_SIZE;
+    const auto oldest = (newest + HISTORY_SIZE + 1u - count) % HISTORY_SIZE;
+    result.frame_id = g_history[newest].frame_id;
+    result.begin_ticks = g_history[oldest].begin_ticks;
+    result.end_ticks = g_history[newest].end_ticks;
+    result.frame_count = static_cast<std::uint32_t>(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        const auto& frame = g_history[(oldest + i) % HISTORY_SIZE];
+        result.dropped_scopes += frame.dropped_scopes;
+        for(const auto& thread : frame.threads) {
+            auto found = std::find_if(std::begin(result.threads), std::end(result.threads), [&thread](const ThreadTree& t) { return t.thread_index == thread.thread_index; });
+            if(found == std::end(result.threads)) {
+                result.threads.push_back(ThreadTree{ thread.thread_index, thread.thread_name, Node{} });
+                found = std::end(result.threads) - 1;
+            }
+            MergeNode(found->root, thread.root);
+        }
+    }
+    for(auto& thread : result.threads) {
+        DivideNode(thread.root, result.frame_count);
+        SortNode(thread.root);
+    }
+    return result;
+}
+
+void Profiler::Reset() {
+    std::scoped_lock<std::mutex> lock(_cs);
+    for(auto& ring : _rings) {
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        ring->Drain([](const Record& /*record*/) { /* DO NOTHING */ });
+        ring->TakeDroppedCount();
+        if(retired) {
+            ring.reset();
+        }
+    }
+    _rings.erase(std::remove(std::begin(_rings), std::end(_rings), nullptr), std::end(_rings));
+    g_collectors.clear();
+    g_history.clear();
+    g_history_next = 0u;
+    g_frame_begin = 0u;
+}
+
+void Profiler::SetListeners(span_listener_t onSpan, frame_listener_t onFrame) {
+    std::scoped_lock<std::mutex> lock(_cs);
+    _span_listener = std::move(onSpan);
+    _frame_listener = std::move(onFrame);
+}
+
+double Profiler::GetNanosecondsPerTick() {
+    static const double ns_per_tick = []() {
+        const auto clock_start = std::chrono::steady_clock::now();
+        const auto tick_start = Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto tick_end = Now();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - clock_start;
+        return elapsed.count() / static_cast<double>(tick_end - tick_start);
+    }();
+    return ns_per_tick;
+}
+
+Profiler::ThreadRing& Profiler::GetThreadRing() {
+    if(!_thread_ring) {
+        //Retires the ring when the thread exits; the next EndFrame or Reset drains and frees it.
+        //Scopes opened by thread_local destructors that run after this one must not be profiled.
+        struct RingRetirer {
+            ThreadRing* ring = nullptr;
+            ~RingRetirer() {
+                if(ring) {
+                    ring->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+        thread_local RingRetirer retirer{};
+        std::scoped_lock<std::mutex> lock(_cs);
+        _rings.push_back(std::make_unique<ThreadRing>());
+        _thread_ring = _rings.back().get();
+        _thread_ring->thread_index = g_next_thread_index++;
+        if(_thread_name) {
+            _thread_ring->thread_name = _thread_name;
+        }
+        retirer.ring = _thread_ring;
+    }
+    return *_thread_ring;
+}
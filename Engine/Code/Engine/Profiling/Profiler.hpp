@@ -0,0 +1,162 @@
+#pragma once
+//Hierarchical instrumented frame profiler, fed by PROFILE_LOG_SCOPE and PROFILE_LOG_SCOPE_FUNCTION.
+//Each thread appends begin/end records to its own single-producer ring; nesting comes from the
+//order of the records, so a scope costs two timestamp reads and two ring writes and never locks.
+//EndFrame drains every ring into one call tree per thread for the frame (inclusive and exclusive
+//time, call counts) and keeps the last MAX_PROFILE_HISTORY frames. A scope belongs to the frame
+//whose EndFrame first sees it closed, so scopes on other threads may straddle a frame boundary.
+//Scope names are stored by pointer and must outlive the profiler: use string literals.
+
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef PLATFORM_WINDOWS
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+class Console;
+
+class Profiler {
+public:
+    struct Node {
+        const char* name = nullptr;
+        std::uint64_t inclusive_ns = 0u;
+        std::uint64_t exclusive_ns = 0u;
+        //Total over frame_count frames.
+        std::uint32_t calls = 0u;
+        std::vector<Node> children{};
+    };
+
+    struct ThreadTree {
+        std::uint32_t thread_index = 0u;
+        std::string thread_name{};
+        //Unnamed; its children are the thread's outermost scopes.
+        Node root{};
+    };
+
+    struct Frame {
+        std::uint64_t frame_id = 0u;
+        std::uint64_t begin_ticks = 0u;
+        std::uint64_t end_ticks = 0u;
+        //Frames merged into this one by GetAverage; times are per frame, calls are totals.
+        std::uint32_t frame_count = 1u;
+        std::uint64_t dropped_scopes = 0u;
+        std::vector<ThreadTree> threads{};
+        double Milliseconds() const;
+        friend std::ostream& operator<<(std::ostream& out, const Frame& frame);
+    };
+
+    //One closed scope, for capture tools that need the timeline rather than the tree.
+    struct Span {
+        const char* name = nullptr;
+        std::uint32_t thread_index = 0u;
+        std::uint64_t begin_ticks = 0u;
+        std::uint64_t end_ticks = 0u;
+    };
+
+    using span_listener_t = std::function<void(const Span&)>;
+    using frame_listener_t = std::function<void(const Frame&)>;
+
+    static void Enable(bool enable);
+    static bool IsEnabled();
+    //Shown in reports and trace exports. Call from the thread being named; the name is copied.
+    static void SetThreadName(const char* name);
+
+    //Prefer PROFILE_LOG_SCOPE; every BeginScope needs a matching EndScope on the same thread.
+    static void BeginScope(const char* name);
+    static void EndScope();
+
+    //Drains every thread's scopes into a new frame and appends it to the history. Call once per frame from one thread.
+    static void EndFrame();
+    //Oldest first, at most MAX_PROFILE_HISTORY frames.
+    static std::vector<Frame> GetHistory();
+    static Frame GetLastFrame();
+    //Merges the last frameCount frames, averaging times per frame.
+    static Frame GetAverage(std::size_t frameCount);
+    static void Reset();
+
+    //EndFrame passes every scope it drained, then the finished frame, to these on the calling thread
+    //after releasing the profiler's lock. Empty functions remove them.
+    static void SetListeners(span_listener_t onSpan, frame_listener_t onFrame);
+
+    //Profiler timestamps, shared with JobInstrumentation.
+    static std::uint64_t Now();
+    static double GetNanosecondsPerTick();
+
+    //profile [on|off|reset|avg N]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    struct Record {
+        //Null for an end record.
+        const char* name = nullptr;
+        std::uint64_t ticks = 0u;
+    };
+
+    //Single producer (the owning thread), single consumer (EndFrame, under _cs).
+    //A begin is dropped, with its end, when the ring could not also hold every scope still open,
+    //so the consumer always sees matched pairs.
+    class ThreadRing {
+    public:
+        void PushBegin(const char* name, std::uint64_t ticks);
+        void PushEnd(std::uint64_t ticks);
+        template<typename F>
+        void Drain(F&& f);
+        std::uint64_t TakeDroppedCount();
+
+        std::uint32_t thread_index = 0u;
+        std::string thread_name{};
+        //Set when the owning thread exits; the consumer frees the ring after its last drain.
+        std::atomic_bool retired{ false };
+    private:
+        static constexpr std::size_t CAPACITY = 16384u;
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+        std::array<Record, CAPACITY> _records{};
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _head{ 0u };
+        std::atomic<std::uint64_t> _dropped{ 0u };
+        //Producer only.
+        std::uint32_t _open = 0u;
+        std::uint32_t _skipped = 0u;
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> _tail{ 0u };
+    };
+
+    static ThreadRing& GetThreadRing();
+
+    static std::atomic_bool _enabled;
+    //Rings are created on a thread's first scope, so naming a thread costs nothing until then.
+    static thread_local ThreadRing* _thread_ring;
+    static thread_local const char* _thread_name;
+    static std::mutex _cs;
+    static std::vector<std::unique_ptr<ThreadRing>> _rings;
+    static span_listener_t _span_listener;
+    static frame_listener_t _frame_listener;
+};
+
+//Inline: these run on every profiled scope.
+inline bool Profiler::IsEnabled() {
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+inline std::uint64_t Profiler::Now() {
+    return __rdtsc();
+}
+
+inline void Profiler::BeginScope(const char* name) {
+    GetThreadRing().PushBegin(name, Now());
+}
+
+inline void Profiler::EndScope() {
+    GetThreadRing().PushEnd(Now());
+}
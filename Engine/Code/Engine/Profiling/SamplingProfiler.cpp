@@ -0,0 +1,346 @@
+#include "Engine/Profiling/SamplingProfiler.hpp"
+
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/FileUtils.hpp"
+
+#include "Engine/Profiling/StackTrace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(PROFILE_BUILD) && defined(PLATFORM_LINUX)
+#define SAMPLING_PROFILER_SIGPROF
+#include <cerrno>
+#include <csignal>
+#include <sys/time.h>
+#endif
+
+namespace {
+
+constexpr unsigned long MAX_SAMPLE_FRAMES = 64ul;
+constexpr std::size_t SLOT_COUNT = 4096u;
+constexpr unsigned int MAX_FREQUENCY_HZ = 10000u;
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds{ 10 };
+//The signal handler and the kernel's signal trampoline.
+constexpr unsigned long FRAMES_TO_SKIP = 2ul;
+
+enum class SlotState : std::uint32_t {
+    Empty
+    ,Writing
+    ,Full
+};
+
+struct Slot {
+    std::atomic<SlotState> state{ SlotState::Empty };
+    unsigned long frame_count = 0ul;
+    std::array<void*, MAX_SAMPLE_FRAMES> frames{};
+};
+
+struct FramesHash {
+    std::size_t operator()(const std::vector<void*>& frames) const noexcept {
+        std::size_t hash = 14695981039346656037ull;
+        for(auto* frame : frames) {
+            hash = (hash ^ reinterpret_cast<std::uintptr_t>(frame)) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+//Innermost frame first.
+using stack_counts_t = std::unordered_map<std::vector<void*>, std::uint64_t, FramesHash>;
+
+//Written by the signal handler, so it is never destroyed and is touched only through atomics until a slot is claimed.
+std::array<Slot, SLOT_COUNT> g_slots{};
+std::atomic<std::uint64_t> g_next_slot{ 0u };
+std::atomic<std::uint64_t> g_dropped{ 0u };
+std::atomic_bool g_running{ false };
+std::atomic<int> g_handlers_in_flight{ 0 };
+
+std::mutex g_profile_cs{};
+stack_counts_t g_stacks{};
+std::uint64_t g_sample_count = 0u;
+unsigned int g_frequency_hz = 0u;
+
+//Serializes Start and Stop.
+std::mutex g_control_cs{};
+std::mutex g_collector_cs{};
+std::condition_variable g_collector_signal{};
+bool g_collector_stopping = false;
+std::thread g_collector{};
+
+void Drain() {
+    std::scoped_lock<std::mutex> lock(g_profile_cs);
+    std::vector<void*> key{};
+    for(auto& slot : g_slots) {
+        if(slot.state.load(std::memory_order_acquire) != SlotState::Full) {
+            continue;
+        }
+        key.assign(std::begin(slot.frames), std::begin(slot.frames) + (std::min)(slot.frame_count, MAX_SAMPLE_FRAMES));
+        slot.state.store(SlotState::Empty, std::memory_order_release);
+        if(!key.empty()) {
+            ++g_stacks[key];
+            ++g_sample_count;
+        }
+    }
+}
+
+#ifdef SAMPLING_PROFILER_SIGPROF
+void CollectorLoop() {
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(g_collector_cs);
+            if(g_collector_signal.wait_for(lock, DRAIN_INTERVAL, [] { return g_collector_stopping; })) {
+                return;
+            }
+        }
+        Drain();
+    }
+}
+
+void OnProfilingSignal(int /*signal*/) {
+    const auto saved_errno = errno;
+    ++g_handlers_in_flight;
+    if(g_running) {
+        auto& slot = g_slots[g_next_slot.fetch_add(1u, std::memory_order_relaxed) % SLOT_COUNT];
+        auto expected = SlotState::Empty;
+        if(slot.state.compare_exchange_strong(expected, SlotState::Writing, std::memory_order_acquire)) {
+            slot.frame_count = StackTrace::CaptureFrames(FRAMES_TO_SKIP, MAX_SAMPLE_FRAMES, slot.frames.data(), nullptr);
+            slot.state.store(SlotState::Full, std::memory_order_release);
+        } else {
+            g_dropped.fetch_add(1u, std::memory_order_relaxed);
+        }
+    }
+    --g_handlers_in_flight;
+    errno = saved_errno;
+}
+
+bool SetTimer(unsigned int frequencyHz) {
+    itimerval timer{};
+    if(frequencyHz) {
+        //A zero period would disarm the timer instead of sampling as fast as possible.
+        const auto period_us = (std::max)(1000000u / frequencyHz, 1u);
+        timer.it_interval.tv_sec = period_us / 1000000u;
+        timer.it_interval.tv_usec = period_us % 1000000u;
+        timer.it_value = timer.it_interval;
+    }
+    return ::setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+bool InstallHandler() {
+    //Never uninstalled: a SIGPROF still pending after Stop would otherwise terminate the process.
+    static bool installed = false;
+    if(!installed) {
+        struct sigaction action{};
+        action.sa_handler = OnProfilingSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        installed = ::sigaction(SIGPROF, &action, nullptr) == 0;
+    }
+    return installed;
+}
+#endif
+
+void ClearProfile() {
+    std::scoped_lock<std::mutex> lock(g_profile_cs);
+    for(auto& slot : g_slots) {
+        auto expected = SlotState::Full;
+        slot.state.compare_exchange_strong(expected, SlotState::Empty, std::memory_order_acq_rel);
+    }
+    g_stacks.clear();
+    g_sample_count = 0u;
+    g_dropped = 0u;
+}
+
+void StopLocked() {
+#ifdef SAMPLING_PROFILER_SIGPROF
+    SetTimer(0u);
+#endif
+    g_running = false;
+    while(g_handlers_in_flight) {
+        std::this_thread::yield();
+    }
+    {
+        std::scoped_lock<std::mutex> lock(g_collector_cs);
+        g_collector_stopping = true;
+    }
+    g_collector_signal.notify_all();
+    if(g_collector.joinable()) {
+        g_collector.join();
+    }
+    Drain();
+}
+
+stack_counts_t CopyStacks() {
+    Drain();
+    std::scoped_lock<std::mutex> lock(g_profile_cs);
+    return g_stacks;
+}
+
+//Resolved frames read "file(line): symbol"; samples at different lines of one function belong together.
+std::string GetFunctionName(void* address) {
+    auto resolved = StackTrace::ResolveFrame(address);
+    if(const auto pos = resolved.find("): "); pos != std::string::npos) {
+        resolved.erase(0, pos + 3u);
+    }
+    return resolved;
+}
+
+class FunctionNames {
+public:
+    const std::string& Get(void* address) {
+        auto found = _names.find(address);
+        if(found == std::end(_names)) {
+            found = _names.emplace(address, GetFunctionName(address)).first;
+        }
+        return found->second;
+    }
+private:
+    std::unordered_map<void*, std::string> _names{};
+};
+
+} //End anonymous namespace
+
+bool SamplingProfiler::Start([[maybe_unused]]unsigned int frequencyHz) {
+#ifdef SAMPLING_PROFILER_SIGPROF
+    std::scoped_lock<std::mutex> control(g_control_cs);
+    if(g_running) {
+        return false;
+    }
+    //backtrace loads the unwinder on its first call, which must not happen inside the handler.
+    void* warmup[1]{};
+    StackTrace::CaptureFrames(0ul, 1ul, warmup, nullptr);
+    if(!InstallHandler()) {
+        return false;
+    }
+    ClearProfile();
+    {
+        std::scoped_lock<std::mutex> lock(g_profile_cs);
+        g_frequency_hz = std::clamp(frequencyHz, 1u, MAX_FREQUENCY_HZ);
+    }
+    {
+        std::scoped_lock<std::mutex> lock(g_collector_cs);
+        g_collector_stopping = false;
+    }
+    g_collector = std::thread(CollectorLoop);
+    g_running = true;
+    if(!SetTimer(g_frequency_hz)) {
+        StopLocked();
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SamplingProfiler::Stop() {
+    std::scoped_lock<std::mutex> control(g_control_cs);
+    if(g_running) {
+        StopLocked();
+    }
+}
+
+bool SamplingProfiler::IsRunning() {
+    return g_running;
+}
+
+void SamplingProfiler::Reset() {
+    ClearProfile();
+}
+
+SamplingProfiler::Report SamplingProfiler::GetReport(std::size_t topN) {
+    const auto stacks = CopyStacks();
+    Report report{};
+    {
+        std::scoped_lock<std::mutex> lock(g_profile_cs);
+        report.sample_count = g_sample_count;
+        report.frequency_hz = g_frequency_hz;
+    }
+    report.dropped_count = g_dropped;
+    FunctionNames names{};
+    std::unordered_map<std::string, FunctionStats> functions{};
+    std::vector<const std::string*> seen{};
+    for(const auto& [frames, count] : stacks) {
+        functions[names.Get(frames.front())].self_samples += count;
+        //Recursive functions count once per sample.
+        seen.clear();
+        for(auto* frame : frames) {
+            const auto& name = names.Get(frame);
+            if(std::none_of(std::begin(seen), std::end(seen), [&name](const std::string* other) { return *other == name; })) {
+                seen.push_back(&name);
+                functions[name].total_samples += count;
+            }
+        }
+    }
+    report.function_count = functions.size();
+    std::vector<FunctionStats> sorted{};
+    sorted.reserve(functions.size());
+    for(auto& [name, stats] : functions) {
+        stats.name = name;
+        sorted.push_back(std::move(stats));
+    }
+    const auto n = (std::min)(topN, sorted.size());
+    std::partial_sort(std::begin(sorted), std::begin(sorted) + n, std::end(sorted), [](const FunctionStats& a, const FunctionStats& b) {
+        return a.self_samples != b.self_samples ? a.self_samples > b.self_samples : a.total_samples > b.total_samples;
+    });
+    sorted.resize(n);
+    report.functions = std::move(sorted);
+    return report;
+}
+
+bool SamplingProfiler::WriteCollapsedStacks(const std::filesystem::path& filepath) {
+    const auto stacks = CopyStacks();
+    FunctionNames names{};
+    //Stacks that differ only in return addresses within the same functions fold into one line.
+    std::map<std::string, std::uint64_t> collapsed{};
+    std::string line{};
+    for(const auto& [frames, count] : stacks) {
+        line.clear();
+        for(auto iter = std::rbegin(frames); iter != std::rend(frames); ++iter) {
+            if(!line.empty()) {
+                line += ';';
+            }
+            auto name = names.Get(*iter);
+            std::replace(std::begin(name), std::end(name), ';', ':');
+            line += name;
+        }
+        collapsed[line] += count;
+    }
+    if(filepath.has_parent_path()) {
+        FileUtils::CreateFolders(filepath.parent_path().string());
+    }
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::trunc);
+    if(!file) {
+        return false;
+    }
+    for(const auto& [stack, count] : collapsed) {
+        file << stack << ' ' << count << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+std::ostream& operator<<(std::ostream& out, const SamplingProfiler::Report& report) {
+    out << report.sample_count << " samples at " << report.frequency_hz << " Hz";
+    out << " (" << report.dropped_count << " dropped), top " << report.functions.size() << " of " << report.function_count << " functions by self samples\n";
+    out << std::right << std::setw(10) << "Self" << std::setw(8) << "Self%" << std::setw(10) << "Total" << std::setw(8) << "Total%" << "  Function\n";
+    const auto percent = [&report](std::uint64_t samples) {
+        return report.sample_count ? 100.0 * static_cast<double>(samples) / static_cast<double>(report.sample_count) : 0.0;
+    };
+    out << std::fixed << std::setprecision(2);
+    for(const auto& function : report.functions) {
+        out << std::setw(10) << function.self_samples << std::setw(8) << percent(function.self_samples);
+        out << std::setw(10) << function.total_samples << std::setw(8) << percent(function.total_samples);
+        out << "  " << function.name << '\n';
+    }
+    return out;
+}
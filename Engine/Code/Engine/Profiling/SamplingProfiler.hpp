@@ -0,0 +1,56 @@
+#pragma once
+//Statistical CPU profiler for code that has no PROFILE_LOG_SCOPE (Linux profile builds).
+//A process CPU-time timer (ITIMER_PROF) raises SIGPROF on whichever thread is running, and the
+//handler captures that thread's return addresses with StackTrace::CaptureFrames into a fixed ring of
+//slots without allocating or locking. A collector thread drains the ring into per-stack counts.
+//Symbols are resolved only when a flat profile or a collapsed-stack file is built.
+//Elsewhere the interface compiles but Start always fails.
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Console;
+
+class SamplingProfiler {
+public:
+    struct FunctionStats {
+        std::string name{};
+        //Samples with the function as the innermost frame.
+        std::uint64_t self_samples = 0u;
+        //Samples with the function anywhere on the stack, counted once per sample.
+        std::uint64_t total_samples = 0u;
+    };
+
+    struct Report {
+        std::uint64_t sample_count = 0u;
+        //Samples lost because the collector fell a full ring behind.
+        std::uint64_t dropped_count = 0u;
+        unsigned int frequency_hz = 0u;
+        std::size_t function_count = 0u;
+        //At most the requested N, by self samples.
+        std::vector<FunctionStats> functions{};
+        friend std::ostream& operator<<(std::ostream& out, const Report& report);
+    };
+
+    //Discards the previous profile. The kernel's tick rate caps the effective frequency.
+    //False if already running or unsupported on this platform.
+    static bool Start(unsigned int frequencyHz = DEFAULT_FREQUENCY_HZ);
+    //Samples stay available for reports until the next Start or Reset.
+    static void Stop();
+    static bool IsRunning();
+
+    static Report GetReport(std::size_t topN);
+    //One "root;...;leaf count" line per distinct stack, the input flamegraph.pl and speedscope expect.
+    static bool WriteCollapsedStacks(const std::filesystem::path& filepath);
+    static void Reset();
+
+    //sampler [start [hz]|stop [file]|reset|flat [N]|collapsed [file]]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+    static constexpr unsigned int DEFAULT_FREQUENCY_HZ = 1000u;
+};
@@ -3,17 +3,28 @@
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+
+#ifdef PLATFORM_WINDOWS
 #include "Engine/Core/Win.hpp"
+#endif
 
 #include <cstdint>
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string_view>
+#include <unordered_map>
 
-#ifdef PROFILE_BUILD
+#if defined(PROFILE_BUILD) && defined(PLATFORM_WINDOWS)
+#define STACKTRACE_DBGHELP
+#elif defined(PROFILE_BUILD) && defined(PLATFORM_LINUX)
+#define STACKTRACE_EXECINFO
+#endif
+
+#ifdef STACKTRACE_DBGHELP
 #include <DbgHelp.h>
 
 static constexpr auto MAX_FILENAME_LENGTH = 1024u;
@@ -38,6 +49,17 @@ static SymFromAddr_t LSymFromAddr;
 static SymGetLineFromAddr64_t LSymGetLineFromAddr64;
 static SymCleanup_t LSymCleanup;
 
+#elif defined(STACKTRACE_EXECINFO)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
+#include <cstdlib>
+#include <filesystem>
+
+//Most frames CaptureFrames will skip, which bounds the size of its buffer.
+static constexpr auto MAX_SKIPPED_FRAMES = 32ul;
+
 #endif
 
 std::atomic_uint64_t StackTrace::_refs(0);
@@ -52,7 +74,7 @@ StackTrace::StackTrace()
 
 StackTrace::StackTrace([[maybe_unused]]unsigned long framesToSkip,
                        [[maybe_unused]]unsigned long framesToCapture) {
-#ifdef PROFILE_BUILD
+#ifdef STACKTRACE_DBGHELP
     if(!_refs) {
         Initialize();
     }
@@ -65,13 +87,20 @@ StackTrace::StackTrace([[maybe_unused]]unsigned long framesToSkip,
     _frame_count = (std::min)(count, MAX_FRAMES_PER_CALLSTACK);
     
     GetLines(this, MAX_CALLSTACK_LINES);
+#elif defined(STACKTRACE_EXECINFO)
+    _frame_count = CaptureFrames(1ul + framesToSkip, framesToCapture, _frames, &hash);
+    if(!_frame_count) {
+        DebuggerPrintf("StackTrace unavailable. All frames were skipped.\n");
+        return;
+    }
+    GetLines(this, _frame_count);
 #else
     DebuggerPrintf("StackTrace unavailable. Attempting to call StackTrace in non-profile build. \n");
 #endif
 }
 
 StackTrace::~StackTrace() {
-#ifdef PROFILE_BUILD
+#ifdef STACKTRACE_DBGHELP
     --_refs;
     if(!_refs) {
         Shutdown();
@@ -80,7 +109,7 @@ StackTrace::~StackTrace() {
 }
 
 void StackTrace::Initialize() {
-#ifdef PROFILE_BUILD
+#ifdef STACKTRACE_DBGHELP
     debugHelpModule = ::LoadLibraryA("DbgHelp.dll");
 
     LSymSetOptions = reinterpret_cast<SymSetOptions_t>(::GetProcAddress(debugHelpModule, "SymSetOptions"));
@@ -113,7 +142,12 @@ void StackTrace::Initialize() {
 
 void StackTrace::GetLines([[maybe_unused]]StackTrace* st,
                           [[maybe_unused]]unsigned long max_lines) {
-#ifndef PROFILE_BUILD
+#ifdef STACKTRACE_EXECINFO
+    const auto count = (std::min)(max_lines, st->_frame_count);
+    for(unsigned long i = 0; i < count; ++i) {
+        DebuggerPrintf("\t%s\n", ResolveFrame(st->_frames[i]).c_str());
+    }
+#elif !defined(STACKTRACE_DBGHELP)
     return;
 #else
     IMAGEHLP_LINE64 line_info{};
@@ -159,7 +193,7 @@ void StackTrace::GetLines([[maybe_unused]]StackTrace* st,
 }
 
 void StackTrace::Shutdown() {
-#ifdef PROFILE_BUILD
+#ifdef STACKTRACE_DBGHELP
     std::free(symbol);
     symbol = nullptr;
 
@@ -174,6 +208,113 @@ void StackTrace::Shutdown() {
 #endif
 }
 
+unsigned long StackTrace::CaptureFrames([[maybe_unused]]unsigned long framesToSkip,
+                                        [[maybe_unused]]unsigned long framesToCapture,
+                                        [[maybe_unused]]void** frames,
+                                        unsigned long* hash) {
+#ifdef STACKTRACE_DBGHELP
+    unsigned long captured_hash = 0;
+    const auto count = ::CaptureStackBackTrace(1ul + framesToSkip, (std::min)(framesToCapture, MAX_FRAMES_PER_CALLSTACK), frames, &captured_hash);
+    if(hash) {
+        *hash = captured_hash;
+    }
+    return count;
+#elif defined(STACKTRACE_EXECINFO)
+    //No allocation or locking, so this may run in a signal handler once backtrace has been called
+    //outside one (its first call loads the unwinder).
+    void* buffer[MAX_FRAMES_PER_CALLSTACK + MAX_SKIPPED_FRAMES];
+    const auto skip = (std::min)(1ul + framesToSkip, MAX_SKIPPED_FRAMES);
+    const auto requested = skip + (std::min)(framesToCapture, MAX_FRAMES_PER_CALLSTACK);
+    const auto captured = static_cast<unsigned long>((std::max)(0, ::backtrace(buffer, static_cast<int>(requested))));
+    const auto count = captured > skip ? captured - skip : 0ul;
+    std::copy_n(buffer + skip, count, frames);
+    if(hash) {
+        //FNV-1a, 32 bits like CaptureStackBackTrace's hash.
+        std::uint32_t captured_hash = 2166136261u;
+        for(unsigned long i = 0; i < count; ++i) {
+            captured_hash = (captured_hash ^ static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(frames[i]) >> 2)) * 16777619u;
+        }
+        *hash = captured_hash;
+    }
+    return count;
+#else
+    if(hash) {
+        *hash = 0;
+    }
+    return 0;
+#endif
+}
+
+std::string StackTrace::ResolveFrame(void* address) {
+#ifdef STACKTRACE_DBGHELP
+    static std::mutex cache_cs{};
+    static std::unordered_map<void*, std::string> cache{};
+    static bool holds_ref = false;
+    std::scoped_lock<std::mutex> cache_lock(cache_cs);
+    if(auto found = cache.find(address); found != std::end(cache)) {
+        return found->second;
+    }
+    //The cache keeps symbols loaded for the life of the process.
+    if(!holds_ref) {
+        if(!_refs) {
+            Initialize();
+        }
+        ++_refs;
+        holds_ref = true;
+    }
+    IMAGEHLP_LINE64 line_info{};
+    DWORD line_offset = 0;
+    line_info.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+    const auto ptr = reinterpret_cast<DWORD64>(address);
+    std::ostringstream ss;
+    {
+        std::scoped_lock<std::shared_mutex> _lock(_cs);
+        if(LSymFromAddr(process, ptr, nullptr, symbol)) {
+            if(LSymGetLineFromAddr64(process, ptr, &line_offset, &line_info)) {
+                ss << line_info.FileName << '(' << line_info.LineNumber << "): ";
+            } else {
+                ss << "N/A(0): ";
+            }
+            ss << std::string_view(symbol->Name, symbol->NameLen);
+        } else {
+            ss << "N/A(0): " << address;
+        }
+    }
+    return cache.emplace(address, ss.str()).first->second;
+#elif defined(STACKTRACE_EXECINFO)
+    static std::mutex cache_cs{};
+    static std::unordered_map<void*, std::string> cache{};
+    std::scoped_lock<std::mutex> cache_lock(cache_cs);
+    if(auto found = cache.find(address); found != std::end(cache)) {
+        return found->second;
+    }
+    //No line information here: "module(+offset): symbol", where the offset is what addr2line takes.
+    //Only exported symbols have names, so executables should link with -rdynamic.
+    std::ostringstream ss;
+    Dl_info info{};
+    if(::dladdr(address, &info) && info.dli_fname) {
+        const auto offset = reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+        ss << info.dli_fname << "(+0x" << std::hex << offset << std::dec << "): ";
+        if(info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            ss << (status == 0 && demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+        } else {
+            //Local symbols are not exported; group them by module rather than by address.
+            ss << '[' << std::filesystem::path(info.dli_fname).filename().string() << ']';
+        }
+    } else {
+        ss << "N/A(0): " << address;
+    }
+    return cache.emplace(address, ss.str()).first->second;
+#else
+    std::ostringstream ss;
+    ss << address;
+    return ss.str();
+#endif
+}
+
 bool StackTrace::operator!=(const StackTrace& rhs) {
     return !(*this == rhs);
 }
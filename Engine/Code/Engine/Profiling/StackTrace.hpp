@@ -15,6 +15,12 @@ public:
     ~StackTrace();
     bool operator==(const StackTrace& rhs);
     bool operator!=(const StackTrace& rhs);
+
+    //Return addresses only, no symbol work: cheap enough to call per allocation.
+    //Returns the number of frames written; hash identifies the captured stack.
+    static unsigned long CaptureFrames(unsigned long framesToSkip, unsigned long framesToCapture, void** frames, unsigned long* hash);
+    //"file(line): symbol" for one return address. Symbols load on first call; results are cached.
+    static std::string ResolveFrame(void* address);
 protected:
 private:
     static void Initialize();
@@ -0,0 +1,299 @@
+#include "Engine/Profiling/TraceExporter.hpp"
+
+#include "Engine/Core/FileUtils.hpp"
+
+#include "Engine/Profiling/JobInstrumentation.hpp"
+#include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/Profiler.hpp"
+
+#include "Thirdparty/nlohmann/json/json.hpp"
+
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//Trace "processes" that group the tracks.
+constexpr int FRAME_PID = 0;
+constexpr int SCOPE_PID = 1;
+constexpr int JOB_PID = 2;
+constexpr int MEMORY_PID = 3;
+
+enum class EventKind : std::uint8_t {
+    Scope
+    ,Job
+    ,Frame
+    ,ThreadName
+    ,Memory
+};
+
+struct TraceEvent {
+    EventKind kind = EventKind::Scope;
+    JobType job_type = JobType::Generic;
+    //Scope name; string literals only, so it is still valid on the writer thread.
+    const char* name = nullptr;
+    std::uint32_t tid = 0u;
+    std::uint32_t queue_depth = 0u;
+    std::uint64_t begin_ticks = 0u;
+    std::uint64_t end_ticks = 0u;
+    //Frame id, or the job's submit time.
+    std::uint64_t extra = 0u;
+    //Thread names only.
+    std::string text{};
+    //Memory counters only.
+    Memory::timeline_frame_t memory{};
+};
+
+struct Capture {
+    std::mutex cs{};
+    std::condition_variable signal{};
+    std::vector<TraceEvent> pending{};
+    bool stopping = false;
+    //Touched only by the frame listener, which runs on the EndFrame thread.
+    std::vector<bool> named_scope_threads{};
+    //Touched only by the job listener, which JobInstrumentation serializes.
+    std::vector<bool> named_job_threads{};
+    //Touched only by the frame listener.
+    std::size_t next_memory_frame = 0u;
+    //Writer thread only.
+    std::ofstream file{};
+    bool first_event = true;
+    std::thread writer{};
+    std::uint64_t start_ticks = 0u;
+    double us_per_tick = 0.0;
+    //Restored by Stop.
+    bool profiler_was_enabled = false;
+    bool jobs_were_enabled = false;
+    std::uint32_t job_sample_interval = 1u;
+};
+
+std::mutex g_capture_cs{};
+//Listeners hold their own reference, so a capture outlives any EndFrame still delivering to it.
+std::shared_ptr<Capture> g_capture{};
+
+double ToMicroseconds(const Capture& capture, std::uint64_t ticks) {
+    return static_cast<double>(ticks - capture.start_ticks) * capture.us_per_tick;
+}
+
+double ToDuration(const Capture& capture, std::uint64_t begin, std::uint64_t end) {
+    return end < begin ? 0.0 : static_cast<double>(end - begin) * capture.us_per_tick;
+}
+
+nlohmann::json ToJson(const Capture& capture, const TraceEvent& event) {
+    switch(event.kind) {
+    case EventKind::Scope:
+        return nlohmann::json{ {"name", event.name}, {"cat", "scope"}, {"ph", "X"}, {"pid", SCOPE_PID}, {"tid", event.tid}
+                             , {"ts", ToMicroseconds(capture, event.begin_ticks)}, {"dur", ToDuration(capture, event.begin_ticks, event.end_ticks)} };
+    case EventKind::Job:
+        return nlohmann::json{ {"name", JobInstrumentation::GetJobTypeName(event.job_type)}, {"cat", "job"}, {"ph", "X"}, {"pid", JOB_PID}, {"tid", event.tid}
+                             , {"ts", ToMicroseconds(capture, event.begin_ticks)}, {"dur", ToDuration(capture, event.begin_ticks, event.end_ticks)}
+                             , {"args", { {"wait_us", ToDuration(capture, event.extra, event.begin_ticks)}, {"queue_depth", event.queue_depth} } } };
+    case EventKind::Frame:
+        return nlohmann::json{ {"name", "Frame " + std::to_string(event.extra)}, {"cat", "frame"}, {"ph", "X"}, {"pid", FRAME_PID}, {"tid", 0}
+                             , {"ts", ToMicroseconds(capture, event.begin_ticks)}, {"dur", ToDuration(capture, event.begin_ticks, event.end_ticks)} };
+    case EventKind::ThreadName:
+        return nlohmann::json{ {"name", "thread_name"}, {"ph", "M"}, {"pid", event.extra}, {"tid", event.tid}, {"args", { {"name", event.text} } } };
+    default:
+        return nlohmann::json{};
+    }
+}
+
+void WriteEvent(Capture& capture, const nlohmann::json& event) {
+    capture.file << (capture.first_event ? "\n" : ",\n") << event.dump();
+    capture.first_event = false;
+}
+
+void WriteProcessName(Capture& capture, int pid, const char* name) {
+    WriteEvent(capture, nlohmann::json{ {"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"args", { {"name", name} } } });
+    WriteEvent(capture, nlohmann::json{ {"name", "process_sort_index"}, {"ph", "M"}, {"pid", pid}, {"args", { {"sort_index", pid} } } });
+}
+
+//Counters hold their value until the next sample, so each frame's sample is placed at the frame's start.
+void WriteMemoryCounters(Capture& capture, const TraceEvent& event) {
+    const auto& memory = event.memory;
+    const auto ts = ToMicroseconds(capture, memory.begin_ticks);
+    WriteEvent(capture, nlohmann::json{ {"name", "Bytes per frame"}, {"ph", "C"}, {"pid", MEMORY_PID}, {"ts", ts}
+                                      , {"args", { {"allocated", memory.alloc_bytes}, {"freed", memory.free_bytes} } } });
+    WriteEvent(capture, nlohmann::json{ {"name", "Allocations per frame"}, {"ph", "C"}, {"pid", MEMORY_PID}, {"ts", ts}
+                                      , {"args", { {"allocs", memory.allocs}, {"frees", memory.frees} } } });
+    WriteEvent(capture, nlohmann::json{ {"name", "Resident bytes"}, {"ph", "C"}, {"pid", MEMORY_PID}, {"ts", ts}
+                                      , {"args", { {"live", memory.live_bytes}, {"peak_working_set", memory.peak_working_set} } } });
+}
+
+void WriterLoop(std::shared_ptr<Capture> capture) {
+    auto& file = capture->file;
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    WriteProcessName(*capture, FRAME_PID, "Frames");
+    WriteProcessName(*capture, SCOPE_PID, "Profiler scopes");
+    WriteProcessName(*capture, JOB_PID, "Jobs");
+    WriteProcessName(*capture, MEMORY_PID, "Memory");
+    std::vector<TraceEvent> batch{};
+    for(;;) {
+        {
+            std::unique_lock<std::mutex> lock(capture->cs);
+            capture->signal.wait(lock, [&capture]() { return capture->stopping || !capture->pending.empty(); });
+            batch.swap(capture->pending);
+            if(batch.empty() && capture->stopping) {
+                break;
+            }
+        }
+        for(const auto& event : batch) {
+            if(event.kind != EventKind::ThreadName && event.begin_ticks < capture->start_ticks) {
+                continue;
+            }
+            if(event.kind == EventKind::Memory) {
+                WriteMemoryCounters(*capture, event);
+                continue;
+            }
+            WriteEvent(*capture, ToJson(*capture, event));
+            if(event.kind == EventKind::Frame) {
+                WriteEvent(*capture, nlohmann::json{ {"name", "Frame " + std::to_string(event.extra)}, {"cat", "frame"}, {"ph", "i"}, {"s", "g"}, {"pid", FRAME_PID}, {"tid", 0}, {"ts", ToMicroseconds(*capture, event.end_ticks)} });
+            }
+        }
+        batch.clear();
+        file.flush();
+    }
+    file << "\n]}\n";
+    file.close();
+}
+
+void Push(Capture& capture, TraceEvent&& event) {
+    std::scoped_lock<std::mutex> lock(capture.cs);
+    capture.pending.push_back(std::move(event));
+}
+
+void OnJob(Capture& capture, const JobInstrumentation::Span& span) {
+    const auto track = span.worker_index == JobInstrumentation::NOT_A_WORKER ? std::size_t{ 0u } : std::size_t{ span.worker_index } + 1u;
+    if(capture.named_job_threads.size() <= track) {
+        capture.named_job_threads.resize(track + 1u, false);
+    }
+    if(!capture.named_job_threads[track]) {
+        capture.named_job_threads[track] = true;
+        TraceEvent name{};
+        name.kind = EventKind::ThreadName;
+        name.tid = span.worker_index;
+        name.extra = JOB_PID;
+        name.text = track ? "Worker " + std::to_string(span.worker_index) : std::string{ "Other threads" };
+        Push(capture, std::move(name));
+    }
+    TraceEvent event{};
+    event.kind = EventKind::Job;
+    event.job_type = span.type;
+    event.tid = span.worker_index;
+    event.queue_depth = span.queue_depth;
+    event.begin_ticks = span.start_ticks;
+    event.end_ticks = span.end_ticks;
+    event.extra = span.submit_ticks;
+    Push(capture, std::move(event));
+}
+
+void OnFrame(Capture& capture, const Profiler::Frame& frame) {
+    JobInstrumentation::Collect();
+    for(const auto& thread : frame.threads) {
+        if(capture.named_scope_threads.size() <= thread.thread_index) {
+            capture.named_scope_threads.resize(thread.thread_index + 1u, false);
+        }
+        if(capture.named_scope_threads[thread.thread_index]) {
+            continue;
+        }
+        capture.named_scope_threads[thread.thread_index] = true;
+        TraceEvent event{};
+        event.kind = EventKind::ThreadName;
+        event.tid = thread.thread_index;
+        event.extra = SCOPE_PID;
+        event.text = thread.thread_name.empty() ? "Thread " + std::to_string(thread.thread_index) : thread.thread_name;
+        Push(capture, std::move(event));
+    }
+    //Memory::tick runs just before Profiler::EndFrame, so this is usually the frame that just ended.
+    for(const auto& memory : Memory::timeline(capture.next_memory_frame)) {
+        capture.next_memory_frame = memory.frame_id + 1u;
+        TraceEvent event{};
+        event.kind = EventKind::Memory;
+        event.begin_ticks = memory.begin_ticks;
+        event.memory = memory;
+        Push(capture, std::move(event));
+    }
+    TraceEvent event{};
+    event.kind = EventKind::Frame;
+    event.begin_ticks = frame.begin_ticks;
+    event.end_ticks = frame.end_ticks;
+    event.extra = frame.frame_id;
+    Push(capture, std::move(event));
+    capture.signal.notify_one();
+}
+
+} //End anonymous namespace
+
+bool TraceExporter::Start(const std::filesystem::path& filepath) {
+    std::scoped_lock<std::mutex> lock(g_capture_cs);
+    if(g_capture) {
+        return false;
+    }
+    if(filepath.has_parent_path()) {
+        FileUtils::CreateFolders(filepath.parent_path().string());
+    }
+    auto capture = std::make_shared<Capture>();
+    capture->file.open(filepath, std::ios_base::out | std::ios_base::trunc);
+    if(!capture->file) {
+        return false;
+    }
+    capture->profiler_was_enabled = Profiler::IsEnabled();
+    capture->jobs_were_enabled = JobInstrumentation::IsEnabled();
+    capture->job_sample_interval = JobInstrumentation::GetSampleInterval();
+    Profiler::Enable(true);
+    JobInstrumentation::Enable(true);
+    //Drop anything recorded before the capture so the first frame is not charged for it.
+    JobInstrumentation::Collect();
+    JobInstrumentation::SetSampleInterval(1u);
+    capture->us_per_tick = Profiler::GetNanosecondsPerTick() / 1000.0;
+    capture->start_ticks = Profiler::Now();
+    JobInstrumentation::SetSpanListener([capture](const JobInstrumentation::Span& span) { OnJob(*capture, span); });
+    Profiler::SetListeners(
+        [capture](const Profiler::Span& span) {
+            TraceEvent event{};
+            event.kind = EventKind::Scope;
+            event.name = span.name;
+            event.tid = span.thread_index;
+            event.begin_ticks = span.begin_ticks;
+            event.end_ticks = span.end_ticks;
+            Push(*capture, std::move(event));
+        },
+        [capture](const Profiler::Frame& frame) { OnFrame(*capture, frame); });
+    capture->writer = std::thread(WriterLoop, capture);
+    g_capture = std::move(capture);
+    return true;
+}
+
+void TraceExporter::Stop() {
+    std::shared_ptr<Capture> capture{};
+    {
+        std::scoped_lock<std::mutex> lock(g_capture_cs);
+        capture = std::move(g_capture);
+    }
+    if(!capture) {
+        return;
+    }
+    Profiler::SetListeners({}, {});
+    //Jobs finished since the last frame are still worth keeping.
+    JobInstrumentation::Collect();
+    JobInstrumentation::SetSpanListener({});
+    JobInstrumentation::SetSampleInterval(capture->job_sample_interval);
+    JobInstrumentation::Enable(capture->jobs_were_enabled);
+    Profiler::Enable(capture->profiler_was_enabled);
+    {
+        std::scoped_lock<std::mutex> lock(capture->cs);
+        capture->stopping = true;
+    }
+    capture->signal.notify_one();
+    capture->writer.join();
+}
+
+bool TraceExporter::IsCapturing() {
+    std::scoped_lock<std::mutex> lock(g_capture_cs);
+    return static_cast<bool>(g_capture);
+}
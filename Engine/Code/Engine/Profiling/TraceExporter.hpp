@@ -0,0 +1,27 @@
+#pragma once
+//Captures profiler scopes, JobSystem job spans, FileLogger flushes, frame markers and per-frame
+//memory counters to a trace-event JSON file for chrome://tracing or ui.perfetto.dev.
+//While capturing, Profiler::EndFrame hands the exporter each frame's scopes, and the exporter drains
+//JobInstrumentation and the Memory timeline at the same point. Events are queued as small records; a writer thread turns
+//them into JSON and appends them to the file, so memory holds about one frame of events however long
+//the capture runs. Profiler::EndFrame must be called every frame while capturing.
+
+#include <filesystem>
+
+class Console;
+
+class TraceExporter {
+public:
+    //Enables the Profiler and records every job while capturing; both are restored by Stop.
+    //False if a capture is already running or the file cannot be opened.
+    static bool Start(const std::filesystem::path& filepath);
+    //Writes everything queued and closes the file. Does nothing when not capturing.
+    static void Stop();
+    static bool IsCapturing();
+
+    //trace [start [file]|stop]
+    static void RegisterConsoleCommands(Console& console);
+
+protected:
+private:
+};
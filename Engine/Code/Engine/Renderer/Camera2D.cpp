@@ -12,19 +12,19 @@ void Camera2D::SetupView(const Vector2& leftBottom, const Vector2& rightTop, con
 
 void Camera2D::CalcViewProjectionMatrix() {
     view_projection_matrix = projection_matrix * view_matrix;
-    inv_view_projection_matrix = Matrix4::CalculateInverse(view_projection_matrix);
+    inv_view_projection_matrix = Matrix4::CalculateInverseAffine(view_projection_matrix);
 }
 
 void Camera2D::CalcProjectionMatrix() {
     projection_matrix = Matrix4::CreateDXOrthographicProjection(leftBottom_view.x, rightTop_view.x, leftBottom_view.y, rightTop_view.y, nearFar_distance.x, nearFar_distance.y);
-    inv_projection_matrix = Matrix4::CalculateInverse(projection_matrix);
+    inv_projection_matrix = Matrix4::CalculateInverseAffine(projection_matrix);
 }
 
 void Camera2D::CalcViewMatrix() {
     Matrix4 vT = Matrix4::CreateTranslationMatrix(-position);
     Matrix4 vR = Matrix4::Create2DRotationDegreesMatrix(orientation_degrees);
     view_matrix = vT * vR;
-    inv_view_matrix = Matrix4::CalculateInverse(view_matrix);
+    inv_view_matrix = Matrix4::CalculateInverseRigid(view_matrix);
 }
 
 void Camera2D::Update(TimeUtils::FPSeconds deltaSeconds) {
@@ -84,7 +84,7 @@ void Camera3D::CalcViewMatrix() {
     Matrix4 vT = Matrix4::CreateTranslationMatrix(-position);
     Matrix4 vQ = rotation_matrix;
     view_matrix = vQ * vT;
-    inv_view_matrix = Matrix4::CalculateInverse(view_matrix);
+    inv_view_matrix = Matrix4::CalculateInverseRigid(view_matrix);
 }
 
 void Camera3D::CalcRotationMatrix() {
@@ -15,6 +15,7 @@ public:
     virtual ~IndexBuffer();
 
     void Update(RHIDeviceContext* context, const buffer_t& buffer);
+    void Update(RHIDeviceContext* context, const arraybuffer_t* data, std::size_t count);
 
 protected:
 private:
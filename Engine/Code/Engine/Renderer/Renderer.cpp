@@ -15,6 +15,8 @@
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/OBB2.hpp"
 #include "Engine/Math/Vector2.hpp"
+#include "Engine/Profiling/FrameStats.hpp"
+#include "Engine/Profiling/Memory.hpp"
 
 #include "Engine/Profiling/ProfileLogScope.hpp"
 
@@ -187,6 +189,7 @@ Renderer::~Renderer() {
 }
 
 void Renderer::Initialize(bool headless /*= false*/) {
+    MEMORY_TAG_SCOPE(Renderer);
     _rhi_instance = RHIInstance::CreateInstance();
     _rhi_device = _rhi_instance->CreateDevice();
     if(headless) {
@@ -247,14 +250,18 @@ void Renderer::CreateAndRegisterDefaultDepthStencil() {
 }
 
 void Renderer::BeginFrame() {
-    /* DO NOTHING */
+    MEMORY_TAG_SCOPE(Renderer);
+    _frame_arena.BeginFrame();
 }
 
 void Renderer::Update(TimeUtils::FPSeconds deltaSeconds) {
+    MEMORY_TAG_SCOPE(Renderer);
     UpdateSystemTime(deltaSeconds);
 }
 
 void Renderer::UpdateGameTime(TimeUtils::FPSeconds deltaSeconds) {
+    //deltaSeconds may be scaled, so FrameStats measures the wall-clock time between calls itself.
+    FrameStats::MarkFrame();
     _time_data.game_time += deltaSeconds.count();
     _time_data.game_frame_time = deltaSeconds.count();
     _time_cb->Update(_rhi_context, &_time_data);
@@ -273,6 +280,7 @@ void Renderer::Render() const {
 }
 
 void Renderer::EndFrame() {
+    MEMORY_TAG_SCOPE(Renderer);
     Present();
 }
 
@@ -628,6 +636,21 @@ void Renderer::DrawIndexed(const PrimitiveType& topology, const std::vector<Vert
     DrawIndexed(topology, _temp_vbo, _temp_ibo, vertex_count, startVertex, baseVertexLocation);
 }
 
+void Renderer::Draw(const PrimitiveType& topology, const transient_vbo_t& vbo) {
+    UpdateVbo(vbo.data(), vbo.size());
+    Draw(topology, _temp_vbo, vbo.size());
+}
+
+void Renderer::DrawIndexed(const PrimitiveType& topology, const transient_vbo_t& vbo, const transient_ibo_t& ibo) {
+    UpdateVbo(vbo.data(), vbo.size());
+    UpdateIbo(ibo.data(), ibo.size());
+    DrawIndexed(topology, _temp_vbo, _temp_ibo, ibo.size());
+}
+
+std::pmr::memory_resource* Renderer::GetFrameArena() {
+    return &_frame_arena.GetCurrent();
+}
+
 void Renderer::SetLightingEyePosition(const Vector3& position) {
     _lighting_data.eye_position = Vector4(position, 1.0f);
     _lighting_cb->Update(_rhi_context, &_lighting_data);
@@ -851,10 +874,10 @@ void Renderer::DrawIndexed(const PrimitiveType& topology, VertexBuffer* vbo, Ind
 }
 
 void Renderer::DrawPoint2D(float pointX, float pointY, const Rgba& color /*= Rgba::WHITE*/) {
-    std::vector<Vertex3D> vbo{};
+    transient_vbo_t vbo(GetFrameArena());
     vbo.reserve(1);
     vbo.emplace_back(Vector3(pointX, pointY, 0.0f), color);
-    std::vector<unsigned int> ibo{};
+    transient_ibo_t ibo(GetFrameArena());
     ibo.reserve(1);
     ibo.push_back(0);
     DrawIndexed(PrimitiveType::Points, vbo, ibo);
@@ -868,13 +891,13 @@ void Renderer::DrawLine2D(float startX, float startY, float endX, float endY, co
     if(!use_thickness) {
         Vertex3D start = Vertex3D(Vector3(Vector2(startX, startY), 0.0f), color, Vector2::ZERO);
         Vertex3D end = Vertex3D(Vector3(Vector2(endX, endY), 0.0f), color, Vector2::ONE);
-        std::vector<Vertex3D> vbo = {
+        transient_vbo_t vbo({
             start
             , end
-        };
-        std::vector<unsigned int> ibo = {
+        }, GetFrameArena());
+        transient_ibo_t ibo({
             0, 1
-        };
+        }, GetFrameArena());
         DrawIndexed(PrimitiveType::Lines, vbo, ibo);
         return;
     }
@@ -907,16 +930,16 @@ void Renderer::DrawQuad2D(float left, float bottom, float right, float top, cons
     Vector2 uv_lb = Vector2(texCoords.x, texCoords.w);
     Vector2 uv_rt = Vector2(texCoords.z, texCoords.y);
     Vector2 uv_rb = Vector2(texCoords.z, texCoords.w);
-    std::vector<Vertex3D> vbo = {
+    transient_vbo_t vbo({
         Vertex3D(v_lb, color, uv_lb)
         ,Vertex3D(v_lt, color, uv_lt)
         ,Vertex3D(v_rt, color, uv_rt)
         ,Vertex3D(v_rb, color, uv_rb)
-    };
-    std::vector<unsigned int> ibo = {
+    }, GetFrameArena());
+    transient_ibo_t ibo({
         0, 1, 2
         , 0, 2, 3
-    };
+    }, GetFrameArena());
     DrawIndexed(PrimitiveType::Triangles, vbo, ibo);
 
 }
@@ -1159,9 +1182,9 @@ void Renderer::DrawTextLine(const KerningFont* font, const std::string& text, co
     auto texture_w = static_cast<float>(font->GetCommonDef().scale.x);
     auto texture_h = static_cast<float>(font->GetCommonDef().scale.y);
     std::size_t text_size = text.size();
-    std::vector<Vertex3D> vbo;
+    transient_vbo_t vbo(GetFrameArena());
     vbo.reserve(text_size * 4);
-    std::vector<unsigned int> ibo;
+    transient_ibo_t ibo(GetFrameArena());
     ibo.reserve(text_size * 6);
 
     for(auto text_iter = text.begin(); text_iter != text.end(); /* DO NOTHING */) {
@@ -2946,6 +2969,7 @@ void Renderer::RegisterShaderProgram(const std::string& name, ShaderProgram * sp
 }
 
 void Renderer::UpdateVbo(const VertexBuffer::buffer_t& vbo) {
+    MEMORY_TAG_SCOPE(Renderer);
     if(_current_vbo_size < vbo.size()) {
         delete _temp_vbo;
         _temp_vbo = _rhi_device->CreateVertexBuffer(vbo, BufferUsage::Dynamic, BufferBindUsage::Vertex_Buffer);
@@ -2954,7 +2978,19 @@ void Renderer::UpdateVbo(const VertexBuffer::buffer_t& vbo) {
     _temp_vbo->Update(_rhi_context, vbo);
 }
 
+void Renderer::UpdateVbo(const Vertex3D* vbo, std::size_t vertex_count) {
+    MEMORY_TAG_SCOPE(Renderer);
+    if(_current_vbo_size < vertex_count) {
+        delete _temp_vbo;
+        //Growing is rare; the copy only seeds the new buffer's initial contents.
+        _temp_vbo = _rhi_device->CreateVertexBuffer(VertexBuffer::buffer_t(vbo, vbo + vertex_count), BufferUsage::Dynamic, BufferBindUsage::Vertex_Buffer);
+        _current_vbo_size = vertex_count;
+    }
+    _temp_vbo->Update(_rhi_context, vbo, vertex_count);
+}
+
 void Renderer::UpdateIbo(const IndexBuffer::buffer_t& ibo) {
+    MEMORY_TAG_SCOPE(Renderer);
     if(_current_ibo_size < ibo.size()) {
         delete _temp_ibo;
         _temp_ibo = _rhi_device->CreateIndexBuffer(ibo, BufferUsage::Dynamic, BufferBindUsage::Index_Buffer);
@@ -2963,6 +2999,16 @@ void Renderer::UpdateIbo(const IndexBuffer::buffer_t& ibo) {
     _temp_ibo->Update(_rhi_context, ibo);
 }
 
+void Renderer::UpdateIbo(const unsigned int* ibo, std::size_t index_count) {
+    MEMORY_TAG_SCOPE(Renderer);
+    if(_current_ibo_size < index_count) {
+        delete _temp_ibo;
+        _temp_ibo = _rhi_device->CreateIndexBuffer(IndexBuffer::buffer_t(ibo, ibo + index_count), BufferUsage::Dynamic, BufferBindUsage::Index_Buffer);
+        _current_ibo_size = index_count;
+    }
+    _temp_ibo->Update(_rhi_context, ibo, index_count);
+}
+
 RHIDeviceContext* Renderer::GetDeviceContext() const {
     return _rhi_context;
 }
@@ -9,6 +9,8 @@
 #include "Engine/Math/IntVector2.hpp"
 #include "Engine/Math/Matrix4.hpp"
 
+#include "Engine/Memory/FrameArena.hpp"
+
 #include "Engine/Renderer/Camera3D.hpp"
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Renderer/RenderTargetStack.hpp"
@@ -19,6 +21,7 @@
 
 #include <filesystem>
 #include <map>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -127,6 +130,11 @@ struct ComputeJob {
 
 class Renderer {
 public:
+    //Immediate-mode geometry built in the frame arena. It needs no freeing and stays valid
+    //until the BeginFrame after next; see GetFrameArena.
+    using transient_vbo_t = std::pmr::vector<Vertex3D>;
+    using transient_ibo_t = std::pmr::vector<unsigned int>;
+
     Renderer() = default;
     Renderer(unsigned int width, unsigned int height);
     ~Renderer();
@@ -232,6 +240,11 @@ public:
     void Draw(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, std::size_t vertex_count);
     void DrawIndexed(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo);
     void DrawIndexed(const PrimitiveType& topology, const std::vector<Vertex3D>& vbo, const std::vector<unsigned int>& ibo, std::size_t vertex_count, std::size_t startVertex = 0, std::size_t baseVertexLocation = 0);
+    void Draw(const PrimitiveType& topology, const transient_vbo_t& vbo);
+    void DrawIndexed(const PrimitiveType& topology, const transient_vbo_t& vbo, const transient_ibo_t& ibo);
+
+    //Reset at BeginFrame. Pass to transient_vbo_t/transient_ibo_t or any other pmr container.
+    std::pmr::memory_resource* GetFrameArena();
 
     void SetLightingEyePosition(const Vector3& position);
     void SetAmbientLight(const Rgba& ambient);
@@ -345,6 +358,9 @@ public:
     void CopyTexture(Texture* src, Texture* dst);
 protected:
 private:
+    //Per arena; grows to the largest frame seen if a frame overflows it.
+    constexpr static std::size_t FRAME_ARENA_SIZE = 1024u * 1024u;
+
     void UpdateSystemTime(TimeUtils::FPSeconds deltaSeconds);
     void RegisterTexturesFromFolder(const std::filesystem::path& folderpath, bool recursive = false);
     bool RegisterTexture(const std::filesystem::path& filepath);
@@ -364,7 +380,9 @@ private:
     void RegisterFontsFromFolder(const std::filesystem::path& folderpath, bool recursive = false);
 
     void UpdateVbo(const VertexBuffer::buffer_t& vbo);
+    void UpdateVbo(const Vertex3D* vbo, std::size_t vertex_count);
     void UpdateIbo(const IndexBuffer::buffer_t& ibo);
+    void UpdateIbo(const unsigned int* ibo, std::size_t index_count);
 
     void Draw(const PrimitiveType& topology, VertexBuffer* vbo, std::size_t vertex_count);
     void DrawIndexed(const PrimitiveType& topology, VertexBuffer* vbo, IndexBuffer* ibo, std::size_t index_count, std::size_t startVertex = 0, std::size_t baseVertexLocation = 0);
@@ -445,6 +463,7 @@ private:
     lighting_buffer_t _lighting_data{};
     std::size_t _current_vbo_size = 0;
     std::size_t _current_ibo_size = 0;
+    FrameArena _frame_arena{ FRAME_ARENA_SIZE };
     RenderTargetStack* _target_stack = nullptr;
     RHIDeviceContext* _rhi_context = nullptr;
     RHIDevice* _rhi_device = nullptr;
@@ -35,12 +35,16 @@ VertexBuffer::~VertexBuffer() {
 }
 
 void VertexBuffer::Update(RHIDeviceContext* context, const buffer_t& buffer) {
+    Update(context, buffer.data(), buffer.size());
+}
+
+void VertexBuffer::Update(RHIDeviceContext* context, const arraybuffer_t* data, std::size_t count) {
     D3D11_MAPPED_SUBRESOURCE resource = {};
     auto dx_context = context->GetDxContext();
     HRESULT hr = dx_context->Map(_dx_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0U, &resource);
     bool succeeded = SUCCEEDED(hr);
     if(succeeded) {
-        std::memcpy(resource.pData, buffer.data(), sizeof(arraybuffer_t) * buffer.size());
+        std::memcpy(resource.pData, data, sizeof(arraybuffer_t) * count);
         dx_context->Unmap(_dx_buffer, 0);
     }
 }
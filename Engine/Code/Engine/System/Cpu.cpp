@@ -1,27 +1,126 @@
 #include "Engine/System/Cpu.hpp"
 
-#include "Engine/Core/DataUtils.hpp"
+#include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/StringUtils.hpp"
+
+#ifdef PLATFORM_WINDOWS
 #include "Engine/Core/Win.hpp"
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
+#include <utility>
 
 System::Cpu::ProcessorArchitecture GetProcessorArchitecture();
 
+namespace {
+
+void SortCores(std::vector<System::Cpu::CoreDesc>& cores) {
+    for(auto& core : cores) {
+        std::sort(std::begin(core.logicalProcessors), std::end(core.logicalProcessors));
+    }
+    std::sort(std::begin(cores), std::end(cores), [](const System::Cpu::CoreDesc& a, const System::Cpu::CoreDesc& b) {
+        const auto a_first = a.logicalProcessors.empty() ? 0 : a.logicalProcessors.front();
+        const auto b_first = b.logicalProcessors.empty() ? 0 : b.logicalProcessors.front();
+        return a.socket < b.socket || (a.socket == b.socket && a_first < b_first);
+    });
+}
+
+void AddCache(System::Cpu::CpuDesc& desc, int level, std::size_t size, std::size_t lineSize) {
+    //Sizes are per cache instance, e.g. one core's L1, not the sum over every core.
+    desc.cacheLineSize = (std::max)(desc.cacheLineSize, lineSize);
+    switch(level) {
+    case 1: desc.l1DataCacheSize = (std::max)(desc.l1DataCacheSize, size); break;
+    case 2: desc.l2CacheSize = (std::max)(desc.l2CacheSize, size); break;
+    case 3: desc.l3CacheSize = (std::max)(desc.l3CacheSize, size); break;
+    default: break;
+    }
+}
+
+#ifndef PLATFORM_WINDOWS
+
+std::string ReadSysfsLine(const std::filesystem::path& path) {
+    std::ifstream ifs(path);
+    std::string line{};
+    std::getline(ifs, line);
+    return StringUtils::TrimWhitespace(line);
+}
+
+int ReadSysfsInt(const std::filesystem::path& path, int defaultValue) {
+    const auto line = ReadSysfsLine(path);
+    if(line.empty()) {
+        return defaultValue;
+    }
+    return std::stoi(line);
+}
+
+//Cache sizes are written as "32K" or "8M".
+std::size_t ReadSysfsSize(const std::filesystem::path& path) {
+    const auto line = ReadSysfsLine(path);
+    if(line.empty()) {
+        return 0u;
+    }
+    std::size_t idx = 0u;
+    auto size = static_cast<std::size_t>(std::stoull(line, &idx));
+    if(idx < line.size()) {
+        switch(line[idx]) {
+        case 'K': size *= 1024u; break;
+        case 'M': size *= 1024u * 1024u; break;
+        case 'G': size *= 1024u * 1024u * 1024u; break;
+        default: break;
+        }
+    }
+    return size;
+}
+
+//Lists are written as "0-3,8,10-11".
+std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int> result{};
+    for(const auto& range : StringUtils::Split(list, ',')) {
+        const auto bounds = StringUtils::Split(range, '-');
+        if(bounds.empty()) {
+            continue;
+        }
+        const auto first = std::stoi(bounds.front());
+        const auto last = std::stoi(bounds.back());
+        for(auto i = first; i <= last; ++i) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+#endif
+
+} //End anonymous namespace
+
 std::ostream& System::Cpu::operator<<(std::ostream& out, const System::Cpu::CpuDesc& cpu) {
     auto old_fmt = out.flags();
     auto old_w = out.width();
     out << std::left << std::setw(25) << "Processor Type:"           << std::right << std::setw(25) << StringUtils::to_string(cpu.type) << '\n';
     out << std::left << std::setw(25) << "Socket Count:"             << std::right << std::setw(25) << cpu.socketCount  << '\n';
+    out << std::left << std::setw(25) << "Core Count:"               << std::right << std::setw(25) << cpu.coreCount    << '\n';
     out << std::left << std::setw(25) << "Logical Processor Count:"  << std::right << std::setw(25) << cpu.logicalCount << '\n';
+    out << std::left << std::setw(25) << "Cache Line Size:"          << std::right << std::setw(25) << cpu.cacheLineSize << '\n';
+    out << std::left << std::setw(25) << "L1 Data Cache Size:"       << std::right << std::setw(25) << cpu.l1DataCacheSize << '\n';
+    out << std::left << std::setw(25) << "L2 Cache Size:"            << std::right << std::setw(25) << cpu.l2CacheSize << '\n';
+    out << std::left << std::setw(25) << "L3 Cache Size:"            << std::right << std::setw(25) << cpu.l3CacheSize << '\n';
     out.flags(old_fmt);
     out.width(old_w);
     return out;
 }
 
+#ifdef PLATFORM_WINDOWS
 
 System::Cpu::ProcessorArchitecture GetProcessorArchitecture() {
     using namespace System::Cpu;
@@ -54,6 +153,16 @@ System::Cpu::CpuDesc System::Cpu::GetCpuDesc() {
     SYSTEM_INFO info{};
     ::GetSystemInfo(&info);
     desc.logicalCount = info.dwNumberOfProcessors;
+    auto mask_to_processors = [](ULONG_PTR mask) {
+        std::vector<int> processors{};
+        for(int i = 0; i < static_cast<int>(sizeof(mask) * 8); ++i) {
+            if(mask & (ULONG_PTR{ 1 } << i)) {
+                processors.push_back(i);
+            }
+        }
+        return processors;
+    };
+    std::vector<ULONG_PTR> package_masks{};
     DWORD length{};
     if(!::GetLogicalProcessorInformation(nullptr, &length)) {
         if(::GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
@@ -71,6 +180,21 @@ System::Cpu::CpuDesc System::Cpu::GetCpuDesc() {
                         case RelationProcessorPackage:
                         {
                             ++desc.socketCount;
+                            package_masks.push_back(p.ProcessorMask);
+                            break;
+                        }
+                        case RelationProcessorCore:
+                        {
+                            CoreDesc core{};
+                            core.logicalProcessors = mask_to_processors(p.ProcessorMask);
+                            desc.cores.push_back(core);
+                            break;
+                        }
+                        case RelationCache:
+                        {
+                            if(p.Cache.Type == CacheData || p.Cache.Type == CacheUnified) {
+                                AddCache(desc, p.Cache.Level, p.Cache.Size, p.Cache.LineSize);
+                            }
                             break;
                         }
                         default:
@@ -81,5 +205,130 @@ System::Cpu::CpuDesc System::Cpu::GetCpuDesc() {
             }
         }
     }
+    for(auto& core : desc.cores) {
+        for(std::size_t i = 0; i < package_masks.size(); ++i) {
+            if(!core.logicalProcessors.empty() && (package_masks[i] & (ULONG_PTR{ 1 } << core.logicalProcessors.front()))) {
+                core.socket = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+    SortCores(desc.cores);
+    desc.coreCount = static_cast<int>(desc.cores.size());
     return desc;
 }
+
+bool System::Cpu::SetThreadAffinity(std::thread::native_handle_type thread, const std::vector<int>& logicalProcessors) {
+    DWORD_PTR mask{};
+    for(auto processor : logicalProcessors) {
+        if(0 <= processor && processor < static_cast<int>(sizeof(mask) * 8)) {
+            mask |= DWORD_PTR{ 1 } << processor;
+        }
+    }
+    if(!mask) {
+        return false;
+    }
+    return ::SetThreadAffinityMask(static_cast<HANDLE>(thread), mask) != 0;
+}
+
+bool System::Cpu::SetCurrentThreadAffinity(const std::vector<int>& logicalProcessors) {
+    return SetThreadAffinity(::GetCurrentThread(), logicalProcessors);
+}
+
+#else
+
+System::Cpu::ProcessorArchitecture GetProcessorArchitecture() {
+    using namespace System::Cpu;
+#if defined(__x86_64__)
+    return ProcessorArchitecture::Amd64;
+#elif defined(__i386__)
+    return ProcessorArchitecture::Intel;
+#elif defined(__aarch64__)
+    return ProcessorArchitecture::Arm64;
+#elif defined(__arm__)
+    return ProcessorArchitecture::Arm;
+#elif defined(__powerpc__)
+    return ProcessorArchitecture::Ppc;
+#else
+    return ProcessorArchitecture::Unknown;
+#endif
+}
+
+System::Cpu::CpuDesc System::Cpu::GetCpuDesc() {
+    return GetCpuDescFromSysfs("/sys/devices/system/cpu");
+}
+
+System::Cpu::CpuDesc System::Cpu::GetCpuDescFromSysfs(const std::filesystem::path& cpu_root) {
+    namespace FS = std::filesystem;
+    CpuDesc desc{};
+    desc.type = GetProcessorArchitecture();
+    auto online = ParseCpuList(ReadSysfsLine(cpu_root / "online"));
+    if(online.empty()) {
+        for(int i = 0; i < static_cast<int>(std::thread::hardware_concurrency()); ++i) {
+            online.push_back(i);
+        }
+    }
+    desc.logicalCount = static_cast<int>(online.size());
+    //Core ids are only unique within a package.
+    std::map<std::pair<int, int>, CoreDesc> cores{};
+    std::set<int> packages{};
+    for(auto processor : online) {
+        const auto topology = cpu_root / ("cpu" + std::to_string(processor)) / "topology";
+        if(!FS::exists(topology)) {
+            continue;
+        }
+        const auto package = (std::max)(ReadSysfsInt(topology / "physical_package_id", 0), 0);
+        const auto core_id = ReadSysfsInt(topology / "core_id", processor);
+        auto& core = cores[std::make_pair(package, core_id)];
+        core.socket = package;
+        core.logicalProcessors.push_back(processor);
+        packages.insert(package);
+    }
+    for(auto& core : cores) {
+        desc.cores.push_back(std::move(core.second));
+    }
+    //Package ids need not be contiguous; renumber them 0..socketCount-1.
+    for(auto& core : desc.cores) {
+        core.socket = static_cast<int>(std::distance(std::begin(packages), packages.find(core.socket)));
+    }
+    SortCores(desc.cores);
+    desc.socketCount = static_cast<int>(packages.size());
+    desc.coreCount = static_cast<int>(desc.cores.size());
+    if(!online.empty()) {
+        const auto cache_root = cpu_root / ("cpu" + std::to_string(online.front())) / "cache";
+        std::error_code ec{};
+        for(auto iter = FS::directory_iterator{ cache_root, ec }; !ec && iter != FS::directory_iterator{}; iter.increment(ec)) {
+            const auto& index = iter->path();
+            if(index.filename().string().rfind("index", 0) != 0) {
+                continue;
+            }
+            if(ReadSysfsLine(index / "type") == "Instruction") {
+                continue;
+            }
+            AddCache(desc, ReadSysfsInt(index / "level", 0), ReadSysfsSize(index / "size"), static_cast<std::size_t>((std::max)(ReadSysfsInt(index / "coherency_line_size", 0), 0)));
+        }
+    }
+    return desc;
+}
+
+bool System::Cpu::SetThreadAffinity(std::thread::native_handle_type thread, const std::vector<int>& logicalProcessors) {
+    cpu_set_t set{};
+    CPU_ZERO(&set);
+    bool any = false;
+    for(auto processor : logicalProcessors) {
+        if(0 <= processor && processor < CPU_SETSIZE) {
+            CPU_SET(processor, &set);
+            any = true;
+        }
+    }
+    if(!any) {
+        return false;
+    }
+    return ::pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+}
+
+bool System::Cpu::SetCurrentThreadAffinity(const std::vector<int>& logicalProcessors) {
+    return SetThreadAffinity(::pthread_self(), logicalProcessors);
+}
+
+#endif
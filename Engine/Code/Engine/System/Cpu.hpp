@@ -1,6 +1,12 @@
 #pragma once
 
+#include "Engine/Core/BuildConfig.hpp"
+
+#include <cstddef>
+#include <filesystem>
 #include <ostream>
+#include <thread>
+#include <vector>
 
 namespace System::Cpu {
 
@@ -25,13 +31,36 @@ enum class ProcessorArchitecture {
     , Unknown = 0xFFFF
 };
 
+//One physical core and the logical processors (SMT siblings) that share it.
+struct CoreDesc {
+    int socket = 0;
+    std::vector<int> logicalProcessors{};
+};
+
 struct CpuDesc {
     ProcessorArchitecture type{};
     int socketCount = 0;
+    int coreCount = 0;
     int logicalCount = 0;
+    std::size_t cacheLineSize = 0u;
+    std::size_t l1DataCacheSize = 0u;
+    std::size_t l2CacheSize = 0u;
+    std::size_t l3CacheSize = 0u;
+    //Sorted by socket, then by first logical processor. Empty if the topology could not be read.
+    std::vector<CoreDesc> cores{};
     friend std::ostream& operator<<(std::ostream& out, const CpuDesc& cpu);
 };
+std::ostream& operator<<(std::ostream& out, const CpuDesc& cpu);
 
 CpuDesc GetCpuDesc();
+#ifdef PLATFORM_LINUX
+//GetCpuDesc reading cpuRoot instead of /sys/devices/system/cpu, e.g. a copied or hand-made tree in tests.
+CpuDesc GetCpuDescFromSysfs(const std::filesystem::path& cpuRoot);
+#endif
+
+//Restricts a thread to the given logical processors. Returns false if the OS refused or the list is empty.
+//On Windows only the first 64 logical processors (processor group 0) can be targeted.
+bool SetThreadAffinity(std::thread::native_handle_type thread, const std::vector<int>& logicalProcessors);
+bool SetCurrentThreadAffinity(const std::vector<int>& logicalProcessors);
 
 }
\ No newline at end of file
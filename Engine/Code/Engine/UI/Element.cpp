@@ -5,14 +5,60 @@
 
 #include "Engine/Math/MathUtils.hpp"
 
+#include "Engine/Memory/MemoryPool.hpp"
+
+#include "Engine/Profiling/Memory.hpp"
+
 #include "Engine/Renderer/Renderer.hpp"
 
 #include "Engine/UI/Canvas.hpp"
 
+#include <array>
+#include <new>
 #include <sstream>
 
+namespace {
+
+//Menus create and destroy whole trees of elements at once. Each size class has its own pool;
+//anything larger than the last class comes from the global heap.
+constexpr std::size_t ELEMENTS_PER_PAGE = 64u;
+
+FixedBlockPool* GetElementPool(std::size_t size) {
+    //Never destroyed: elements owned by other statics may be deleted during static destruction.
+    static auto* pools = new std::array<FixedBlockPool, 4>{ {
+        FixedBlockPool{ 128u, alignof(std::max_align_t), ELEMENTS_PER_PAGE, true },
+        FixedBlockPool{ 256u, alignof(std::max_align_t), ELEMENTS_PER_PAGE, true },
+        FixedBlockPool{ 512u, alignof(std::max_align_t), ELEMENTS_PER_PAGE, true },
+        FixedBlockPool{ 1024u, alignof(std::max_align_t), ELEMENTS_PER_PAGE, true },
+    } };
+    for(auto& pool : *pools) {
+        if(size <= pool.GetBlockSize()) {
+            return &pool;
+        }
+    }
+    return nullptr;
+}
+
+} //End anonymous namespace
+
 namespace UI {
 
+void* Element::operator new(std::size_t size) {
+    MEMORY_TAG_SCOPE(UI);
+    if(auto pool = GetElementPool(size)) {
+        return pool->Allocate();
+    }
+    return ::operator new(size);
+}
+
+void Element::operator delete(void* ptr, std::size_t size) {
+    if(auto pool = GetElementPool(size)) {
+        pool->Deallocate(ptr);
+        return;
+    }
+    ::operator delete(ptr);
+}
+
 Element::Element(UI::Canvas* parent_canvas)
     : _parent_canvas(parent_canvas)
 {
@@ -258,7 +304,7 @@ void Element::DebugRenderBoundsAndPivot(Renderer* renderer) const {
 void Element::DebugRenderPivot(Renderer* renderer) const {
     auto world_transform = GetWorldTransform();
     auto scale = world_transform.GetScale();
-    auto inv_scale_matrix = Matrix4::CalculateInverse(Matrix4::CreateScaleMatrix(Vector3(scale.x * 0.10f, scale.y * 0.10f, 1.0f)));
+    auto inv_scale_matrix = Matrix4::CalculateInverseAffine(Matrix4::CreateScaleMatrix(Vector3(scale.x * 0.10f, scale.y * 0.10f, 1.0f)));
     auto extents = GetSize();
     auto pivot_pos = MathUtils::CalcPointFromNormalizedPoint(_pivot, _bounds);
     auto pivot_pos_matrix = Matrix4::CreateTranslationMatrix(pivot_pos);
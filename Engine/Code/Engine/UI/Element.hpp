@@ -21,6 +21,10 @@ public:
     explicit Element(UI::Canvas* parent_canvas);
     virtual ~Element() = 0;
 
+    //Elements of every derived type come from per-size-class block pools.
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+
     virtual void Update(TimeUtils::FPSeconds deltaSeconds);
     virtual void Render(Renderer* renderer) const;
     virtual void DebugRender(Renderer* renderer, bool showSortOrder = false) const;
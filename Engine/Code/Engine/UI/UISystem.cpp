@@ -3,6 +3,8 @@
 #include "Engine/Core/BuildConfig.hpp"
 #include "Engine/Core/FileUtils.hpp"
 
+#include "Engine/Profiling/Memory.hpp"
+
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Texture.hpp"
 #include "Engine/Renderer/Window.hpp"
@@ -91,6 +93,7 @@ UISystem::~UISystem() {
 }
 
 void UISystem::Initialize() {
+    MEMORY_TAG_SCOPE(UI);
     
     FileUtils::CreateFolders("Engine/Config/");
     _io->IniFilename = "Engine/Config/imgui.ini";
@@ -106,6 +109,7 @@ void UISystem::Initialize() {
 }
 
 void UISystem::BeginFrame() {
+    MEMORY_TAG_SCOPE(UI);
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
@@ -116,11 +120,13 @@ void UISystem::Update(TimeUtils::FPSeconds /*deltaSeconds*/) {
 }
 
 void UISystem::Render() const {
+    MEMORY_TAG_SCOPE(UI);
     ImGui::Render();
     ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 }
 
 void UISystem::EndFrame() {
+    MEMORY_TAG_SCOPE(UI);
     ImGui::EndFrame();
 }
 
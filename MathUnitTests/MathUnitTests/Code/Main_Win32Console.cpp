@@ -1,20 +1,57 @@
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 #include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
+#include "Engine/Core/BuildConfig.hpp"
+#include "Engine/Core/Config.hpp"
+#include "Engine/Core/JobFuture.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/KeyValueParser.hpp"
+#include "Engine/Core/OverflowQueue.hpp"
+#include "Engine/Core/ParallelTransforms.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/TaskGraph.hpp"
+#include "Engine/Core/Vertex3D.hpp"
+#include "Engine/Core/WorkStealingQueue.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix4.hpp"
+#include "Engine/Math/Matrix4Simd.hpp"
 
 #include "Engine/Math/Vector2.hpp"
 #include "Engine/Math/Vector3.hpp"
 
+#include "Engine/Memory/FrameArena.hpp"
+#include "Engine/Memory/MemoryPool.hpp"
+#include "Engine/Memory/TlsfAllocator.hpp"
+
 #include "Engine/Core/TimeUtils.hpp"
 
+#include "Engine/Profiling/AllocationProfiler.hpp"
+#include "Engine/Profiling/FrameStats.hpp"
+#include "Engine/Profiling/JobInstrumentation.hpp"
+#include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/MemoryBudgets.hpp"
+#include "Engine/Profiling/Profiler.hpp"
+#include "Engine/Profiling/SamplingProfiler.hpp"
+
+#include "Engine/System/Cpu.hpp"
+
 struct TestResults {
     unsigned int total_tests = 0;
     unsigned int passed_tests = 0;
@@ -30,8 +67,21 @@ int OutputResults();
 void TestVector2();
 void TestVector3();
 void TestMathUtils();
+void TestMatrix4();
 void TestSplit();
 void TestJoin();
+void TestJobSystem();
+void TestTlsfAllocator();
+void TestMemoryPool();
+void TestFrameArena();
+void TestProfiler();
+void TestAllocationProfiler();
+void TestMemory();
+void TestMemoryBudgets();
+void TestFrameStats();
+void TestJobInstrumentation();
+void TestSamplingProfiler();
+void TestCpuTopology();
 #pragma endregion
 
 int main(int /*argc*/, char** /*argv*/) {
@@ -39,8 +89,21 @@ int main(int /*argc*/, char** /*argv*/) {
     TestVector2();
     TestVector3();
     TestMathUtils();
+    TestMatrix4();
     TestSplit();
     TestJoin();
+    TestJobSystem();
+    TestTlsfAllocator();
+    TestMemoryPool();
+    TestFrameArena();
+    TestProfiler();
+    TestAllocationProfiler();
+    TestMemory();
+    TestMemoryBudgets();
+    TestFrameStats();
+    TestJobInstrumentation();
+    TestSamplingProfiler();
+    TestCpuTopology();
     unsigned int failed_tests = OutputResults();
     return failed_tests;
 }
@@ -101,6 +164,124 @@ void TestMathUtils() {
 
 }
 
+bool IsEquivalent(const Matrix4& a, const Matrix4& b, float epsilon) {
+    for(unsigned int i = 0; i < 16; ++i) {
+        if(!MathUtils::IsEquivalent((*a)[i], (*b)[i], epsilon)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsIdentical(const Matrix4& a, const Matrix4& b) {
+    return std::equal(*a, *a + 16, *b);
+}
+
+//Largest element of |M * inverse - I|.
+float InverseResidual(const Matrix4& mat, const Matrix4& inverse) {
+    const auto product = mat * inverse;
+    const auto& identity = Matrix4::GetIdentity();
+    float residual = 0.0f;
+    for(unsigned int i = 0; i < 16; ++i) {
+        residual = (std::max)(residual, std::abs((*product)[i] - (*identity)[i]));
+    }
+    return residual;
+}
+
+Matrix4 RandomRigid(std::mt19937& rng) {
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> offset(-100.0f, 100.0f);
+    const auto rotation = Matrix4::Create3DZRotationDegreesMatrix(angle(rng)) * Matrix4::Create3DXRotationDegreesMatrix(angle(rng)) * Matrix4::Create3DYRotationDegreesMatrix(angle(rng));
+    return Matrix4::CreateTranslationMatrix(Vector3(offset(rng), offset(rng), offset(rng))) * rotation;
+}
+
+Matrix4 RandomAffine(std::mt19937& rng) {
+    std::uniform_real_distribution<float> scale(0.25f, 4.0f);
+    return RandomRigid(rng) * Matrix4::CreateScaleMatrix(Vector3(scale(rng), scale(rng), scale(rng))) * RandomRigid(rng).GetRotation();
+}
+
+void TestMatrix4() {
+
+    ApplyTest("CalculateInverseAffine of translate*rotate*scale*rotate times itself is identity:",
+    []()->bool{
+        std::mt19937 rng(1729u);
+        const auto mat = RandomAffine(rng);
+        return InverseResidual(mat, Matrix4::CalculateInverseAffine(mat)) < 0.0001f;
+    });
+
+    ApplyTest("CalculateInverseAffine matches CalculateInverse:",
+    []()->bool{
+        std::mt19937 rng(1730u);
+        const auto mat = RandomAffine(rng);
+        return IsEquivalent(Matrix4::CalculateInverseAffine(mat), Matrix4::CalculateInverse(mat), 0.0001f);
+    });
+
+    ApplyTest("CalculateInverseRigid of translate*rotate times itself is identity:",
+    []()->bool{
+        std::mt19937 rng(1731u);
+        const auto mat = RandomRigid(rng);
+        return InverseResidual(mat, Matrix4::CalculateInverseRigid(mat)) < 0.0001f;
+    });
+
+    ApplyTest("CalculateInverseRigid matches CalculateInverse:",
+    []()->bool{
+        std::mt19937 rng(1732u);
+        const auto mat = RandomRigid(rng);
+        return IsEquivalent(Matrix4::CalculateInverseRigid(mat), Matrix4::CalculateInverse(mat), 0.0001f);
+    });
+
+    //Translations reach 100, where one float ulp is 7.6e-6; the general inverse stays well inside this bound too.
+    ApplyTest("Affine and rigid inverses stay within 5e-4 of identity over 1000 random matrices:",
+    []()->bool{
+        std::mt19937 rng(1733u);
+        float affine = 0.0f;
+        float rigid = 0.0f;
+        for(int i = 0; i < 1000; ++i) {
+            const auto affine_mat = RandomAffine(rng);
+            const auto rigid_mat = RandomRigid(rng);
+            affine = (std::max)(affine, InverseResidual(affine_mat, Matrix4::CalculateInverseAffine(affine_mat)));
+            rigid = (std::max)(rigid, InverseResidual(rigid_mat, Matrix4::CalculateInverseRigid(rigid_mat)));
+        }
+        return affine < 0.0005f && rigid < 0.0005f;
+    });
+
+    ApplyTest("CalculateInverse stays within 5e-4 of identity over 1000 random matrices at every SIMD level:",
+    []()->bool{
+        const auto previous = Matrix4Simd::GetLevel();
+        bool passed = true;
+        for(auto level : { Matrix4Simd::Level::Scalar, Matrix4Simd::Level::Sse4, Matrix4Simd::Level::Avx2 }) {
+            if(Matrix4Simd::SetLevel(level) != level) {
+                continue;
+            }
+            std::mt19937 rng(1735u);
+            float residual = 0.0f;
+            for(int i = 0; i < 1000; ++i) {
+                const auto mat = RandomAffine(rng);
+                residual = (std::max)(residual, InverseResidual(mat, Matrix4::CalculateInverse(mat)));
+            }
+            passed &= residual < 0.0005f;
+        }
+        Matrix4Simd::SetLevel(previous);
+        return passed;
+    });
+
+    ApplyTest("Affine inverse detection takes the affine path only for affine matrices:",
+    []()->bool{
+        std::mt19937 rng(1734u);
+        const auto affine_mat = RandomAffine(rng);
+        const auto projection = Matrix4::CreateDXPerspectiveProjection(60.0f, 1.7777f, 0.1f, 1000.0f);
+        Matrix4::SetAffineInverseDetection(true);
+        const auto detected = Matrix4::CalculateInverse(affine_mat);
+        const auto projection_inverse = Matrix4::CalculateInverse(projection);
+        Matrix4::SetAffineInverseDetection(false);
+        return affine_mat.IsAffine()
+            && !projection.IsAffine()
+            && IsIdentical(detected, Matrix4::CalculateInverseAffine(affine_mat))
+            && IsIdentical(projection_inverse, Matrix4::CalculateInverse(projection));
+    });
+
+}
+
 void TestSplit() {
     ApplyTest("Split returns one value on \"abc\"",
               []()->bool {
@@ -153,3 +334,925 @@ void TestJoin() {
         return result == "a,b,c";
     });
 }
+
+void TestJobSystem() {
+    ApplyTest("OverflowQueue filled past capacity from its draining thread keeps FIFO order:",
+              []()->bool {
+        OverflowQueue<int> queue{ 16u };
+        int next_pushed = 0;
+        int next_popped = 0;
+        bool in_order = true;
+        //Drain one, push two: the ring fills up and the rest spills.
+        for(int i = 0; i < 64; ++i) {
+            int value = 0;
+            if(queue.try_pop(value)) {
+                in_order &= value == next_popped++;
+            }
+            queue.push(next_pushed++);
+            queue.push(next_pushed++);
+        }
+        const bool spilled = queue.overflow_size() != 0u;
+        int value = 0;
+        while(queue.try_pop(value)) {
+            in_order &= value == next_popped++;
+        }
+        return spilled && in_order && next_popped == next_pushed && queue.empty();
+    });
+    ApplyTest("WorkStealingQueue grows past its initial capacity; thieves take FIFO, the owner LIFO:",
+              []()->bool {
+        WorkStealingQueue<std::uint32_t> queue{ 16u };
+        constexpr std::uint32_t count = 16u * 10u + 3u;
+        for(std::uint32_t i = 0u; i < count; ++i) {
+            queue.push(i);
+        }
+        bool passed = queue.size() == count;
+        std::uint32_t value = 0u;
+        for(std::uint32_t i = 0u; i < count / 2u; ++i) {
+            passed &= queue.steal(value) && value == i;
+        }
+        for(std::uint32_t i = count; i-- > count / 2u;) {
+            passed &= queue.pop(value) && value == i;
+        }
+        return passed && queue.empty() && !queue.pop(value) && !queue.steal(value);
+    });
+    ApplyTest("WorkStealingQueue hands every item to exactly one of the owner and three thieves:",
+              []()->bool {
+        constexpr std::uint32_t count = 200000u;
+        WorkStealingQueue<std::uint32_t> queue{ 16u };
+        std::vector<std::atomic<std::uint32_t>> taken(count);
+        std::atomic_bool done{ false };
+        std::vector<std::thread> thieves{};
+        for(int i = 0; i < 3; ++i) {
+            thieves.emplace_back([&queue, &taken, &done]() {
+                std::uint32_t value = 0u;
+                while(!done) {
+                    if(queue.steal(value)) {
+                        ++taken[value];
+                    }
+                }
+            });
+        }
+        //Bursts that grow the deque, then single items the owner and thieves race for.
+        std::uint32_t value = 0u;
+        std::uint32_t next = 0u;
+        while(next < count / 2u) {
+            for(int i = 0; i < 100 && next < count / 2u; ++i) {
+                queue.push(next++);
+            }
+            for(int i = 0; i < 60 && queue.pop(value); ++i) {
+                ++taken[value];
+            }
+        }
+        while(next < count) {
+            queue.push(next++);
+            if(queue.pop(value)) {
+                ++taken[value];
+            }
+        }
+        while(queue.pop(value)) {
+            ++taken[value];
+        }
+        //A thief may still hold an item it read before the owner emptied the deque.
+        while(!queue.empty()) {
+            std::this_thread::yield();
+        }
+        done = true;
+        for(auto& thief : thieves) {
+            thief.join();
+        }
+        return std::all_of(std::begin(taken), std::end(taken), [](const std::atomic<std::uint32_t>& t) { return t == 1u; });
+    });
+    ApplyTest("Jobs queued on a busy worker's own deque are stolen by the other worker:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 2 } };
+        constexpr std::size_t child_count = 64u;
+        std::atomic<std::size_t> ran{ 0u };
+        std::atomic<std::size_t> stolen{ 0u };
+        std::atomic_bool parent_done{ false };
+        jobSystem.Run(JobType::Generic, [&](void*) {
+            const auto parent_thread = std::this_thread::get_id();
+            //Dispatched from inside a generic job, so they land on this worker's deque.
+            for(std::size_t i = 0; i < child_count; ++i) {
+                jobSystem.Run(JobType::Generic, [&ran, &stolen, parent_thread](void*) {
+                    if(std::this_thread::get_id() != parent_thread) {
+                        ++stolen;
+                    }
+                    ++ran;
+                }, nullptr);
+            }
+            //Never pops its own deque: only a thief can run the children.
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while(ran < child_count && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            parent_done = true;
+        }, nullptr);
+        while(!parent_done) {
+            std::this_thread::yield();
+        }
+        return ran == child_count && stolen == child_count;
+    });
+    ApplyTest("A Low job queued behind 1000 High jobs runs within two starvation intervals of picks:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 1 } };
+        std::atomic_bool blocked{ false };
+        std::atomic_bool released{ false };
+        //Holds the only worker until the queue is full, so every pick after it sees High and Low work.
+        jobSystem.Run(JobType::Generic, [&blocked, &released](void*) {
+            blocked = true;
+            while(!released) {
+                std::this_thread::yield();
+            }
+        }, nullptr);
+        while(!blocked) {
+            std::this_thread::yield();
+        }
+        constexpr std::size_t high_count = 1000u;
+        std::atomic<std::size_t> high_ran{ 0u };
+        std::atomic<std::size_t> high_before_low{ high_count };
+        std::atomic_bool low_ran{ false };
+        for(std::size_t i = 0; i < high_count / 2u; ++i) {
+            jobSystem.Run(JobType::Generic, [&high_ran](void*) { ++high_ran; }, nullptr, JobPriority::High);
+        }
+        jobSystem.Run(JobType::Generic, [&high_ran, &high_before_low, &low_ran](void*) {
+            high_before_low = high_ran.load();
+            low_ran = true;
+        }, nullptr, JobPriority::Low);
+        for(std::size_t i = 0; i < high_count / 2u; ++i) {
+            jobSystem.Run(JobType::Generic, [&high_ran](void*) { ++high_ran; }, nullptr, JobPriority::High);
+        }
+        released = true;
+        while(high_ran < high_count || !low_ran) {
+            std::this_thread::yield();
+        }
+        //Low leads the scan on every other STARVATION_INTERVAL-th (8th) pick.
+        return high_before_low <= 2u * 8u;
+    });
+    ApplyTest("A job dispatched while one worker is busy wakes the other, parked worker:",
+              []()->bool {
+        //The busy worker may have listed itself as idle and then found work instead of parking.
+        //Its stale listing must not swallow the wakeup meant for the worker that is really parked.
+        JobSystem jobSystem{ JobSystemDesc{ 2 } };
+        std::minstd_rand rng{ 7u };
+        bool passed = true;
+        for(int i = 0; passed && i < 200; ++i) {
+            std::atomic_bool started{ false };
+            std::atomic_bool released{ false };
+            std::atomic_bool finished{ false };
+            std::atomic_bool second_ran{ false };
+            //Lands while the workers are anywhere between spinning and parking.
+            std::this_thread::sleep_for(std::chrono::microseconds(rng() % 300u));
+            jobSystem.Run(JobType::Generic, [&started, &released, &finished](void*) {
+                started = true;
+                while(!released) {
+                    std::this_thread::yield();
+                }
+                finished = true;
+            }, nullptr);
+            while(!started) {
+                std::this_thread::yield();
+            }
+            //Long enough for the idle worker to stop spinning and park.
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            jobSystem.Run(JobType::Generic, [&second_ran](void*) { second_ran = true; }, nullptr);
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+            while(!second_ran && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            passed = second_ran;
+            released = true;
+            while(!finished || !second_ran) {
+                std::this_thread::yield();
+            }
+        }
+        return passed;
+    });
+    ApplyTest("Main job dispatching twice JOB_QUEUE_CAPACITY Main jobs from the main thread completes:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 1 } };
+        constexpr std::size_t job_count = 2u * JobSystem::JOB_QUEUE_CAPACITY;
+        std::atomic<std::size_t> ran{ 0u };
+        jobSystem.Run(JobType::Main, [&jobSystem, &ran](void*) {
+            for(std::size_t i = 0; i < job_count; ++i) {
+                jobSystem.Run(JobType::Main, [&ran](void*) { ++ran; }, nullptr);
+            }
+        }, nullptr);
+        jobSystem.BeginFrame();
+        return ran == job_count;
+    });
+    ApplyTest("Io job dispatching twice JOB_QUEUE_CAPACITY Io jobs from the Io thread completes:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 1 } };
+        constexpr std::size_t job_count = 2u * JobSystem::JOB_QUEUE_CAPACITY;
+        std::atomic<std::size_t> ran{ 0u };
+        jobSystem.Run(JobType::Io, [&jobSystem, &ran](void*) {
+            for(std::size_t i = 0; i < job_count; ++i) {
+                jobSystem.Run(JobType::Io, [&ran](void*) { ++ran; }, nullptr);
+            }
+        }, nullptr);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while(ran != job_count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return ran == job_count;
+    });
+    //Chunks are 16384 points; the count leaves a partial last chunk.
+    ApplyTest("Parallel batch transforms match the serial batch transforms exactly:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 2 } };
+        constexpr std::size_t count = 3u * 16384u + 123u;
+        std::mt19937 rng(1736u);
+        std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+        std::vector<Vector3> points(count);
+        std::vector<Vertex3D> vertices(count);
+        for(std::size_t i = 0; i < count; ++i) {
+            points[i] = Vector3(coordinate(rng), coordinate(rng), coordinate(rng));
+            vertices[i].position = Vector3(coordinate(rng), coordinate(rng), coordinate(rng));
+            vertices[i].normal = Vector3(coordinate(rng), coordinate(rng), coordinate(rng)).GetNormalize();
+            vertices[i].texcoords = Vector2(coordinate(rng), coordinate(rng));
+        }
+        const auto transform = RandomAffine(rng);
+        std::vector<Vector3> serial(count);
+        std::vector<Vector3> parallel(count);
+        MathUtils::TransformPositions(transform, points.data(), serial.data(), count);
+        MathUtils::TransformPositions(jobSystem, transform, points.data(), parallel.data(), count);
+        bool passed = serial == parallel;
+        MathUtils::TransformDirections(transform, points.data(), serial.data(), count);
+        MathUtils::TransformDirections(jobSystem, transform, points.data(), parallel.data(), count);
+        passed &= serial == parallel;
+        std::vector<Vertex3D> serial_vertices(count);
+        std::vector<Vertex3D> parallel_vertices(count);
+        MathUtils::TransformVertices(transform, vertices.data(), serial_vertices.data(), count);
+        MathUtils::TransformVertices(jobSystem, transform, vertices.data(), parallel_vertices.data(), count);
+        for(std::size_t i = 0; i < count; ++i) {
+            passed &= serial_vertices[i].position == parallel_vertices[i].position
+                && serial_vertices[i].normal == parallel_vertices[i].normal
+                && serial_vertices[i].texcoords == parallel_vertices[i].texcoords
+                && serial_vertices[i].color == parallel_vertices[i].color;
+        }
+        return passed;
+    });
+    ApplyTest("Async on Io without an Io category runs as a generic job:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 1, static_cast<std::size_t>(JobType::Io) } };
+        auto future = jobSystem.Async(JobType::Io, []() { return 42; });
+        return future.Get() == 42;
+    });
+    ApplyTest("TaskGraph report keeps its task names after more tasks are added:",
+              []()->bool {
+        JobSystem jobSystem{ JobSystemDesc{ 1 } };
+        TaskGraph graph{ jobSystem };
+        //Short enough to live inside the task storage rather than on the heap.
+        const auto input = graph.AddTask("Input", []() { /* DO NOTHING */ });
+        const auto physics = graph.AddTask("Physics", []() { /* DO NOTHING */ });
+        graph.AddEdge(input, physics);
+        graph.Compile();
+        graph.Run();
+        const auto& report = graph.GetLastReport();
+        //Reallocates the task storage the names were first copied from.
+        for(int i = 0; i < 64; ++i) {
+            graph.AddTask("Filler", []() { /* DO NOTHING */ });
+        }
+        return report.critical_path.size() == 2u
+            && report.critical_path[0].name == "Input" && report.critical_path[1].name == "Physics";
+    });
+}
+
+void TestTlsfAllocator() {
+    ApplyTest("TlsfAllocator serves mixed sizes without overlap and coalesces back to one block:",
+              []()->bool {
+        TlsfAllocator allocator{ 4u * 1024u * 1024u, false };
+        std::mt19937 rng(2004u);
+        //Spans the linear small-block bins and several first-level classes.
+        std::uniform_int_distribution<std::size_t> size_distribution(1u, 64u * 1024u);
+        struct Allocation {
+            unsigned char* ptr = nullptr;
+            std::size_t size = 0u;
+            unsigned char fill = 0u;
+        };
+        std::vector<Allocation> live{};
+        bool passed = true;
+        for(int i = 0; i < 4096; ++i) {
+            if(!live.empty() && (rng() % 3u) == 0u) {
+                const auto index = rng() % live.size();
+                const auto& allocation = live[index];
+                passed &= std::all_of(allocation.ptr, allocation.ptr + allocation.size, [&allocation](unsigned char c) { return c == allocation.fill; });
+                allocator.Deallocate(allocation.ptr);
+                live[index] = live.back();
+                live.pop_back();
+                continue;
+            }
+            const auto size = size_distribution(rng);
+            auto* ptr = static_cast<unsigned char*>(allocator.Allocate(size));
+            if(!ptr) {
+                continue;
+            }
+            passed &= reinterpret_cast<std::uintptr_t>(ptr) % TlsfAllocator::ALIGNMENT == 0u;
+            passed &= allocator.GetAllocationSize(ptr) >= size;
+            const auto fill = static_cast<unsigned char>(i);
+            std::fill_n(ptr, size, fill);
+            live.push_back(Allocation{ ptr, size, fill });
+        }
+        for(const auto& allocation : live) {
+            passed &= std::all_of(allocation.ptr, allocation.ptr + allocation.size, [&allocation](unsigned char c) { return c == allocation.fill; });
+            allocator.Deallocate(allocation.ptr);
+        }
+        const auto report = allocator.GetFragmentationReport();
+        return passed && report.used_block_count == 0u && report.free_block_count == 1u;
+    });
+    ApplyTest("TlsfAllocator takes the smallest free class that fits before the pool's tail:",
+              []()->bool {
+        TlsfAllocator allocator{ 1024u * 1024u, false };
+        auto* freed = allocator.Allocate(4096u);
+        //Keeps the freed block from coalescing with the tail.
+        auto* separator = allocator.Allocate(64u);
+        allocator.Deallocate(freed);
+        //No exact-class block is free, so the first-level bitmap scan picks between the freed block and the tail.
+        auto* reused = allocator.Allocate(512u);
+        const bool passed = reused == freed;
+        allocator.Deallocate(reused);
+        allocator.Deallocate(separator);
+        return passed;
+    });
+}
+
+void TestMemoryPool() {
+    ApplyTest("FixedBlockPool reuses every block freed in shuffled order, with and without a thread cache:",
+              []()->bool {
+        bool passed = true;
+        for(const bool useThreadCache : { false, true }) {
+            FixedBlockPool pool{ 48u, alignof(std::max_align_t), 16u, useThreadCache };
+            std::mt19937 rng(1711u);
+            std::vector<void*> blocks(64u);
+            for(int round = 0; round < 8; ++round) {
+                for(std::size_t i = 0; i < blocks.size(); ++i) {
+                    blocks[i] = pool.Allocate();
+                    std::memset(blocks[i], static_cast<int>(i), pool.GetBlockSize());
+                }
+                auto sorted = blocks;
+                std::sort(std::begin(sorted), std::end(sorted));
+                passed &= std::adjacent_find(std::begin(sorted), std::end(sorted)) == std::end(sorted);
+                for(std::size_t i = 0; i < blocks.size(); ++i) {
+                    const auto* bytes = static_cast<const unsigned char*>(blocks[i]);
+                    passed &= std::all_of(bytes, bytes + pool.GetBlockSize(), [i](unsigned char b) { return b == static_cast<unsigned char>(i); });
+                }
+                std::shuffle(std::begin(blocks), std::end(blocks), rng);
+                for(auto block : blocks) {
+                    pool.Deallocate(block);
+                }
+            }
+            passed &= pool.GetPageCount() == 4u;
+        }
+        return passed;
+    });
+    ApplyTest("FixedBlockPool thread cache returns its blocks when the thread exits:",
+              []()->bool {
+        FixedBlockPool pool{ 32u, alignof(std::max_align_t), 16u, true };
+        std::thread worker([&pool]() {
+            std::vector<void*> blocks(64u);
+            for(auto& block : blocks) {
+                block = pool.Allocate();
+            }
+            for(auto block : blocks) {
+                pool.Deallocate(block);
+            }
+        });
+        worker.join();
+        //Any block left in the exited thread's cache would force a fifth page here.
+        std::vector<void*> blocks(64u);
+        for(auto& block : blocks) {
+            block = pool.Allocate();
+        }
+        const bool passed = pool.GetPageCount() == 4u;
+        for(auto block : blocks) {
+            pool.Deallocate(block);
+        }
+        return passed;
+    });
+    ApplyTest("FixedBlockPool blocks allocated on one thread and freed on another are reused:",
+              []()->bool {
+        FixedBlockPool pool{ 32u, alignof(std::max_align_t), 16u, true };
+        std::vector<void*> blocks(64u);
+        bool passed = true;
+        for(int round = 0; round < 16; ++round) {
+            std::thread producer([&pool, &blocks]() {
+                for(auto& block : blocks) {
+                    block = pool.Allocate();
+                    std::memset(block, 0xAB, pool.GetBlockSize());
+                }
+            });
+            producer.join();
+            std::thread consumer([&pool, &blocks]() {
+                for(auto block : blocks) {
+                    pool.Deallocate(block);
+                }
+            });
+            consumer.join();
+            passed &= pool.GetPageCount() == 4u;
+        }
+        return passed;
+    });
+    ApplyTest("FixedBlockPool sized with GetNodeSize serves every std::pmr::list node itself:",
+              []()->bool {
+        //Counts what reaches the heap: pages only, unless nodes are larger than the blocks.
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            std::size_t allocations = 0u;
+        protected:
+            virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                ++allocations;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+                std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+            }
+            virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+        using List = std::pmr::list<std::pair<std::string, int>>;
+        CountingResource upstream{};
+        FixedBlockPool pool{ FixedBlockPool::GetNodeSize<List>(), alignof(std::max_align_t), 64u, true, &upstream };
+        bool passed = true;
+        {
+            List list{ &pool };
+            for(int i = 0; i < 1000; ++i) {
+                list.emplace_back("entry", i);
+            }
+            passed &= pool.GetBlockSize() >= sizeof(List::value_type) + 2u * sizeof(void*);
+            passed &= upstream.allocations == pool.GetPageCount();
+        }
+        return passed;
+    });
+}
+
+void TestFrameArena() {
+    ApplyTest("FrameArena keeps frame N readable through frame N+1 and resets its arena for frame N+2:",
+              []()->bool {
+        constexpr std::size_t bytes = 256u;
+        FrameArena frames{ 1024u };
+        frames.BeginFrame();
+        auto* frame_n = static_cast<unsigned char*>(frames.GetCurrent().allocate(bytes));
+        std::memset(frame_n, 0xA5, bytes);
+        const auto* frame_n_arena = &frames.GetCurrent();
+        frames.BeginFrame();
+        const auto next_starts_empty = frames.GetCurrent().GetUsedBytes() == 0u;
+        auto* frame_n1 = static_cast<unsigned char*>(frames.GetCurrent().allocate(bytes));
+        std::memset(frame_n1, 0x5A, bytes);
+        //Frame N's arena is now the previous one and its bytes are untouched.
+        const auto previous_intact = &frames.GetPrevious() == frame_n_arena
+            && frames.GetPrevious().GetUsedBytes() == bytes
+            && std::all_of(frame_n, frame_n + bytes, [](unsigned char c) { return c == 0xA5; });
+        frames.BeginFrame();
+        //Frame N+2 reuses frame N's arena from its start.
+        const auto reused_reset = &frames.GetCurrent() == frame_n_arena && frames.GetCurrent().GetUsedBytes() == 0u
+            && frames.GetCurrent().allocate(bytes) == frame_n
+            && frames.GetPrevious().GetUsedBytes() == bytes;
+        return frame_n1 != frame_n && next_starts_empty && previous_intact && reused_reset;
+    });
+    ApplyTest("LinearArena serves a full frame from upstream, then grows to fit it on Reset:",
+              []()->bool {
+        //Tracks what the arena holds from upstream so the overflow and its release can be checked.
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            std::size_t allocations = 0u;
+            std::size_t live_allocations = 0u;
+        protected:
+            virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                ++allocations;
+                ++live_allocations;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+                --live_allocations;
+                std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+            }
+            virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+        CountingResource upstream{};
+        bool passed = true;
+        {
+            LinearArena arena{ 256u, &upstream };
+            auto* first = static_cast<unsigned char*>(arena.allocate(200u, 16u));
+            auto* overflow = static_cast<unsigned char*>(arena.allocate(200u, 16u));
+            //The second allocation does not fit, so it comes from upstream, outside the block.
+            passed &= overflow < first || first + 256u <= overflow;
+            passed &= upstream.live_allocations == 2u;
+            passed &= arena.GetUsedBytes() == 400u && arena.GetHighWaterMark() == 400u;
+            std::memset(first, 1, 200u);
+            std::memset(overflow, 2, 200u);
+            arena.Reset();
+            //The overflow is freed and the block replaced by one that holds the whole frame.
+            passed &= upstream.live_allocations == 1u && arena.GetCapacity() >= 400u;
+            passed &= arena.GetUsedBytes() == 0u && arena.GetHighWaterMark() == 400u;
+            const auto allocations_before = upstream.allocations;
+            arena.allocate(200u, 16u);
+            arena.allocate(200u, 16u);
+            passed &= upstream.allocations == allocations_before;
+            arena.Reset();
+            passed &= upstream.live_allocations == 1u;
+        }
+        return passed && upstream.live_allocations == 0u;
+    });
+}
+
+void TestProfiler() {
+    ApplyTest("Profiler reports an exited thread's last scopes once, then frees its ring:",
+              []()->bool {
+        Profiler::Reset();
+        std::thread([]() {
+            Profiler::BeginScope("ExitedThreadScope");
+            Profiler::EndScope();
+        }).join();
+        auto has_scope = [](const Profiler::Frame& frame) {
+            return std::any_of(std::begin(frame.threads), std::end(frame.threads), [](const Profiler::ThreadTree& thread) {
+                return std::any_of(std::begin(thread.root.children), std::end(thread.root.children), [](const Profiler::Node& node) {
+                    return node.name && std::string_view{ node.name } == "ExitedThreadScope";
+                });
+            });
+        };
+        Profiler::EndFrame();
+        const auto drained = Profiler::GetLastFrame();
+        Profiler::EndFrame();
+        const auto next = Profiler::GetLastFrame();
+        const auto thread_count = drained.threads.size();
+        return has_scope(drained) && !has_scope(next) && next.threads.size() < thread_count;
+    });
+}
+
+void TestAllocationProfiler() {
+    ApplyTest("AllocationProfiler ignores frees of allocations recorded before a Reset:",
+              []()->bool {
+        AllocationProfiler::Reset();
+        std::uint32_t hashes[2]{};
+        std::uint16_t generations[2]{};
+        //Both recorded from the same call stack, so both are charged to one site.
+        for(int i = 0; i < 2; ++i) {
+            generations[i] = AllocationProfiler::GetGeneration();
+            hashes[i] = AllocationProfiler::RecordAllocation(64u);
+            if(i == 0) {
+                AllocationProfiler::Reset();
+                AllocationProfiler::RecordFree(hashes[0], 64u, generations[0]);
+            }
+        }
+        auto find_site = [&hashes]() {
+            const auto report = AllocationProfiler::GetReport(AllocationProfiler::SortKey::Bytes, static_cast<std::size_t>(-1));
+            const auto found = std::find_if(std::begin(report.sites), std::end(report.sites), [&hashes](const AllocationProfiler::SiteStats& site) { return site.hash == hashes[1]; });
+            return found != std::end(report.sites) ? *found : AllocationProfiler::SiteStats{};
+        };
+        const auto before_free = find_site();
+        AllocationProfiler::RecordFree(hashes[1], 64u, generations[1]);
+        const auto after_free = find_site();
+        AllocationProfiler::Reset();
+        return hashes[0] == hashes[1] && generations[0] != generations[1]
+            && before_free.alloc_count == 1u && before_free.leaked_count == 1u && before_free.leaked_bytes == 64u
+            && after_free.alloc_count == 1u && after_free.leaked_count == 0u;
+    });
+}
+
+void TestMemory() {
+#ifdef TRACK_MEMORY
+    ApplyTest("Memory charges tagged allocations from 4 threads to the tag's live and frame counts:",
+              []()->bool {
+        constexpr std::size_t thread_count = 4u;
+        constexpr std::size_t blocks_per_thread = 64u;
+        constexpr std::size_t block_size = 48u;
+        const auto was_enabled = Memory::is_enabled();
+        Memory::enable(true);
+        Memory::tick();
+        const auto before = Memory::tag_status(MemoryTag::Audio);
+        //Each thread frees every other block itself and hands the rest back to this one.
+        std::array<std::array<void*, blocks_per_thread>, thread_count> kept{};
+        std::array<std::thread, thread_count> threads{};
+        for(std::size_t t = 0u; t < thread_count; ++t) {
+            threads[t] = std::thread([&blocks = kept[t]]() {
+                MEMORY_TAG_SCOPE(Audio);
+                for(auto& block : blocks) {
+                    block = Memory::allocate(block_size);
+                }
+                for(std::size_t i = 0u; i < blocks.size(); i += 2u) {
+                    Memory::deallocate(blocks[i]);
+                    blocks[i] = nullptr;
+                }
+            });
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+        Memory::tick();
+        const auto after_threads = Memory::tag_status(MemoryTag::Audio);
+        //Frees on this thread are still charged to Audio, the tag in each block's header.
+        for(auto& blocks : kept) {
+            for(auto* block : blocks) {
+                Memory::deallocate(block);
+            }
+        }
+        Memory::tick();
+        const auto after_frees = Memory::tag_status(MemoryTag::Audio);
+        Memory::enable(was_enabled);
+        constexpr auto total = thread_count * blocks_per_thread;
+        return after_threads.live_objs - before.live_objs == total / 2u
+            && after_threads.live_bytes - before.live_bytes == total / 2u * block_size
+            && after_threads.frame_allocs == total && after_threads.frame_alloc_bytes == total * block_size
+            && after_threads.frame_frees == total / 2u && after_threads.frame_free_bytes == total / 2u * block_size
+            && after_frees.live_objs == before.live_objs && after_frees.live_bytes == before.live_bytes
+            && after_frees.frame_allocs == 0u && after_frees.frame_frees == total / 2u;
+    });
+    ApplyTest("Memory counts a block's free only if its allocation was counted, across enable toggles:",
+              []()->bool {
+        constexpr std::size_t block_size = 80u;
+        const auto was_enabled = Memory::is_enabled();
+        MEMORY_TAG_SCOPE(UI);
+        Memory::enable(true);
+        Memory::tick();
+        const auto before = Memory::tag_status(MemoryTag::UI);
+        //Allocated while off, freed while on: neither side is counted.
+        Memory::enable(false);
+        auto* uncounted = Memory::allocate(block_size);
+        Memory::enable(true);
+        Memory::deallocate(uncounted);
+        Memory::tick();
+        const auto after_uncounted = Memory::tag_status(MemoryTag::UI);
+        //Allocated while on, freed while off: the free still balances the allocation.
+        auto* counted = Memory::allocate(block_size);
+        Memory::enable(false);
+        Memory::deallocate(counted);
+        Memory::enable(true);
+        Memory::tick();
+        const auto after_counted = Memory::tag_status(MemoryTag::UI);
+        Memory::enable(was_enabled);
+        return after_uncounted.frame_allocs == 0u && after_uncounted.frame_frees == 0u
+            && after_uncounted.live_bytes == before.live_bytes
+            && after_counted.frame_allocs == 1u && after_counted.frame_frees == 1u
+            && after_counted.frame_free_bytes == block_size
+            && after_counted.live_objs == before.live_objs && after_counted.live_bytes == before.live_bytes;
+    });
+    ApplyTest("Memory timeline keeps the last TIMELINE_FRAMES ticks, oldest first, and writes them as CSV:",
+              []()->bool {
+        constexpr std::size_t extra_frames = 100u;
+        constexpr std::size_t tick_count = Memory::TIMELINE_FRAMES + extra_frames;
+        const auto was_enabled = Memory::is_enabled();
+        Memory::enable(false);
+        Memory::tick();
+        const auto first = Memory::timeline().back().frame_id + 1u;
+        for(std::size_t i = 0u; i < tick_count; ++i) {
+            Memory::tick();
+        }
+        //first is older than the ring now, so the oldest frame still held comes back first.
+        const auto frames = Memory::timeline(first);
+        const auto recent = Memory::timeline(first + tick_count - 10u);
+        const auto none = Memory::timeline(first + tick_count);
+        const auto path = std::filesystem::temp_directory_path() / "MathUnitTests_memtimeline.csv";
+        const auto written = Memory::write_timeline_csv(path);
+        Memory::enable(was_enabled);
+        if(frames.size() != Memory::TIMELINE_FRAMES || recent.size() != 10u || !none.empty() || !written) {
+            std::filesystem::remove(path);
+            return false;
+        }
+        bool passed = frames.front().frame_id == first + extra_frames && recent.front().frame_id == first + tick_count - 10u;
+        for(std::size_t i = 1u; i < frames.size(); ++i) {
+            passed &= frames[i].frame_id == frames[i - 1u].frame_id + 1u;
+            passed &= frames[i].begin_ticks == frames[i - 1u].end_ticks;
+        }
+        std::ifstream file(path);
+        std::vector<std::string> lines{};
+        for(std::string line{}; std::getline(file, line);) {
+            lines.push_back(line);
+        }
+        file.close();
+        std::filesystem::remove(path);
+        //A header plus one row per frame in the ring; begin_ms counts from the oldest frame.
+        return passed && lines.size() == 1u + Memory::TIMELINE_FRAMES
+            && lines[0] == "frame,begin_ms,duration_ms,allocs,alloc_bytes,frees,free_bytes,live_bytes,peak_working_set_bytes"
+            && lines[1].rfind(std::to_string(first + extra_frames) + ",0.000,", 0) == 0u
+            && lines.back().rfind(std::to_string(first + tick_count - 1u) + ",", 0) == 0u;
+    });
+    ApplyTest("MEMORY_TAG_SCOPE restores the thread's previous tag when it ends:",
+              []()->bool {
+        const auto outer = Memory::get_thread_tag();
+        bool inner_ok = false;
+        {
+            MEMORY_TAG_SCOPE(Renderer);
+            {
+                MEMORY_TAG_SCOPE(Jobs);
+                inner_ok = Memory::get_thread_tag() == MemoryTag::Jobs;
+            }
+            inner_ok = inner_ok && Memory::get_thread_tag() == MemoryTag::Renderer;
+        }
+        return inner_ok && Memory::get_thread_tag() == outer;
+    });
+#endif
+}
+
+void TestMemoryBudgets() {
+    ApplyTest("MemoryBudgets ignores byte counts that overflow size_t once scaled:",
+              []()->bool {
+        MemoryBudgets::Budget initial{};
+        initial.soft_bytes = 1024u;
+        MemoryBudgets::SetBudget(MemoryTag::General, initial);
+        //2^64 bytes: wraps to 0 if the multiply is not checked; a rejected value keeps the old budget.
+        Config config(KeyValueParser{ std::string{ "memory_budget_general_soft=17179869184GB\nmemory_budget_general_hard=3GB\n" } });
+        MemoryBudgets::LoadFromConfig(config);
+        const auto budget = MemoryBudgets::GetBudget(MemoryTag::General);
+        MemoryBudgets::SetBudget(MemoryTag::General, MemoryBudgets::Budget{});
+        return budget.soft_bytes == 1024u && budget.hard_bytes == std::size_t{ 3u } * 1024u * 1024u * 1024u;
+    });
+}
+
+void TestFrameStats() {
+    ApplyTest("FrameStats histogram percentiles of 1..10000us land within 1/128 above the exact value:",
+              []()->bool {
+        //About 40KB of buckets; keep it off the stack.
+        auto histogram = std::make_unique<FrameStats::Histogram>();
+        constexpr std::uint64_t sample_count = 10'000u;
+        std::vector<std::uint64_t> samples(sample_count);
+        std::iota(std::begin(samples), std::end(samples), std::uint64_t{ 1u });
+        std::shuffle(std::begin(samples), std::end(samples), std::mt19937_64{ 19u });
+        for(const auto sample : samples) {
+            histogram->Record(sample);
+        }
+        const auto within_precision = [&histogram](double percentile, std::uint64_t exact) {
+            const auto value = histogram->GetPercentile(percentile);
+            return exact <= value && value <= exact + exact / 128u;
+        };
+        return histogram->GetCount() == sample_count
+            && histogram->GetMin() == 1u && histogram->GetMax() == sample_count
+            && histogram->GetMean() == 5000.5
+            && within_precision(0.50, 5000u) && within_precision(0.95, 9500u) && within_precision(0.99, 9900u)
+            && histogram->GetPercentile(1.0) == sample_count;
+    });
+    ApplyTest("FrameStats histogram is exact below SUB_BUCKET_COUNT microseconds:",
+              []()->bool {
+        auto histogram = std::make_unique<FrameStats::Histogram>();
+        for(std::uint64_t value = 1u; value <= 200u; ++value) {
+            histogram->Record(value);
+        }
+        return histogram->GetPercentile(0.50) == 100u && histogram->GetPercentile(0.95) == 190u
+            && histogram->GetPercentile(0.99) == 198u;
+    });
+    ApplyTest("FrameStats reports recorded durations in milliseconds and reset clears every metric:",
+              []()->bool {
+        FrameStats::Reset();
+        for(int ms = 1; ms <= 100; ++ms) {
+            FrameStats::Record(FrameStats::Metric::Update, TimeUtils::FPMilliseconds{ static_cast<float>(ms) });
+        }
+        const auto report = FrameStats::GetReport();
+        const auto& update = report.metrics[static_cast<std::size_t>(FrameStats::Metric::Update)];
+        const auto within_precision = [](double value_ms, double exact_ms) {
+            return exact_ms <= value_ms && value_ms <= exact_ms + exact_ms / 128.0;
+        };
+        const auto recorded = update.count == 100u && update.min_ms == 1.0 && update.max_ms == 100.0
+            && within_precision(update.p50_ms, 50.0) && within_precision(update.p95_ms, 95.0)
+            && within_precision(update.p99_ms, 99.0)
+            && report.metrics[static_cast<std::size_t>(FrameStats::Metric::Render)].count == 0u;
+        FrameStats::Reset();
+        //The first mark after a reset only starts the clock.
+        FrameStats::MarkFrame();
+        const auto after_reset = FrameStats::GetReport();
+        FrameStats::MarkFrame();
+        //Percentiles must come from this sample alone, not from buckets left over before the reset.
+        FrameStats::Record(FrameStats::Metric::Update, TimeUtils::FPMilliseconds{ 200.0f });
+        const auto after_second_mark = FrameStats::GetReport();
+        FrameStats::Reset();
+        const auto& reset_update = after_reset.metrics[static_cast<std::size_t>(FrameStats::Metric::Update)];
+        const auto& next_update = after_second_mark.metrics[static_cast<std::size_t>(FrameStats::Metric::Update)];
+        return recorded && reset_update.count == 0u && reset_update.p99_ms == 0.0 && reset_update.max_ms == 0.0
+            && next_update.count == 1u && next_update.p50_ms == 200.0 && next_update.min_ms == 200.0
+            && after_reset.metrics[static_cast<std::size_t>(FrameStats::Metric::Frame)].count == 0u
+            && after_second_mark.metrics[static_cast<std::size_t>(FrameStats::Metric::Frame)].count == 1u;
+    });
+    ApplyTest("FrameStats AppendCsv writes the header once and one row per metric per call:",
+              []()->bool {
+        const auto path = std::filesystem::temp_directory_path() / "MathUnitTests_framestats.csv";
+        std::filesystem::remove(path);
+        FrameStats::Reset();
+        FrameStats::Record(FrameStats::Metric::Render, TimeUtils::FPMilliseconds{ 4.0f });
+        const auto appended = FrameStats::AppendCsv(path) && FrameStats::AppendCsv(path);
+        FrameStats::Reset();
+        std::ifstream file(path);
+        std::vector<std::string> lines{};
+        for(std::string line{}; std::getline(file, line);) {
+            lines.push_back(line);
+        }
+        file.close();
+        std::filesystem::remove(path);
+        constexpr auto metric_count = static_cast<std::size_t>(FrameStats::Metric::Max);
+        if(!appended || lines.size() != 1u + 2u * metric_count) {
+            return false;
+        }
+        //Rows are timestamp,metric,count,mean,min,p50,... with the metrics in enum order.
+        const auto render_row = lines[1u + static_cast<std::size_t>(FrameStats::Metric::Render)];
+        return lines[0] == "timestamp,metric,count,mean_ms,min_ms,p50_ms,p90_ms,p95_ms,p99_ms,p99.9_ms,max_ms"
+            && render_row.find(",Render,1,4.000,4.000,4.000,") != std::string::npos
+            && lines[1u + metric_count].find(",Frame,0,") != std::string::npos;
+    });
+}
+
+void TestJobInstrumentation() {
+    ApplyTest("JobInstrumentation collects every record from exited threads, then frees their rings:",
+              []()->bool {
+        JobInstrumentation::Reset();
+        //Each thread records a job and exits before the next starts; its ring is retired but not yet drained.
+        constexpr std::uint64_t thread_count = 64u;
+        for(std::uint64_t i = 0u; i < thread_count; ++i) {
+            std::thread([]() {
+                const auto now = JobInstrumentation::Now();
+                JobInstrumentation::RecordJob(JobType::Generic, 1u, JobInstrumentation::NOT_A_WORKER, now, now, now);
+            }).join();
+        }
+        const auto drained = JobInstrumentation::GetReport();
+        //The freed rings must not be drained again.
+        const auto next = JobInstrumentation::GetReport();
+        JobInstrumentation::Reset();
+        const auto& generic = drained.categories[static_cast<std::size_t>(JobType::Generic)];
+        return generic.run_ns.count == thread_count && drained.jobs_on_other_threads == thread_count
+            && next.categories[static_cast<std::size_t>(JobType::Generic)].run_ns.count == thread_count;
+    });
+}
+
+void TestSamplingProfiler() {
+#if defined(PROFILE_BUILD) && defined(PLATFORM_LINUX)
+    ApplyTest("SamplingProfiler samples a spinning thread and writes one folded line per stack:",
+              []()->bool {
+        if(!SamplingProfiler::Start(1000u)) {
+            return false;
+        }
+        //SIGPROF follows process CPU time, so the spin has to burn CPU rather than sleep.
+        volatile std::uint64_t sink = 0u;
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+        while(std::chrono::steady_clock::now() < end) {
+            for(int i = 0; i < 1000; ++i) {
+                sink = sink + static_cast<std::uint64_t>(i);
+            }
+        }
+        SamplingProfiler::Stop();
+        const auto report = SamplingProfiler::GetReport(10u);
+        const auto path = std::filesystem::temp_directory_path() / "MathUnitTests_sampler.folded";
+        if(report.sample_count == 0u || !SamplingProfiler::WriteCollapsedStacks(path)) {
+            return false;
+        }
+        //"root;...;leaf count" per line, and the counts add up to the samples taken.
+        std::ifstream file(path);
+        std::uint64_t folded_count = 0u;
+        std::string line{};
+        while(std::getline(file, line)) {
+            const auto space = line.rfind(' ');
+            if(space == std::string::npos || space == 0u) {
+                return false;
+            }
+            folded_count += std::stoull(line.substr(space + 1u));
+        }
+        file.close();
+        std::filesystem::remove(path);
+        SamplingProfiler::Reset();
+        return folded_count == report.sample_count;
+    });
+    ApplyTest("SamplingProfiler asked for 5 MHz samples at its cap instead of disarming the timer:",
+              []()->bool {
+        if(!SamplingProfiler::Start(5'000'000u)) {
+            return false;
+        }
+        volatile std::uint64_t sink = 0u;
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        while(std::chrono::steady_clock::now() < end) {
+            for(int i = 0; i < 1000; ++i) {
+                sink = sink + static_cast<std::uint64_t>(i);
+            }
+        }
+        SamplingProfiler::Stop();
+        const auto report = SamplingProfiler::GetReport(1u);
+        SamplingProfiler::Reset();
+        return report.frequency_hz == 10'000u && report.sample_count > 0u;
+    });
+#endif
+}
+
+void TestCpuTopology() {
+#ifdef PLATFORM_LINUX
+    //Two packages with ids 0 and 3 and repeated core ids; package 0 has SMT siblings 4 and 5.
+    ApplyTest("GetCpuDescFromSysfs groups Data/Fixtures/SysfsCpu into 2 sockets and 4 cores:",
+              []()->bool {
+        const auto desc = System::Cpu::GetCpuDescFromSysfs("Data/Fixtures/SysfsCpu");
+        const std::vector<std::pair<int, std::vector<int>>> expected{ { 0, { 0, 4 } }, { 0, { 1, 5 } }, { 1, { 2 } }, { 1, { 3 } } };
+        if(desc.logicalCount != 6 || desc.socketCount != 2 || desc.coreCount != 4 || desc.cores.size() != expected.size()) {
+            return false;
+        }
+        for(std::size_t i = 0; i < expected.size(); ++i) {
+            if(desc.cores[i].socket != expected[i].first || desc.cores[i].logicalProcessors != expected[i].second) {
+                return false;
+            }
+        }
+        return true;
+    });
+    ApplyTest("GetCpuDescFromSysfs reads per-instance cache sizes and skips the instruction cache:",
+              []()->bool {
+        const auto desc = System::Cpu::GetCpuDescFromSysfs("Data/Fixtures/SysfsCpu");
+        return desc.cacheLineSize == 64u
+            && desc.l1DataCacheSize == 32u * 1024u
+            && desc.l2CacheSize == 1024u * 1024u
+            && desc.l3CacheSize == 16u * 1024u * 1024u;
+    });
+#endif
+}
@@ -0,0 +1,1086 @@
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Engine/Core/Base64.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/KeyValueParser.hpp"
+#include "Engine/Core/LockFreeQueue.hpp"
+#include "Engine/Core/Obj.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/ThreadSafeQueue.hpp"
+#include "Engine/Core/Vertex3D.hpp"
+
+#include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Disc2.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/Matrix4.hpp"
+#include "Engine/Math/Matrix4Simd.hpp"
+#include "Engine/Math/Noise.hpp"
+#include "Engine/Math/OBB2.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Sphere3.hpp"
+
+#include "Engine/Memory/MemoryPool.hpp"
+#include "Engine/Memory/TlsfAllocator.hpp"
+
+#include "Engine/Profiling/JobInstrumentation.hpp"
+
+#include "Engine/System/Cpu.hpp"
+
+#include "MicroBenchmark.hpp"
+
+using MicroBenchmark::DoNotOptimize;
+
+void PrintUsage();
+bool ParseArguments(int argc, char** argv, MicroBenchmark::Options& options, bool& listOnly);
+
+#pragma region Benchmarks
+void AddMatrix4Benchmarks(MicroBenchmark::Runner& runner);
+void AddQuaternionBenchmarks(MicroBenchmark::Runner& runner);
+void AddOverlapBenchmarks(MicroBenchmark::Runner& runner);
+void AddNoiseBenchmarks(MicroBenchmark::Runner& runner);
+void AddStringBenchmarks(MicroBenchmark::Runner& runner);
+void AddBase64Benchmarks(MicroBenchmark::Runner& runner);
+void AddKeyValueParserBenchmarks(MicroBenchmark::Runner& runner);
+void AddObjBenchmarks(MicroBenchmark::Runner& runner);
+void AddJobSystemBenchmarks(MicroBenchmark::Runner& runner);
+void AddQueueBenchmarks(MicroBenchmark::Runner& runner);
+void AddJobPriorityBenchmarks(MicroBenchmark::Runner& runner);
+void AddWorkerWakeupBenchmarks(MicroBenchmark::Runner& runner);
+void AddJobInstrumentationBenchmarks(MicroBenchmark::Runner& runner);
+void AddWorkerPinningBenchmarks(MicroBenchmark::Runner& runner);
+void AddBlockPoolBenchmarks(MicroBenchmark::Runner& runner);
+void AddTlsfBenchmarks(MicroBenchmark::Runner& runner);
+#pragma endregion
+
+int main(int argc, char** argv) {
+    MicroBenchmark::Options options{};
+    bool list_only = false;
+    if(!ParseArguments(argc, argv, options, list_only)) {
+        PrintUsage();
+        return 2;
+    }
+
+    MicroBenchmark::Runner runner(options);
+    AddMatrix4Benchmarks(runner);
+    AddQuaternionBenchmarks(runner);
+    AddOverlapBenchmarks(runner);
+    AddNoiseBenchmarks(runner);
+    AddStringBenchmarks(runner);
+    AddBase64Benchmarks(runner);
+    AddKeyValueParserBenchmarks(runner);
+    AddObjBenchmarks(runner);
+    AddJobSystemBenchmarks(runner);
+    AddQueueBenchmarks(runner);
+    AddJobPriorityBenchmarks(runner);
+    AddWorkerWakeupBenchmarks(runner);
+    AddJobInstrumentationBenchmarks(runner);
+    AddWorkerPinningBenchmarks(runner);
+    AddBlockPoolBenchmarks(runner);
+    AddTlsfBenchmarks(runner);
+
+    if(list_only) {
+        for(const auto& name : runner.List()) {
+            std::cout << name << '\n';
+        }
+        return 0;
+    }
+    const auto results = runner.Run(std::cout);
+    if(!options.json_path.empty() && !MicroBenchmark::Runner::WriteJson(options.json_path, results)) {
+        std::cerr << "Could not write " << options.json_path.string() << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+void PrintUsage() {
+    std::cout << "Usage: MicroBenchmarks [options]\n"
+              << "  --filter=TEXT       Run only benchmarks whose names contain TEXT.\n"
+              << "  --repetitions=N     Timed repetitions per benchmark (default 20).\n"
+              << "  --min-time-ms=N     Minimum length of one repetition (default 20).\n"
+              << "  --warmup-ms=N       Untimed warmup per benchmark (default 100).\n"
+              << "  --json=FILE         Also write the results to FILE as JSON.\n"
+              << "  --list              List the benchmarks instead of running them.\n";
+}
+
+bool ParseArguments(int argc, char** argv, MicroBenchmark::Options& options, bool& listOnly) {
+    auto parse_count = [](std::string_view text, auto& value) {
+        if(text.empty() || text.find_first_not_of("0123456789") != std::string_view::npos) {
+            return false;
+        }
+        value = static_cast<std::remove_reference_t<decltype(value)>>(std::stoull(std::string{ text }));
+        return true;
+    };
+    for(int i = 1; i < argc; ++i) {
+        const std::string_view arg{ argv[i] };
+        const auto [key, value] = [&arg]() {
+            const auto eq = arg.find('=');
+            return eq == std::string_view::npos ? std::make_pair(arg, std::string_view{}) : std::make_pair(arg.substr(0, eq), arg.substr(eq + 1));
+        }();
+        std::uint64_t count = 0u;
+        if(key == "--list") {
+            listOnly = true;
+        } else if(key == "--filter") {
+            options.filter = std::string{ value };
+        } else if(key == "--json" && !value.empty()) {
+            options.json_path = std::string{ value };
+        } else if(key == "--repetitions" && parse_count(value, count) && count > 0u) {
+            options.repetitions = static_cast<std::size_t>(count);
+        } else if(key == "--min-time-ms" && parse_count(value, count) && count > 0u) {
+            options.min_repetition_time = std::chrono::milliseconds{ count };
+        } else if(key == "--warmup-ms" && parse_count(value, count)) {
+            options.warmup_time = std::chrono::milliseconds{ count };
+        } else {
+            std::cerr << "Unknown or malformed argument: " << arg << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+//Inputs are cycled through so no benchmark measures one constant-folded case.
+constexpr std::size_t INPUT_COUNT = 256u;
+constexpr std::size_t INPUT_MASK = INPUT_COUNT - 1u;
+//Points per batch-transform iteration, a small mesh.
+constexpr std::size_t BATCH_SIZE = 1024u;
+
+float RandomFloat(std::mt19937& rng, float lower, float upper) {
+    return std::uniform_real_distribution<float>{ lower, upper }(rng);
+}
+
+Matrix4 RandomTransform(std::mt19937& rng) {
+    const auto rotation = Matrix4::Create3DYRotationDegreesMatrix(RandomFloat(rng, 0.0f, 360.0f)) * Matrix4::Create3DXRotationDegreesMatrix(RandomFloat(rng, 0.0f, 360.0f));
+    const auto scale = Matrix4::CreateScaleMatrix(RandomFloat(rng, 0.5f, 2.0f));
+    const auto translation = Matrix4::CreateTranslationMatrix(Vector3(RandomFloat(rng, -100.0f, 100.0f), RandomFloat(rng, -100.0f, 100.0f), RandomFloat(rng, -100.0f, 100.0f)));
+    return translation * rotation * scale;
+}
+
+void AddMatrix4Benchmarks(MicroBenchmark::Runner& runner) {
+    std::mt19937 rng(1729u);
+    std::vector<Matrix4> matrices(INPUT_COUNT);
+    for(auto& m : matrices) {
+        m = RandomTransform(rng);
+    }
+    runner.Add("Matrix4/Multiply", [matrices](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(matrices[i & INPUT_MASK] * matrices[(i + 1u) & INPUT_MASK]);
+        }
+    });
+    runner.Add("Matrix4/TransformVector4", [matrices](std::uint64_t iterations) {
+        const Vector4 v(1.0f, 2.0f, 3.0f, 1.0f);
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(matrices[i & INPUT_MASK] * v);
+        }
+    });
+    runner.Add("Matrix4/Inverse", [matrices](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(Matrix4::CalculateInverse(matrices[i & INPUT_MASK]));
+        }
+    });
+    runner.Add("Matrix4/InverseAffine", [matrices](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(Matrix4::CalculateInverseAffine(matrices[i & INPUT_MASK]));
+        }
+    });
+    //CalculateInverse on the same affine inputs, paying for the IsAffine check.
+    runner.Add("Matrix4/InverseAffineDetected", [matrices](std::uint64_t iterations) {
+        const auto previous = Matrix4::IsAffineInverseDetectionEnabled();
+        Matrix4::SetAffineInverseDetection(true);
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(Matrix4::CalculateInverse(matrices[i & INPUT_MASK]));
+        }
+        Matrix4::SetAffineInverseDetection(previous);
+    });
+    std::vector<Matrix4> rigid_matrices(INPUT_COUNT);
+    for(auto& m : rigid_matrices) {
+        m = RandomTransform(rng);
+        m = Matrix4(m.GetIBasis().GetNormalize3D(), m.GetJBasis().GetNormalize3D(), m.GetKBasis().GetNormalize3D(), m.GetTBasis());
+    }
+    runner.Add("Matrix4/InverseRigid", [rigid_matrices](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(Matrix4::CalculateInverseRigid(rigid_matrices[i & INPUT_MASK]));
+        }
+    });
+    std::vector<Vector3> positions(BATCH_SIZE);
+    std::vector<Vertex3D> vertices(BATCH_SIZE);
+    for(std::size_t i = 0u; i < BATCH_SIZE; ++i) {
+        positions[i] = Vector3(RandomFloat(rng, -1.0f, 1.0f), RandomFloat(rng, -1.0f, 1.0f), RandomFloat(rng, -1.0f, 1.0f));
+        vertices[i].position = positions[i];
+        vertices[i].normal = positions[i].GetNormalize();
+    }
+    //The same operations pinned to each kernel level this CPU supports, to compare against the scalar code.
+    for(auto level : { Matrix4Simd::Level::Scalar, Matrix4Simd::Level::Sse4, Matrix4Simd::Level::Avx2 }) {
+        if(static_cast<int>(level) > static_cast<int>(Matrix4Simd::GetSupportedLevel())) {
+            break;
+        }
+        const auto suffix = "/" + to_string(level);
+        runner.Add("Matrix4/Multiply" + suffix, [matrices, level](std::uint64_t iterations) {
+            const auto previous = Matrix4Simd::GetLevel();
+            Matrix4Simd::SetLevel(level);
+            for(std::uint64_t i = 0u; i < iterations; ++i) {
+                DoNotOptimize(matrices[i & INPUT_MASK] * matrices[(i + 1u) & INPUT_MASK]);
+            }
+            Matrix4Simd::SetLevel(previous);
+        });
+        runner.Add("Matrix4/TransformPosition" + suffix, [matrices, level](std::uint64_t iterations) {
+            const Vector3 p(1.0f, 2.0f, 3.0f);
+            const auto previous = Matrix4Simd::GetLevel();
+            Matrix4Simd::SetLevel(level);
+            for(std::uint64_t i = 0u; i < iterations; ++i) {
+                DoNotOptimize(matrices[i & INPUT_MASK].TransformPosition(p));
+            }
+            Matrix4Simd::SetLevel(previous);
+        });
+        runner.Add("Matrix4/Inverse" + suffix, [matrices, level](std::uint64_t iterations) {
+            const auto previous = Matrix4Simd::GetLevel();
+            Matrix4Simd::SetLevel(level);
+            for(std::uint64_t i = 0u; i < iterations; ++i) {
+                DoNotOptimize(Matrix4::CalculateInverse(matrices[i & INPUT_MASK]));
+            }
+            Matrix4Simd::SetLevel(previous);
+        });
+        //One iteration is a whole batch; the Scalar level is the same per-element TransformPosition loop.
+        runner.Add("Matrix4/TransformPositions" + suffix, [matrices, positions, level](std::uint64_t iterations) {
+            std::vector<Vector3> result(positions.size());
+            const auto previous = Matrix4Simd::GetLevel();
+            Matrix4Simd::SetLevel(level);
+            for(std::uint64_t i = 0u; i < iterations; ++i) {
+                MathUtils::TransformPositions(matrices[i & INPUT_MASK], positions.data(), result.data(), result.size());
+                DoNotOptimize(result.data());
+            }
+            Matrix4Simd::SetLevel(previous);
+        });
+        runner.Add("Matrix4/TransformVertices" + suffix, [matrices, vertices, level](std::uint64_t iterations) {
+            std::vector<Vertex3D> result(vertices.size());
+            const auto previous = Matrix4Simd::GetLevel();
+            Matrix4Simd::SetLevel(level);
+            for(std::uint64_t i = 0u; i < iterations; ++i) {
+                MathUtils::TransformVertices(matrices[i & INPUT_MASK], vertices.data(), result.data(), result.size());
+                DoNotOptimize(result.data());
+            }
+            Matrix4Simd::SetLevel(previous);
+        });
+    }
+}
+
+void AddQuaternionBenchmarks(MicroBenchmark::Runner& runner) {
+    std::mt19937 rng(1729u);
+    std::vector<Quaternion> rotations{};
+    rotations.reserve(INPUT_COUNT);
+    for(std::size_t i = 0u; i < INPUT_COUNT; ++i) {
+        rotations.push_back(Quaternion::CreateFromEulerAnglesDegrees(RandomFloat(rng, -90.0f, 90.0f), RandomFloat(rng, 0.0f, 360.0f), RandomFloat(rng, 0.0f, 360.0f)));
+    }
+    runner.Add("Quaternion/SLERP", [rotations](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            const auto t = static_cast<float>(i & INPUT_MASK) / static_cast<float>(INPUT_MASK);
+            DoNotOptimize(MathUtils::SLERP(rotations[i & INPUT_MASK], rotations[(i + 7u) & INPUT_MASK], t));
+        }
+    });
+}
+
+void AddOverlapBenchmarks(MicroBenchmark::Runner& runner) {
+    std::mt19937 rng(1729u);
+    auto random_point2 = [&rng]() { return Vector2(RandomFloat(rng, -10.0f, 10.0f), RandomFloat(rng, -10.0f, 10.0f)); };
+    auto random_point3 = [&rng]() { return Vector3(RandomFloat(rng, -10.0f, 10.0f), RandomFloat(rng, -10.0f, 10.0f), RandomFloat(rng, -10.0f, 10.0f)); };
+    std::vector<AABB2> aabb2s{};
+    std::vector<AABB3> aabb3s{};
+    std::vector<Disc2> discs{};
+    std::vector<Sphere3> spheres{};
+    std::vector<OBB2> obbs{};
+    for(std::size_t i = 0u; i < INPUT_COUNT; ++i) {
+        aabb2s.emplace_back(random_point2(), RandomFloat(rng, 0.5f, 4.0f), RandomFloat(rng, 0.5f, 4.0f));
+        aabb3s.emplace_back(random_point3(), RandomFloat(rng, 0.5f, 4.0f), RandomFloat(rng, 0.5f, 4.0f), RandomFloat(rng, 0.5f, 4.0f));
+        discs.emplace_back(random_point2(), RandomFloat(rng, 0.5f, 4.0f));
+        spheres.emplace_back(random_point3(), RandomFloat(rng, 0.5f, 4.0f));
+        obbs.emplace_back(random_point2(), RandomFloat(rng, 0.5f, 4.0f), RandomFloat(rng, 0.5f, 4.0f), RandomFloat(rng, 0.0f, 360.0f));
+    }
+    runner.Add("MathUtils/DoAABBsOverlap2D", [aabb2s](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::DoAABBsOverlap(aabb2s[i & INPUT_MASK], aabb2s[(i + 1u) & INPUT_MASK]));
+        }
+    });
+    runner.Add("MathUtils/DoAABBsOverlap3D", [aabb3s](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::DoAABBsOverlap(aabb3s[i & INPUT_MASK], aabb3s[(i + 1u) & INPUT_MASK]));
+        }
+    });
+    runner.Add("MathUtils/DoDiscsOverlap", [discs](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::DoDiscsOverlap(discs[i & INPUT_MASK], discs[(i + 1u) & INPUT_MASK]));
+        }
+    });
+    runner.Add("MathUtils/DoSpheresOverlap", [spheres](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::DoSpheresOverlap(spheres[i & INPUT_MASK], spheres[(i + 1u) & INPUT_MASK]));
+        }
+    });
+    runner.Add("MathUtils/DoOBBsOverlap", [obbs](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::DoOBBsOverlap(obbs[i & INPUT_MASK], obbs[(i + 1u) & INPUT_MASK]));
+        }
+    });
+}
+
+void AddNoiseBenchmarks(MicroBenchmark::Runner& runner) {
+    runner.Add("Noise/Get2dNoiseUint", [](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::Get2dNoiseUint(static_cast<int>(i & 0xFFFu), static_cast<int>(i >> 12u), 17u));
+        }
+    });
+    runner.Add("Noise/Compute2dFractalNoise4", [](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::Compute2dFractalNoise(static_cast<float>(i & 0xFFFu) * 0.37f, static_cast<float>(i >> 12u) * 0.37f, 8.0f, 4u));
+        }
+    });
+    runner.Add("Noise/Compute2dPerlinNoise4", [](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::Compute2dPerlinNoise(static_cast<float>(i & 0xFFFu) * 0.37f, static_cast<float>(i >> 12u) * 0.37f, 8.0f, 4u));
+        }
+    });
+    runner.Add("Noise/Compute3dPerlinNoise4", [](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(MathUtils::Compute3dPerlinNoise(static_cast<float>(i & 0xFFu) * 0.37f, static_cast<float>((i >> 8u) & 0xFFu) * 0.37f, static_cast<float>(i >> 16u) * 0.37f, 8.0f, 4u));
+        }
+    });
+}
+
+void AddStringBenchmarks(MicroBenchmark::Runner& runner) {
+    std::string csv_line{};
+    for(int i = 0; i < 64; ++i) {
+        csv_line += (i ? "," : "") + std::to_string(i * 7919);
+    }
+    runner.Add("StringUtils/Split64", [csv_line](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(StringUtils::Split(csv_line, ','));
+        }
+    });
+}
+
+void AddBase64Benchmarks(MicroBenchmark::Runner& runner) {
+    std::mt19937 rng(1729u);
+    std::vector<unsigned char> bytes(4096u);
+    for(auto& byte : bytes) {
+        byte = static_cast<unsigned char>(rng());
+    }
+    const auto encoded = FileUtils::Base64::Encode(bytes);
+    runner.Add("Base64/Encode4KB", [bytes](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(FileUtils::Base64::Encode(bytes));
+        }
+    });
+    runner.Add("Base64/Decode4KB", [encoded](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            DoNotOptimize(FileUtils::Base64::Decode(encoded));
+        }
+    });
+}
+
+void AddKeyValueParserBenchmarks(MicroBenchmark::Runner& runner) {
+    std::ostringstream ss;
+    for(int i = 0; i < 64; ++i) {
+        switch(i % 4) {
+        case 0: ss << "key_" << i << " = " << i * 31 << "\n"; break;
+        case 1: ss << "name_" << i << " = \"value " << i << "\"\n"; break;
+        case 2: ss << "+flag_" << i << "\n"; break;
+        default: ss << "# comment " << i << "\n"; break;
+        }
+    }
+    runner.Add("KeyValueParser/Parse64Lines", [text = ss.str()](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            KeyValueParser parser(text);
+            DoNotOptimize(parser);
+        }
+    });
+}
+
+//A size x size grid of quads with positions, texture coordinates and normals.
+std::string GenerateGridObj(int size) {
+    std::ostringstream ss;
+    for(int y = 0; y <= size; ++y) {
+        for(int x = 0; x <= size; ++x) {
+            ss << "v " << x << ".0 0.0 " << y << ".0\n";
+            ss << "vt " << static_cast<float>(x) / size << ' ' << static_cast<float>(y) / size << '\n';
+        }
+    }
+    ss << "vn 0.0 1.0 0.0\n";
+    const auto index = [size](int x, int y) { return y * (size + 1) + x + 1; };
+    for(int y = 0; y < size; ++y) {
+        for(int x = 0; x < size; ++x) {
+            const int a = index(x, y);
+            const int b = index(x + 1, y);
+            const int c = index(x + 1, y + 1);
+            const int d = index(x, y + 1);
+            ss << "f " << a << '/' << a << "/1 " << b << '/' << b << "/1 " << c << '/' << c << "/1\n";
+            ss << "f " << a << '/' << a << "/1 " << c << '/' << c << "/1 " << d << '/' << d << "/1\n";
+        }
+    }
+    return ss.str();
+}
+
+void AddObjBenchmarks(MicroBenchmark::Runner& runner) {
+    //Obj only loads from disk; the file stays in the OS cache, so this mostly measures parsing.
+    std::error_code ec{};
+    const auto path = std::filesystem::temp_directory_path(ec) / "MicroBenchmarks_grid64.obj";
+    {
+        std::ofstream file(path, std::ios_base::out | std::ios_base::trunc);
+        file << GenerateGridObj(64);
+        if(!file) {
+            std::cerr << "Could not write " << path.string() << "; skipping Obj benchmarks.\n";
+            return;
+        }
+    }
+    runner.Add("Obj/LoadGrid64", [filepath = path.string()](std::uint64_t iterations) {
+        for(std::uint64_t i = 0u; i < iterations; ++i) {
+            FileUtils::Obj obj{};
+            DoNotOptimize(obj.Load(filepath));
+            DoNotOptimize(obj.GetIbo().size());
+        }
+    });
+}
+
+//1, 2, 4... up to and including maxCount.
+std::vector<int> GetThreadCounts(int maxCount) {
+    std::vector<int> counts{};
+    for(int count = 1; count < maxCount; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(maxCount);
+    return counts;
+}
+
+//One generic worker per hardware thread, less the submitting thread.
+int GetMaxGenericWorkerCount() {
+    return (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
+
+//Nearest rank; samples must not be empty.
+double GetPercentile(std::vector<double> samples, double percentile) {
+    const auto index = static_cast<std::size_t>(percentile * static_cast<double>(samples.size() - 1u));
+    std::nth_element(std::begin(samples), std::begin(samples) + index, std::end(samples));
+    return samples[index];
+}
+
+double GetElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>{ std::chrono::steady_clock::now() - start }.count();
+}
+
+//Runs jobCount empty jobs on a fresh JobSystem, submitted from this thread or fanned out from
+//one root job per worker. Starting and stopping the workers is amortized over the repetition.
+void RunEmptyJobs(int workerCount, std::uint64_t jobCount, bool spawnFromJobs) {
+    std::condition_variable main_signal{};
+    std::atomic<std::uint64_t> completed{ 0u };
+    JobSystem js(workerCount, static_cast<std::size_t>(JobType::Max), &main_signal);
+    auto empty_job = [&completed](void*) { ++completed; };
+    if(spawnFromJobs) {
+        const auto roots = (std::min)(static_cast<std::uint64_t>(workerCount), jobCount);
+        const auto spawned = jobCount - roots;
+        for(std::uint64_t i = 0; i < roots; ++i) {
+            const auto children = spawned / roots + (i < spawned % roots ? 1u : 0u);
+            js.Run(JobType::Generic, [&js, &completed, &empty_job, children](void*) {
+                for(std::uint64_t j = 0; j < children; ++j) {
+                    js.Run(JobType::Generic, empty_job, nullptr);
+                }
+                ++completed;
+            }, nullptr);
+        }
+    } else {
+        for(std::uint64_t i = 0; i < jobCount; ++i) {
+            js.Run(JobType::Generic, empty_job, nullptr);
+        }
+    }
+    while(completed < jobCount) {
+        std::this_thread::yield();
+    }
+}
+
+void AddJobSystemBenchmarks(MicroBenchmark::Runner& runner) {
+    for(auto count : GetThreadCounts(GetMaxGenericWorkerCount())) {
+        const auto suffix = "/Workers:" + std::to_string(count);
+        runner.Add("JobSystem/MainSubmit" + suffix, [count](std::uint64_t iterations) {
+            RunEmptyJobs(count, iterations, false);
+        });
+        runner.Add("JobSystem/JobSubmit" + suffix, [count](std::uint64_t iterations) {
+            RunEmptyJobs(count, iterations, true);
+        });
+    }
+}
+
+//pairs producers push itemCount items between them while pairs consumers pop them.
+template<typename Queue>
+void TransferItems(Queue& queue, int pairs, std::uint64_t itemCount) {
+    std::atomic_bool go{ false };
+    std::atomic<std::uint64_t> popped{ 0u };
+    const auto producer_count = static_cast<std::uint64_t>(pairs);
+    std::vector<std::thread> threads{};
+    for(std::uint64_t i = 0; i < producer_count; ++i) {
+        const auto items = itemCount / producer_count + (i < itemCount % producer_count ? 1u : 0u);
+        threads.emplace_back([&queue, &go, items]() {
+            while(!go) {
+                std::this_thread::yield();
+            }
+            for(std::uint64_t j = 0; j < items; ++j) {
+                queue.push(static_cast<int>(j));
+            }
+        });
+        threads.emplace_back([&queue, &go, &popped, itemCount]() {
+            while(!go) {
+                std::this_thread::yield();
+            }
+            int value = 0;
+            while(popped < itemCount) {
+                if(queue.try_pop(value)) {
+                    ++popped;
+                }
+            }
+        });
+    }
+    go = true;
+    for(auto& t : threads) {
+        t.join();
+    }
+}
+
+//One iteration is one item pushed and popped, with N producers and N consumers contending.
+void AddQueueBenchmarks(MicroBenchmark::Runner& runner) {
+    const auto max_pairs = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+    for(int pairs = 1; pairs <= max_pairs; pairs *= 2) {
+        const auto suffix = "/Pairs:" + std::to_string(pairs);
+        runner.Add("Queue/ThreadSafeQueue" + suffix, [pairs](std::uint64_t iterations) {
+            ThreadSafeQueue<int> queue{};
+            TransferItems(queue, pairs, iterations);
+        });
+        runner.Add("Queue/LockFreeQueue" + suffix, [pairs](std::uint64_t iterations) {
+            LockFreeQueue<int> queue{ 1u << 16 };
+            TransferItems(queue, pairs, iterations);
+        });
+    }
+}
+
+//Floods the generic workers with 20 us Low priority jobs, then submits probeCount probes at
+//probePriority 100 us apart. Returns the 99th percentile of the probes' submit-to-start waits, in nanoseconds.
+double MeasureProbeWaitP99(int workerCount, const JobPriority& probePriority, std::uint64_t probeCount) {
+    struct Probe {
+        std::chrono::steady_clock::time_point submitted{};
+        double wait_ns = 0.0;
+    };
+    constexpr std::uint64_t background_per_probe = 20u;
+    constexpr std::chrono::microseconds background_cost{ 20 };
+    constexpr std::chrono::microseconds probe_interval{ 100 };
+    const auto background_count = background_per_probe * probeCount;
+
+    std::condition_variable main_signal{};
+    std::atomic<std::uint64_t> background_done{ 0u };
+    std::atomic<std::uint64_t> probes_done{ 0u };
+    std::vector<Probe> probes(probeCount);
+    {
+        JobSystem js(workerCount, static_cast<std::size_t>(JobType::Max), &main_signal);
+        auto background_job = [&background_done, background_cost](void*) {
+            const auto start = std::chrono::steady_clock::now();
+            while(std::chrono::steady_clock::now() - start < background_cost) {
+                /* DO NOTHING */
+            }
+            ++background_done;
+        };
+        for(std::uint64_t i = 0; i < background_count; ++i) {
+            js.Run(JobType::Generic, background_job, nullptr, JobPriority::Low);
+        }
+        for(auto& probe : probes) {
+            const auto next = std::chrono::steady_clock::now() + probe_interval;
+            while(std::chrono::steady_clock::now() < next) {
+                std::this_thread::yield();
+            }
+            probe.submitted = std::chrono::steady_clock::now();
+            js.Run(JobType::Generic, [&probes_done](void* user_data) {
+                auto p = static_cast<Probe*>(user_data);
+                p->wait_ns = GetElapsedNanoseconds(p->submitted);
+                ++probes_done;
+            }, &probe, probePriority);
+        }
+        while(probes_done < probeCount || background_done < background_count) {
+            std::this_thread::yield();
+        }
+    }
+    std::vector<double> waits{};
+    waits.reserve(probes.size());
+    for(const auto& probe : probes) {
+        waits.push_back(probe.wait_ns);
+    }
+    return GetPercentile(std::move(waits), 0.99);
+}
+
+//Reports the p99 submit-to-start wait of one probe under Low priority background load, per priority.
+void AddJobPriorityBenchmarks(MicroBenchmark::Runner& runner) {
+    const auto worker_count = GetMaxGenericWorkerCount();
+    const std::vector<std::pair<std::string, JobPriority>> priorities{
+        {"High", JobPriority::High},
+        {"Normal", JobPriority::Normal},
+        {"Low", JobPriority::Low},
+    };
+    for(const auto& [name, priority] : priorities) {
+        runner.AddManual("JobSystem/ProbeWaitP99/" + name, [worker_count, priority = priority](std::uint64_t iterations) {
+            return MeasureProbeWaitP99(worker_count, priority, iterations) * static_cast<double>(iterations);
+        });
+    }
+}
+
+//The generic-worker idle path JobSystem used before per-worker parking, kept as the wakeup baseline:
+//idle workers wait on one shared condition_variable and every dispatch notifies one of them.
+class ConditionVariableWorkers {
+public:
+    explicit ConditionVariableWorkers(int worker_count);
+    ~ConditionVariableWorkers();
+    void Run(std::function<void()> job);
+private:
+    void Worker();
+    LockFreeQueue<std::function<void()>> _jobs{ 4096u };
+    std::vector<std::thread> _threads{};
+    std::mutex _cs{};
+    std::condition_variable _signal{};
+    std::atomic_bool _is_running{ true };
+    std::atomic<std::size_t> _pending{ 0u };
+    std::atomic<std::size_t> _sleeping_workers{ 0u };
+};
+
+ConditionVariableWorkers::ConditionVariableWorkers(int worker_count) {
+    for(int i = 0; i < worker_count; ++i) {
+        _threads.emplace_back(&ConditionVariableWorkers::Worker, this);
+    }
+}
+
+ConditionVariableWorkers::~ConditionVariableWorkers() {
+    {
+        std::scoped_lock<std::mutex> lock(_cs);
+        _is_running = false;
+    }
+    _signal.notify_all();
+    for(auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void ConditionVariableWorkers::Run(std::function<void()> job) {
+    _jobs.push(std::move(job));
+    ++_pending;
+    if(_sleeping_workers) {
+        //Acquiring the lock orders this wakeup after any worker that is between its predicate check and its wait.
+        { std::scoped_lock<std::mutex> lock(_cs); }
+        _signal.notify_one();
+    }
+}
+
+void ConditionVariableWorkers::Worker() {
+    std::function<void()> job{};
+    while(_is_running) {
+        if(_jobs.try_pop(job)) {
+            --_pending;
+            job();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_cs);
+        ++_sleeping_workers;
+        _signal.wait(lock, [this]()->bool { return !_is_running || _pending != 0; });
+        --_sleeping_workers;
+    }
+}
+
+//Submits burstCount bursts of 32 tiny jobs separated by idle gaps long enough for every worker
+//to park, and returns the nanoseconds the first job of each burst waited for a worker to wake up.
+//The rest of the burst is submitted only once that job has started, so the measurement is the
+//wakeup alone and not the submit loop (which it would be with fewer cores than threads).
+//run(fn) dispatches fn as one generic job.
+template<typename Run>
+double MeasureWakeupNanoseconds(Run&& run, std::uint64_t burstCount) {
+    constexpr std::size_t jobs_per_burst = 32u;
+    constexpr std::chrono::milliseconds idle_gap{ 2 };
+    std::atomic<std::uint64_t> completed{ 0u };
+    double total_ns = 0.0;
+    for(std::uint64_t burst = 0; burst < burstCount; ++burst) {
+        std::this_thread::sleep_for(idle_gap);
+        const auto submitted = std::chrono::steady_clock::now();
+        double wait_ns = 0.0;
+        std::atomic_bool started{ false };
+        run([&wait_ns, &completed, &started, submitted]() {
+            wait_ns = GetElapsedNanoseconds(submitted);
+            started = true;
+            ++completed;
+        });
+        while(!started) {
+            std::this_thread::yield();
+        }
+        for(std::size_t i = 1; i < jobs_per_burst; ++i) {
+            run([&completed]() { ++completed; });
+        }
+        while(completed < (burst + 1u) * jobs_per_burst) {
+            std::this_thread::yield();
+        }
+        total_ns += wait_ns;
+    }
+    return total_ns;
+}
+
+//Per-worker parking against the shared condition_variable it replaced. One iteration is one burst.
+void AddWorkerWakeupBenchmarks(MicroBenchmark::Runner& runner) {
+    for(auto count : GetThreadCounts(GetMaxGenericWorkerCount())) {
+        const auto suffix = "/Workers:" + std::to_string(count);
+        runner.AddManual("JobSystem/Wakeup/Parker" + suffix, [count](std::uint64_t iterations) {
+            std::condition_variable main_signal{};
+            JobSystem js(count, static_cast<std::size_t>(JobType::Max), &main_signal);
+            return MeasureWakeupNanoseconds([&js](auto&& fn) {
+                js.Run(JobType::Generic, [fn](void*) { fn(); }, nullptr);
+            }, iterations);
+        });
+        runner.AddManual("JobSystem/Wakeup/Condvar" + suffix, [count](std::uint64_t iterations) {
+            ConditionVariableWorkers workers(count);
+            return MeasureWakeupNanoseconds([&workers](auto&& fn) {
+                workers.Run(fn);
+            }, iterations);
+        });
+    }
+}
+
+//Instrumentation path of jobCount Dispatch + Execute pairs, recording one job in every sampleInterval.
+//Returns the nanoseconds spent recording; the rings are drained between chunks, untimed.
+double MeasureJobRecordingNanoseconds(std::uint32_t sampleInterval, std::uint64_t jobCount) {
+    constexpr std::uint64_t jobs_per_chunk = 4000u;
+    const auto previous_interval = JobInstrumentation::GetSampleInterval();
+    JobInstrumentation::Enable(true);
+    JobInstrumentation::SetSampleInterval(sampleInterval);
+    double total_ns = 0.0;
+    for(std::uint64_t done = 0u; done < jobCount; done += jobs_per_chunk) {
+        const auto chunk = (std::min)(jobs_per_chunk, jobCount - done);
+        const auto start = std::chrono::steady_clock::now();
+        for(std::uint64_t i = 0; i < chunk; ++i) {
+            if(JobInstrumentation::ShouldRecord()) {
+                const auto submit_ticks = JobInstrumentation::Now();
+                const auto start_ticks = JobInstrumentation::Now();
+                JobInstrumentation::RecordJob(JobType::Generic, static_cast<std::size_t>(i), 0u, submit_ticks, start_ticks, JobInstrumentation::Now());
+            }
+        }
+        total_ns += GetElapsedNanoseconds(start);
+        JobInstrumentation::Collect();
+    }
+    JobInstrumentation::SetSampleInterval(previous_interval);
+    JobInstrumentation::Enable(false);
+    JobInstrumentation::Reset();
+    return total_ns;
+}
+
+//Per-job recording cost. The JobSystem itself only records in profile builds, not in this one.
+void AddJobInstrumentationBenchmarks(MicroBenchmark::Runner& runner) {
+    runner.AddManual("JobInstrumentation/RecordEveryJob", [](std::uint64_t iterations) {
+        return MeasureJobRecordingNanoseconds(1u, iterations);
+    });
+    runner.AddManual("JobInstrumentation/RecordSampled", [](std::uint64_t iterations) {
+        return MeasureJobRecordingNanoseconds(JobInstrumentation::GetSampleInterval(), iterations);
+    });
+}
+
+//Runs jobCount jobs that each sweep a buffer owned by the thread running it. A worker that
+//migrates between cores finds its buffer cold in the new core's L1/L2.
+void RunCacheSweeps(bool pinThreads, std::size_t bufferSize, std::uint64_t jobCount) {
+    std::condition_variable main_signal{};
+    std::atomic<std::uint64_t> completed{ 0u };
+    std::atomic<std::uint64_t> checksum{ 0u };
+    JobSystemDesc desc{};
+    desc.main_job_signal = &main_signal;
+    //No logger here; keep only the main thread's core free.
+    desc.reserved_core_count = 1u;
+    desc.pin_threads = pinThreads;
+    JobSystem js(desc);
+    auto sweep = [&completed, &checksum, bufferSize](void*) {
+        constexpr std::size_t pass_count = 4u;
+        thread_local std::vector<std::uint64_t> buffer{};
+        buffer.resize(bufferSize / sizeof(std::uint64_t), 1u);
+        std::uint64_t sum = 0u;
+        for(std::size_t pass = 0; pass < pass_count; ++pass) {
+            for(auto& value : buffer) {
+                value = value * 6364136223846793005u + 1442695040888963407u;
+                sum += value;
+            }
+        }
+        checksum.fetch_add(sum, std::memory_order_relaxed);
+        ++completed;
+    };
+    for(std::uint64_t i = 0; i < jobCount; ++i) {
+        js.Run(JobType::Generic, sweep, nullptr);
+    }
+    while(completed < jobCount) {
+        std::this_thread::yield();
+    }
+    DoNotOptimize(checksum.load());
+}
+
+//Pinned against unpinned workers on cache-heavy jobs; one iteration is one job.
+void AddWorkerPinningBenchmarks(MicroBenchmark::Runner& runner) {
+    //Half of L2 leaves room for the job system's own working set.
+    constexpr std::size_t default_l2_size = 256u * 1024u;
+    const auto cpu = System::Cpu::GetCpuDesc();
+    const auto buffer_size = (cpu.l2CacheSize ? cpu.l2CacheSize : default_l2_size) / 2u;
+    runner.Add("JobSystem/CacheSweep/Unpinned", [buffer_size](std::uint64_t iterations) {
+        RunCacheSweeps(false, buffer_size, iterations);
+    });
+    runner.Add("JobSystem/CacheSweep/Pinned", [buffer_size](std::uint64_t iterations) {
+        RunCacheSweeps(true, buffer_size, iterations);
+    });
+}
+
+//Every thread holds a working set of blocks and replaces replacementCount of them, one free and
+//one allocation each, in a shuffled order so frees never come back in allocation order.
+//Returns the nanoseconds from the threads starting together to the last one finishing.
+template<typename Allocate, typename Deallocate>
+double MeasureBlockReplacementNanoseconds(int threadCount, std::uint64_t replacementCount, Allocate&& allocate, Deallocate&& deallocate) {
+    constexpr std::size_t working_set = 4096u;
+    std::atomic<int> ready{ 0 };
+    std::atomic<int> finished{ 0 };
+    std::atomic_bool go{ false };
+    std::vector<std::thread> threads{};
+    for(int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&allocate, &deallocate, &ready, &finished, &go, replacementCount, t]() {
+            std::minstd_rand rng(static_cast<unsigned int>(t + 1));
+            std::vector<std::size_t> order(working_set);
+            std::iota(std::begin(order), std::end(order), std::size_t{ 0u });
+            std::shuffle(std::begin(order), std::end(order), rng);
+            std::vector<void*> blocks(working_set, nullptr);
+            for(auto& block : blocks) {
+                block = allocate();
+            }
+            ++ready;
+            while(!go) {
+                std::this_thread::yield();
+            }
+            for(std::uint64_t i = 0; i < replacementCount; ++i) {
+                auto& block = blocks[order[i % working_set]];
+                deallocate(block);
+                block = allocate();
+            }
+            ++finished;
+            for(auto& block : blocks) {
+                deallocate(block);
+            }
+        });
+    }
+    while(ready < threadCount) {
+        std::this_thread::yield();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    while(finished < threadCount) {
+        std::this_thread::yield();
+    }
+    const auto elapsed_ns = GetElapsedNanoseconds(start);
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    return elapsed_ns;
+}
+
+//FixedBlockPool with and without its thread cache against malloc, 64-byte blocks.
+//One iteration is one replacement on every thread, so the numbers stay comparable as threads are added.
+void AddBlockPoolBenchmarks(MicroBenchmark::Runner& runner) {
+    constexpr std::size_t block_size = 64u;
+    const auto max_threads = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for(auto count : GetThreadCounts(max_threads)) {
+        const auto suffix = "/Threads:" + std::to_string(count);
+        runner.AddManual("FixedBlockPool/malloc" + suffix, [count](std::uint64_t iterations) {
+            return MeasureBlockReplacementNanoseconds(count, iterations, []() { return std::malloc(block_size); }, [](void* block) { std::free(block); });
+        });
+        runner.AddManual("FixedBlockPool/Locked" + suffix, [count](std::uint64_t iterations) {
+            FixedBlockPool pool{ block_size };
+            return MeasureBlockReplacementNanoseconds(count, iterations, [&pool]() { return pool.Allocate(); }, [&pool](void* block) { pool.Deallocate(block); });
+        });
+        runner.AddManual("FixedBlockPool/ThreadCache" + suffix, [count](std::uint64_t iterations) {
+            FixedBlockPool pool{ block_size, alignof(std::max_align_t), FixedBlockPool::DEFAULT_BLOCKS_PER_PAGE, true };
+            return MeasureBlockReplacementNanoseconds(count, iterations, [&pool]() { return pool.Allocate(); }, [&pool](void* block) { pool.Deallocate(block); });
+        });
+    }
+}
+
+//One step of a replayed allocation trace: allocate size bytes into slot, or free slot.
+struct TraceOp {
+    std::size_t slot = 0u;
+    std::size_t size = 0u;
+    bool allocate = true;
+};
+
+//Frames of game-like traffic: many small per-frame temporaries, medium buffers that live a few
+//frames, and rare large resources that live for hundreds. Seeded, so every backend sees the same
+//trace. Everything is freed by the end of the trace.
+std::vector<TraceOp> GenerateGameAllocationTrace(std::size_t frame_count, std::size_t& slot_count) {
+    struct Live {
+        std::size_t slot = 0u;
+        std::size_t expires = 0u;
+    };
+    std::mt19937 rng(1729u);
+    std::uniform_int_distribution<std::size_t> small_size(16u, 256u);
+    std::uniform_int_distribution<std::size_t> medium_size(1024u, 64u * 1024u);
+    std::uniform_int_distribution<std::size_t> large_size(256u * 1024u, 4u * 1024u * 1024u);
+    std::uniform_int_distribution<std::size_t> small_count(200u, 600u);
+    std::uniform_int_distribution<std::size_t> medium_count(0u, 20u);
+    std::uniform_int_distribution<std::size_t> medium_life(1u, 8u);
+    std::uniform_int_distribution<std::size_t> large_life(60u, 600u);
+    std::bernoulli_distribution large_chance(0.05);
+    std::vector<TraceOp> trace{};
+    std::vector<std::size_t> free_slots{};
+    std::vector<Live> live{};
+    slot_count = 0u;
+    auto take_slot = [&]() {
+        if(free_slots.empty()) {
+            return slot_count++;
+        }
+        const auto slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    };
+    auto allocate = [&](std::size_t size, std::size_t expires) {
+        const auto slot = take_slot();
+        trace.push_back(TraceOp{ slot, size, true });
+        live.push_back(Live{ slot, expires });
+    };
+    for(std::size_t frame = 0; frame < frame_count; ++frame) {
+        for(std::size_t i = 0, count = small_count(rng); i < count; ++i) {
+            allocate(small_size(rng), frame);
+        }
+        for(std::size_t i = 0, count = medium_count(rng); i < count; ++i) {
+            allocate(medium_size(rng), frame + medium_life(rng));
+        }
+        if(large_chance(rng)) {
+            allocate(large_size(rng), frame + large_life(rng));
+        }
+        //Frees in shuffled order, as a frame's temporaries are rarely released in allocation order.
+        auto expired = std::partition(std::begin(live), std::end(live), [frame](const Live& l) { return l.expires > frame; });
+        std::shuffle(expired, std::end(live), rng);
+        for(auto iter = expired; iter != std::end(live); ++iter) {
+            trace.push_back(TraceOp{ iter->slot, 0u, false });
+            free_slots.push_back(iter->slot);
+        }
+        live.erase(expired, std::end(live));
+    }
+    for(const auto& l : live) {
+        trace.push_back(TraceOp{ l.slot, 0u, false });
+    }
+    return trace;
+}
+
+struct MallocBackend {
+    void* Allocate(std::size_t size) { return std::malloc(size); }
+    void Deallocate(void* ptr) { std::free(ptr); }
+};
+
+//Replays a trace against its own Backend, continuing where the previous call stopped and
+//wrapping around at the end of the trace.
+template<typename Backend>
+class TraceReplay {
+public:
+    template<typename... BackendArgs>
+    TraceReplay(std::shared_ptr<const std::vector<TraceOp>> trace, std::size_t slotCount, BackendArgs&&... backendArgs);
+    ~TraceReplay();
+    //With allocationNs, appends how long each allocation took.
+    void Replay(std::uint64_t opCount, std::vector<double>* allocationNs = nullptr);
+private:
+    std::shared_ptr<const std::vector<TraceOp>> _trace{};
+    std::vector<void*> _slots{};
+    std::size_t _next = 0u;
+    Backend _backend;
+};
+
+template<typename Backend>
+template<typename... BackendArgs>
+TraceReplay<Backend>::TraceReplay(std::shared_ptr<const std::vector<TraceOp>> trace, std::size_t slotCount, BackendArgs&&... backendArgs)
+    : _trace(std::move(trace))
+    , _slots(slotCount, nullptr)
+    , _backend(std::forward<BackendArgs>(backendArgs)...)
+{
+    /* DO NOTHING */
+}
+
+template<typename Backend>
+TraceReplay<Backend>::~TraceReplay() {
+    for(auto ptr : _slots) {
+        if(ptr) {
+            _backend.Deallocate(ptr);
+        }
+    }
+}
+
+template<typename Backend>
+void TraceReplay<Backend>::Replay(std::uint64_t opCount, std::vector<double>* allocationNs /*= nullptr*/) {
+    const auto& trace = *_trace;
+    for(std::uint64_t i = 0; i < opCount; ++i) {
+        const auto& op = trace[_next];
+        _next = (_next + 1u) % trace.size();
+        if(!op.allocate) {
+            _backend.Deallocate(_slots[op.slot]);
+            _slots[op.slot] = nullptr;
+            continue;
+        }
+        if(allocationNs) {
+            const auto start = std::chrono::steady_clock::now();
+            _slots[op.slot] = _backend.Allocate(op.size);
+            allocationNs->push_back(GetElapsedNanoseconds(start));
+        } else {
+            _slots[op.slot] = _backend.Allocate(op.size);
+        }
+        //Touch the block, as a real caller would.
+        if(auto* bytes = static_cast<unsigned char*>(_slots[op.slot])) {
+            bytes[0] = 0u;
+        }
+    }
+}
+
+//TlsfAllocator against malloc on a randomized game trace: the mean cost of one trace op, and the
+//99th percentile of a single allocation, which is what a frame budget has to absorb.
+void AddTlsfBenchmarks(MicroBenchmark::Runner& runner) {
+    constexpr std::size_t frame_count = 2000u;
+    std::size_t slot_count = 0u;
+    const auto trace = std::make_shared<const std::vector<TraceOp>>(GenerateGameAllocationTrace(frame_count, slot_count));
+    auto add_backend = [&runner](const std::string& name, auto replay) {
+        runner.Add("TlsfAllocator/TraceOp/" + name, [replay](std::uint64_t iterations) {
+            replay->Replay(iterations);
+        });
+        runner.AddManual("TlsfAllocator/TraceAllocationP99/" + name, [replay](std::uint64_t iterations) {
+            std::vector<double> allocation_ns{};
+            allocation_ns.reserve(static_cast<std::size_t>(iterations));
+            replay->Replay(iterations, &allocation_ns);
+            return allocation_ns.empty() ? 0.0 : GetPercentile(std::move(allocation_ns), 0.99) * static_cast<double>(iterations);
+        });
+    };
+    add_backend("malloc", std::make_shared<TraceReplay<MallocBackend>>(trace, slot_count));
+    //Sized so the steady-state working set fits without growing mid-trace.
+    add_backend("Tlsf", std::make_shared<TraceReplay<TlsfAllocator>>(trace, slot_count, 64u * 1024u * 1024u));
+
+    //Every thread sharing one allocator, as with the TLSF operator new backend: its single lock against malloc.
+    //One iteration is one replacement on every thread, as in the FixedBlockPool cases.
+    constexpr std::size_t block_size = 64u;
+    const auto max_threads = (std::max)(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for(auto count : GetThreadCounts(max_threads)) {
+        const auto suffix = "/Threads:" + std::to_string(count);
+        runner.AddManual("TlsfAllocator/Replace/malloc" + suffix, [count](std::uint64_t iterations) {
+            return MeasureBlockReplacementNanoseconds(count, iterations, []() { return std::malloc(block_size); }, [](void* block) { std::free(block); });
+        });
+        runner.AddManual("TlsfAllocator/Replace/Tlsf" + suffix, [count](std::uint64_t iterations) {
+            TlsfAllocator allocator{};
+            return MeasureBlockReplacementNanoseconds(count, iterations, [&allocator]() { return allocator.Allocate(block_size); }, [&allocator](void* block) { allocator.Deallocate(block); });
+        });
+    }
+}
@@ -0,0 +1,253 @@
+#include "MicroBenchmark.hpp"
+
+#include "Thirdparty/nlohmann/json/json.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace MicroBenchmark {
+
+namespace {
+
+using steady_clock_t = std::chrono::steady_clock;
+
+//Two-sided 95% Student's t critical values for 1 to 30 degrees of freedom.
+constexpr std::array<double, 30> T_CRITICAL_95{
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+double GetTCritical95(std::size_t degreesOfFreedom) {
+    if(!degreesOfFreedom) {
+        return 0.0;
+    }
+    return degreesOfFreedom <= T_CRITICAL_95.size() ? T_CRITICAL_95[degreesOfFreedom - 1u] : 1.96;
+}
+
+//Linear interpolation between closest ranks; sorted must not be empty.
+double GetPercentile(const std::vector<double>& sorted, double percentile) {
+    const auto rank = percentile * static_cast<double>(sorted.size() - 1u);
+    const auto lower = static_cast<std::size_t>(rank);
+    const auto upper = (std::min)(lower + 1u, sorted.size() - 1u);
+    const auto fraction = rank - static_cast<double>(lower);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+struct Timing {
+    steady_clock_t::duration wall{};
+    //What the benchmark reports: its own measurement, or the wall-clock time.
+    double reported_ns = 0.0;
+};
+
+Timing TimeIterations(const manual_benchmark_fn_t& fn, bool manualTime, std::uint64_t iterations) {
+    Timing timing{};
+    const auto start = steady_clock_t::now();
+    const auto manual_ns = fn(iterations);
+    timing.wall = steady_clock_t::now() - start;
+    timing.reported_ns = manualTime ? manual_ns : std::chrono::duration<double, std::nano>{ timing.wall }.count();
+    return timing;
+}
+
+std::string GetCompilerName() {
+#if defined(__clang__)
+    return "Clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "GCC " __VERSION__;
+#elif defined(_MSC_VER)
+    return "MSVC " + std::to_string(_MSC_FULL_VER);
+#else
+    return "Unknown";
+#endif
+}
+
+std::string GetUtcTimestamp() {
+    const auto now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _MSC_VER
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    std::ostringstream ss;
+    ss << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ");
+    return ss.str();
+}
+
+} //End anonymous namespace
+
+Runner::Runner(Options options)
+    : _options(std::move(options))
+{
+    /* DO NOTHING */
+}
+
+void Runner::Add(std::string name, benchmark_fn_t fn) {
+    auto wall_timed_fn = [fn = std::move(fn)](std::uint64_t iterations) {
+        fn(iterations);
+        return 0.0;
+    };
+    _benchmarks.push_back(Benchmark{ std::move(name), std::move(wall_timed_fn), false });
+}
+
+void Runner::AddManual(std::string name, manual_benchmark_fn_t fn) {
+    _benchmarks.push_back(Benchmark{ std::move(name), std::move(fn), true });
+}
+
+std::vector<std::string> Runner::List() const {
+    std::vector<std::string> names{};
+    for(const auto& benchmark : _benchmarks) {
+        if(benchmark.name.find(_options.filter) != std::string::npos) {
+            names.push_back(benchmark.name);
+        }
+    }
+    return names;
+}
+
+std::vector<Result> Runner::Run(std::ostream& out) const {
+    constexpr int name_width = 44;
+    constexpr int column_width = 12;
+    out << std::left << std::setw(name_width) << "Benchmark"
+        << std::right << std::setw(column_width) << "Median ns"
+        << std::right << std::setw(column_width) << "Mean ns"
+        << std::right << std::setw(column_width) << "+/- 95%"
+        << std::right << std::setw(column_width) << "StdDev %"
+        << std::right << std::setw(column_width) << "Rejected"
+        << std::right << std::setw(column_width + 4) << "Iterations"
+        << '\n';
+    std::vector<Result> results{};
+    for(const auto& benchmark : _benchmarks) {
+        if(benchmark.name.find(_options.filter) == std::string::npos) {
+            continue;
+        }
+        const auto result = RunOne(benchmark);
+        const auto stddev_percent = result.mean_ns > 0.0 ? 100.0 * result.stddev_ns / result.mean_ns : 0.0;
+        out << std::left << std::setw(name_width) << result.name
+            << std::fixed << std::setprecision(2)
+            << std::right << std::setw(column_width) << result.median_ns
+            << std::right << std::setw(column_width) << result.mean_ns
+            << std::right << std::setw(column_width) << result.ci95_ns
+            << std::right << std::setw(column_width) << stddev_percent
+            << std::right << std::setw(column_width) << (std::to_string(result.rejected) + '/' + std::to_string(result.samples_ns.size()))
+            << std::right << std::setw(column_width + 4) << result.iterations_per_repetition
+            << '\n' << std::flush;
+        results.push_back(result);
+    }
+    return results;
+}
+
+Result Runner::RunOne(const Benchmark& benchmark) const {
+    Result result{};
+    result.name = benchmark.name;
+    result.manual_time = benchmark.manual_time;
+    const auto warmup_end = steady_clock_t::now() + _options.warmup_time;
+    const auto target = std::chrono::duration_cast<steady_clock_t::duration>(_options.min_repetition_time);
+
+    //Grow the iteration count until one repetition is long enough to time reliably.
+    std::uint64_t iterations = 1u;
+    for(;;) {
+        const auto elapsed = TimeIterations(benchmark.fn, benchmark.manual_time, iterations).wall;
+        if(target <= elapsed) {
+            break;
+        }
+        const auto scale = elapsed.count() > 0 ? 1.2 * static_cast<double>(target.count()) / static_cast<double>(elapsed.count()) : 10.0;
+        iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * std::clamp(scale, 1.5, 10.0)) + 1u;
+    }
+    while(steady_clock_t::now() < warmup_end) {
+        TimeIterations(benchmark.fn, benchmark.manual_time, iterations);
+    }
+
+    result.iterations_per_repetition = iterations;
+    result.samples_ns.reserve(_options.repetitions);
+    for(std::size_t i = 0u; i < _options.repetitions; ++i) {
+        const auto timing = TimeIterations(benchmark.fn, benchmark.manual_time, iterations);
+        result.samples_ns.push_back(timing.reported_ns / static_cast<double>(iterations));
+    }
+    Summarize(result);
+    return result;
+}
+
+void Runner::Summarize(Result& result) {
+    if(result.samples_ns.empty()) {
+        return;
+    }
+    auto sorted = result.samples_ns;
+    std::sort(std::begin(sorted), std::end(sorted));
+    const auto q1 = GetPercentile(sorted, 0.25);
+    const auto q3 = GetPercentile(sorted, 0.75);
+    const auto iqr = q3 - q1;
+    const auto low_fence = q1 - 1.5 * iqr;
+    const auto high_fence = q3 + 1.5 * iqr;
+    std::vector<double> kept{};
+    std::copy_if(std::begin(sorted), std::end(sorted), std::back_inserter(kept), [low_fence, high_fence](double sample) {
+        return low_fence <= sample && sample <= high_fence;
+    });
+    result.rejected = sorted.size() - kept.size();
+
+    const auto count = static_cast<double>(kept.size());
+    result.mean_ns = std::accumulate(std::begin(kept), std::end(kept), 0.0) / count;
+    result.median_ns = GetPercentile(kept, 0.5);
+    result.min_ns = kept.front();
+    result.max_ns = kept.back();
+    if(kept.size() > 1u) {
+        const auto mean = result.mean_ns;
+        const auto sum_of_squares = std::accumulate(std::begin(kept), std::end(kept), 0.0, [mean](double sum, double sample) {
+            return sum + (sample - mean) * (sample - mean);
+        });
+        result.stddev_ns = std::sqrt(sum_of_squares / (count - 1.0));
+        result.ci95_ns = GetTCritical95(kept.size() - 1u) * result.stddev_ns / std::sqrt(count);
+    } else {
+        result.stddev_ns = 0.0;
+        result.ci95_ns = 0.0;
+    }
+}
+
+bool Runner::WriteJson(const std::filesystem::path& filepath, const std::vector<Result>& results) {
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for(const auto& result : results) {
+        benchmarks.push_back(nlohmann::json{
+            {"name", result.name},
+            {"manual_time", result.manual_time},
+            {"iterations_per_repetition", result.iterations_per_repetition},
+            {"repetitions", result.samples_ns.size()},
+            {"rejected", result.rejected},
+            {"mean_ns", result.mean_ns},
+            {"median_ns", result.median_ns},
+            {"stddev_ns", result.stddev_ns},
+            {"ci95_ns", result.ci95_ns},
+            {"min_ns", result.min_ns},
+            {"max_ns", result.max_ns},
+            {"samples_ns", result.samples_ns},
+        });
+    }
+    const nlohmann::json document{
+        {"context", {
+            {"date", GetUtcTimestamp()},
+            {"compiler", GetCompilerName()},
+#ifdef NDEBUG
+            {"build", "release"},
+#else
+            {"build", "debug"},
+#endif
+            {"hardware_concurrency", std::thread::hardware_concurrency()},
+        }},
+        {"benchmarks", benchmarks},
+    };
+    if(filepath.has_parent_path()) {
+        std::error_code ec{};
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+    std::ofstream file(filepath, std::ios_base::out | std::ios_base::trunc);
+    file << document.dump(4) << '\n';
+    return static_cast<bool>(file);
+}
+
+} //End MicroBenchmark
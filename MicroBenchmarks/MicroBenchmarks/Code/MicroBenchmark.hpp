@@ -0,0 +1,95 @@
+#pragma once
+//Repetition-based microbenchmark runner.
+//Each benchmark is a function that runs its operation a requested number of times. The runner warms it up,
+//picks an iteration count that makes one repetition last at least min_repetition_time, then times
+//a number of repetitions. Benchmarks added with AddManual time themselves instead, for latencies that
+//the wall-clock time of a repetition cannot isolate; the runner still uses wall-clock time to size them. Repetitions outside Tukey's fences (1.5 interquartile ranges beyond the
+//quartiles) are rejected as outliers before the mean, deviation and 95% confidence interval are taken.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace MicroBenchmark {
+
+//Keeps the compiler from discarding a result the benchmark otherwise never uses.
+template<typename T>
+void DoNotOptimize(const T& value) {
+#ifdef _MSC_VER
+    static const void* volatile sink = nullptr;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+struct Options {
+    std::chrono::milliseconds warmup_time{ 100 };
+    std::chrono::milliseconds min_repetition_time{ 20 };
+    std::size_t repetitions = 20u;
+    //Only benchmarks whose names contain this run.
+    std::string filter{};
+    //Written when not empty.
+    std::filesystem::path json_path{};
+};
+
+struct Result {
+    std::string name{};
+    //Samples are the benchmark's own measurements rather than wall-clock time.
+    bool manual_time = false;
+    std::uint64_t iterations_per_repetition = 0u;
+    //Nanoseconds per iteration, one per repetition, in run order.
+    std::vector<double> samples_ns{};
+    std::size_t rejected = 0u;
+    //Over the samples that survived outlier rejection.
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double stddev_ns = 0.0;
+    double ci95_ns = 0.0;
+    double min_ns = 0.0;
+    double max_ns = 0.0;
+};
+
+using benchmark_fn_t = std::function<void(std::uint64_t iterations)>;
+//Returns the nanoseconds to report for the iterations it ran.
+using manual_benchmark_fn_t = std::function<double(std::uint64_t iterations)>;
+
+class Runner {
+public:
+    explicit Runner(Options options);
+
+    void Add(std::string name, benchmark_fn_t fn);
+    void AddManual(std::string name, manual_benchmark_fn_t fn);
+    //Runs the benchmarks that match the filter in the order they were added, printing each result as it finishes.
+    std::vector<Result> Run(std::ostream& out) const;
+    //Names of the benchmarks that match the filter.
+    std::vector<std::string> List() const;
+
+    static bool WriteJson(const std::filesystem::path& filepath, const std::vector<Result>& results);
+    //Fills in the statistics from samples_ns.
+    static void Summarize(Result& result);
+
+protected:
+private:
+    struct Benchmark {
+        std::string name{};
+        manual_benchmark_fn_t fn{};
+        bool manual_time = false;
+    };
+
+    Result RunOne(const Benchmark& benchmark) const;
+
+    Options _options{};
+    std::vector<Benchmark> _benchmarks{};
+};
+
+} //End MicroBenchmark
@@ -6,7 +6,15 @@
 
 #include "Engine/Math/MathUtils.hpp"
 
+#include "Engine/Profiling/AllocationProfiler.hpp"
+#include "Engine/Profiling/FrameStats.hpp"
+#include "Engine/Profiling/JobInstrumentation.hpp"
+#include "Engine/Profiling/Memory.hpp"
+#include "Engine/Profiling/MemoryBudgets.hpp"
 #include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
+#include "Engine/Profiling/SamplingProfiler.hpp"
+#include "Engine/Profiling/TraceExporter.hpp"
 
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/Window.hpp"
@@ -65,6 +73,10 @@ App::App(std::unique_ptr<JobSystem> jobSystem, std::unique_ptr<FileLogger> fileL
 App::~App() {
     g_theSubsystemHead = g_theApp;
 
+    //Closes the trace file while the job system and logger it records are still alive.
+    TraceExporter::Stop();
+    SamplingProfiler::Stop();
+
     _theGame.reset();
     _theConsole.reset();
     _theInputSystem.reset();
@@ -120,10 +132,20 @@ void App::Initialize() {
     quit.help_text_long = "Quits the application.";
     quit.command_function = [this](const std::string& /*args*/) { this->SetIsQuitting(true); };
     g_theConsole->RegisterCommand(quit);
+    JobInstrumentation::RegisterConsoleCommands(*g_theConsole);
+    AllocationProfiler::RegisterConsoleCommands(*g_theConsole);
+    MemoryBudgets::LoadFromConfig(*g_theConfig);
+    MemoryBudgets::RegisterConsoleCommands(*g_theConsole);
+    Memory::register_console_commands(*g_theConsole);
+    Profiler::RegisterConsoleCommands(*g_theConsole);
+    TraceExporter::RegisterConsoleCommands(*g_theConsole);
+    FrameStats::RegisterConsoleCommands(*g_theConsole);
+    SamplingProfiler::RegisterConsoleCommands(*g_theConsole);
 
 }
 
 void App::RunFrame() {
+    PROFILE_LOG_SCOPE_FUNCTION();
     using namespace TimeUtils;
     BeginFrame();
     static FPSeconds previousFrameTime = TimeUtils::GetCurrentTimeElapsed();
@@ -135,8 +157,12 @@ void App::RunFrame() {
     deltaSeconds = FPSeconds{std::clamp(FPFrames{ deltaSeconds }, FPFrames{ 0 }, FPFrames{ 1 })};
     #endif
 
+    const auto update_start = TimeUtils::Now();
     Update(deltaSeconds);
+    const auto render_start = TimeUtils::Now();
+    FrameStats::Record(FrameStats::Metric::Update, render_start - update_start);
     Render();
+    FrameStats::Record(FrameStats::Metric::Render, TimeUtils::Now() - render_start);
     EndFrame();
 }
 
@@ -200,6 +226,7 @@ bool App::ProcessSystemMessage(const EngineMessage& msg) {
 }
 
 void App::BeginFrame() {
+    PROFILE_LOG_SCOPE_FUNCTION();
     g_theJobSystem->BeginFrame();
     g_theInput->BeginFrame();
     g_theConsole->BeginFrame();
@@ -209,6 +236,7 @@ void App::BeginFrame() {
 }
 
 void App::Update([[maybe_unused]]TimeUtils::FPSeconds deltaSeconds) {
+    PROFILE_LOG_SCOPE_FUNCTION();
     g_theInput->Update(deltaSeconds);
     g_theConsole->Update(deltaSeconds);
     g_theUI->Update(deltaSeconds);
@@ -217,6 +245,7 @@ void App::Update([[maybe_unused]]TimeUtils::FPSeconds deltaSeconds) {
 }
 
 void App::Render() const {
+    PROFILE_LOG_SCOPE_FUNCTION();
     g_theGame->Render();
     g_theUI->Render();
     g_theConsole->Render();
@@ -225,6 +254,7 @@ void App::Render() const {
 }
 
 void App::EndFrame() {
+    PROFILE_LOG_SCOPE_FUNCTION();
     g_theGame->EndFrame();
     g_theUI->EndFrame();
     g_theConsole->EndFrame();
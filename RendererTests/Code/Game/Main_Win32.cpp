@@ -11,6 +11,7 @@
 
 #include "Engine/Profiling/Memory.hpp"
 #include "Engine/Profiling/ProfileLogScope.hpp"
+#include "Engine/Profiling/Profiler.hpp"
 #include "Engine/Profiling/StackTrace.hpp"
 
 #include "Game/GameCommon.hpp"
@@ -26,6 +27,7 @@ void Shutdown();
 
 int CALLBACK WinMain(HINSTANCE hInstance, HINSTANCE /*hPrevInstance*/, LPSTR lpCmdLine, int nShowCmd) {
     Memory::enable(true);
+    Profiler::SetThreadName("Main");
     Initialize(hInstance, lpCmdLine, nShowCmd);
     MainLoop();
     Shutdown();
@@ -38,7 +40,14 @@ void Initialize(HINSTANCE /*hInstance*/, LPSTR /*lpCmdLine*/, int /*nShowCmd*/)
 }
 
 App* CreateApp() {
-    std::unique_ptr<JobSystem> jobSystem = std::make_unique<JobSystem>(-1, static_cast<std::size_t>(JobType::Max), new std::condition_variable);
+    JobSystemDesc jobSystemDesc{};
+    //One worker per logical processor less two for the main and Io/logging threads, as before
+    //topology-aware sizing. Nothing is reserved or pinned: the apps share every core with the OS.
+    jobSystemDesc.generic_count = -2;
+    jobSystemDesc.reserved_core_count = 0u;
+    jobSystemDesc.use_smt = true;
+    jobSystemDesc.main_job_signal = new std::condition_variable;
+    std::unique_ptr<JobSystem> jobSystem = std::make_unique<JobSystem>(jobSystemDesc);
     std::unique_ptr<FileLogger> fileLogger = std::make_unique<FileLogger>(*jobSystem, "game");
     return new App(std::move(jobSystem), std::move(fileLogger));
 }
@@ -52,6 +61,7 @@ void MainLoop() {
         RunMessagePump();
         g_theApp->RunFrame();
         Memory::tick();
+        Profiler::EndFrame();
     }
 }
 